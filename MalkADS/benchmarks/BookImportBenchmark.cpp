@@ -0,0 +1,118 @@
+//
+// Writes a synthetic catalog file (200k books by default) and loads it into
+// a fresh BooksManager three ways: line by line through addBookDirect (how
+// books.txt used to be read), and with importBooksFromFile on one thread
+// and on every core.
+//
+// BooksManager saves its tables to data/ when it is destroyed, so run this
+// from a directory without one (e.g. the build directory); it refuses to
+// run next to a real data/ folder.
+//
+#include "managers/BooksManager.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <thread>
+
+using namespace std;
+
+namespace {
+
+const char *CATALOG_PATH = "book_import_benchmark.txt";
+const char *WORDS[] = {"the",     "of",     "history", "garden", "silent",
+                       "river",   "night",  "empire",  "code",   "winter",
+                       "shadow",  "letters", "modern", "quiet",  "machine",
+                       "kingdom", "secret", "ocean",   "stone",  "light"};
+const int WORD_COUNT = sizeof(WORDS) / sizeof(WORDS[0]);
+
+template <typename Func> double timeMs(Func func) {
+  auto t0 = chrono::steady_clock::now();
+  func();
+  auto t1 = chrono::steady_clock::now();
+  return chrono::duration<double, milli>(t1 - t0).count();
+}
+
+bool dataDirectoryExists() {
+  const char *probe = "data/book_import_benchmark.probe";
+  ofstream out(probe);
+  if (!out)
+    return false;
+  out.close();
+  remove(probe);
+  return true;
+}
+
+void writeCatalog(int n) {
+  ofstream out(CATALOG_PATH, ios::out | ios::trunc);
+  for (int i = 0; i < n; i++) {
+    out << "B" << i << ",";
+    int words = 2 + rand() % 4;
+    for (int w = 0; w < words; w++)
+      out << WORDS[rand() % WORD_COUNT] << " ";
+    // The number keeps titles unique
+    out << i << ",Author " << rand() % (n / 8 + 1);
+    if (rand() % 10 == 0)
+      out << "," << 2 + rand() % 4;
+    out << "\n";
+  }
+}
+
+void report(const char *label, int rows, double ms) {
+  printf("  %-28s %8.0f ms  %10.0f rows/s\n", label, ms, rows / ms * 1000.0);
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  if (dataDirectoryExists()) {
+    printf("Run from a directory without data/: BooksManager would "
+           "overwrite it\n");
+    return 1;
+  }
+  int n = argc > 1 ? atoi(argv[1]) : 200000;
+  int cores = static_cast<int>(thread::hardware_concurrency());
+  srand(2025);
+  writeCatalog(n);
+  printf("%d books, %d cores\n", n, cores);
+
+  {
+    BooksManager manager;
+    double ms = timeMs([&] {
+      ifstream in(CATALOG_PATH);
+      string line;
+      while (getline(in, line)) {
+        size_t c1 = line.find(',');
+        size_t c2 = line.find(',', c1 + 1);
+        size_t c3 = line.find(',', c2 + 1);
+        int copies = c3 == string::npos ? 1 : atoi(line.c_str() + c3 + 1);
+        manager.addBookDirect(line.substr(0, c1),
+                              line.substr(c1 + 1, c2 - c1 - 1),
+                              line.substr(c2 + 1, c3 - c2 - 1), copies);
+      }
+    });
+    report("getline + addBookDirect", n, ms);
+  }
+
+  {
+    BooksManager manager;
+    double ms =
+        timeMs([&] { manager.importBooksFromFile(CATALOG_PATH, 1); });
+    report("importBooksFromFile, 1 thread", n, ms);
+  }
+
+  {
+    BooksManager manager;
+    int added = 0;
+    double ms =
+        timeMs([&] { added = manager.importBooksFromFile(CATALOG_PATH); });
+    report("importBooksFromFile, all", n, ms);
+    if (added != n)
+      printf("  (imported %d of %d)\n", added, n);
+  }
+
+  remove(CATALOG_PATH);
+  return 0;
+}
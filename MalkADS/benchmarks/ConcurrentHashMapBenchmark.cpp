@@ -0,0 +1,114 @@
+//
+// Multi-threaded throughput of ConcurrentHashMap against a single HashMap
+// behind one std::mutex, at 1-32 threads. Workload per operation:
+// 90% get, 5% putNew, 5% erase over a pool of resource-ID style keys.
+//
+#include "structures/concurrent_hash_map.h"
+#include "structures/hash_map.h"
+
+#include <atomic>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+const int kKeys = 100000;
+const int kOpsPerThread = 400000;
+
+// Single-table baseline: what the managers would need without striping.
+class MutexHashMap {
+public:
+  bool putNew(const string &k, int v) {
+    lock_guard<mutex> g(m_);
+    return map_.putNew(k, v);
+  }
+  bool get(const string &k, int &out) {
+    lock_guard<mutex> g(m_);
+    int *v = map_.get(k);
+    if (!v)
+      return false;
+    out = *v;
+    return true;
+  }
+  bool erase(const string &k) {
+    lock_guard<mutex> g(m_);
+    return map_.erase(k);
+  }
+
+private:
+  mutex m_;
+  HashMap<string, int> map_;
+};
+
+template <typename Map>
+double run(Map &map, const vector<string> &keys, int threads) {
+  atomic<bool> go(false);
+  vector<thread> workers;
+  for (int t = 0; t < threads; t++) {
+    workers.emplace_back([&, t] {
+      uint32_t x = 2463534242u + t * 7919u;
+      volatile int sink = 0;
+      while (!go.load())
+        this_thread::yield();
+      for (int i = 0; i < kOpsPerThread; i++) {
+        x ^= x << 13;
+        x ^= x >> 17;
+        x ^= x << 5;
+        const string &k = keys[x % kKeys];
+        const int op = (x >> 20) % 100;
+        int v;
+        if (op < 90) {
+          if (map.get(k, v))
+            sink = sink + v;
+        } else if (op < 95) {
+          map.putNew(k, i);
+        } else {
+          map.erase(k);
+        }
+      }
+    });
+  }
+  auto t0 = chrono::steady_clock::now();
+  go.store(true);
+  for (thread &w : workers)
+    w.join();
+  auto t1 = chrono::steady_clock::now();
+  double sec = chrono::duration<double>(t1 - t0).count();
+  return static_cast<double>(threads) * kOpsPerThread / sec / 1e6;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  int shards = argc > 1 ? atoi(argv[1]) : 64;
+
+  vector<string> keys;
+  char buf[16];
+  for (int i = 0; i < kKeys; i++) {
+    snprintf(buf, sizeof(buf), "%c%05d", "RLB"[i % 3], i);
+    keys.push_back(buf);
+  }
+
+  printf("threads   mutex HashMap (Mops/s)   ConcurrentHashMap/%d (Mops/s)\n",
+         shards);
+  const int counts[] = {1, 2, 4, 8, 16, 32};
+  for (int threads : counts) {
+    MutexHashMap locked;
+    ConcurrentHashMap<string, int> striped(shards);
+    for (int i = 0; i < kKeys; i += 2) {
+      locked.putNew(keys[i], i);
+      striped.putNew(keys[i], i);
+    }
+    double a = run(locked, keys, threads);
+    double b = run(striped, keys, threads);
+    printf("%7d   %22.2f   %28.2f\n", threads, a, b);
+  }
+  return 0;
+}
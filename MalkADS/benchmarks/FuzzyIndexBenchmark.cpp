@@ -0,0 +1,134 @@
+//
+// Indexes a synthetic catalog of titles (1M by default), then looks up
+// misspelled copies of random titles with FuzzyIndex and with a brute-force
+// scan that runs the same bounded edit distance on every title.
+//
+#include "structures/fuzzy_index.h"
+
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+// A vocabulary of random words whose letters follow English letter
+// frequencies, drawn with a Zipf-like skew so a few words are very common,
+// as in real titles.
+const int VOCABULARY_SIZE = 50000;
+const char *LETTERS_BY_FREQUENCY = "eeeeeeeeeeeetttttttttaaaaaaaaoooooooiiiiiii"
+                                   "nnnnnnnsssssshhhhhhrrrrrrddddllllcccuuummm"
+                                   "wwffggyyppbbvkjxqz";
+const char *STOPWORDS[] = {"the", "of", "and", "a", "in", "to"};
+
+vector<string> vocabulary;
+
+void buildVocabulary() {
+  const int letters = static_cast<int>(strlen(LETTERS_BY_FREQUENCY));
+  for (int w = 0; w < VOCABULARY_SIZE; w++) {
+    string word;
+    int len = 3 + rand() % 7;
+    for (int i = 0; i < len; i++)
+      word += LETTERS_BY_FREQUENCY[rand() % letters];
+    vocabulary.push_back(word);
+  }
+}
+
+// Index skewed towards the front: P(i) roughly proportional to 1/(i+1)
+int zipf(int size) {
+  double u = (rand() + 1.0) / (RAND_MAX + 2.0);
+  int i = static_cast<int>(pow(static_cast<double>(size), u)) - 1;
+  return i < 0 ? 0 : (i >= size ? size - 1 : i);
+}
+
+template <typename Func> double timeMs(Func func) {
+  auto t0 = chrono::steady_clock::now();
+  func();
+  auto t1 = chrono::steady_clock::now();
+  return chrono::duration<double, milli>(t1 - t0).count();
+}
+
+string randomTitle() {
+  string t;
+  int words = 2 + rand() % 4;
+  for (int w = 0; w < words; w++) {
+    if (w)
+      t += ' ';
+    if (rand() % 4 == 0)
+      t += STOPWORDS[rand() % 6];
+    else
+      t += vocabulary[zipf(static_cast<int>(vocabulary.size()))];
+  }
+  return t;
+}
+
+// One random substitution, deletion or insertion of a letter
+string typo(string s) {
+  int pos = rand() % s.size();
+  char c = static_cast<char>('a' + rand() % 26);
+  switch (rand() % 3) {
+  case 0:
+    s[pos] = c;
+    break;
+  case 1:
+    s.erase(pos, 1);
+    break;
+  default:
+    s.insert(s.begin() + pos, c);
+  }
+  return s;
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  int n = argc > 1 ? atoi(argv[1]) : 1000000;
+  const int queries = 1000;
+  const int scanQueries = 20;
+  const int maxDistance = 2;
+  const int k = 5;
+  srand(2025);
+  buildVocabulary();
+
+  vector<string> titles(n);
+  for (int i = 0; i < n; i++)
+    titles[i] = randomTitle();
+
+  FuzzyIndex index;
+  double buildMs = timeMs([&] {
+    for (int i = 0; i < n; i++)
+      index.add(i, titles[i]);
+  });
+  printf("%d titles, indexed in %.0f ms\n", n, buildMs);
+
+  vector<string> probes(queries);
+  for (int q = 0; q < queries; q++)
+    probes[q] = typo(titles[rand() % n]);
+
+  long long reported = 0;
+  double indexMs = timeMs([&] {
+    for (int q = 0; q < queries; q++)
+      reported += index.search(probes[q], maxDistance, k, [](int, int) {});
+  });
+  printf("  FuzzyIndex    %8.3f ms/query   (%.1f matches/query)\n",
+         indexMs / queries, static_cast<double>(reported) / queries);
+
+  long long scanned = 0;
+  double scanMs = timeMs([&] {
+    for (int q = 0; q < scanQueries; q++) {
+      const string query = TextIndex::normalize(probes[q]);
+      for (int i = 0; i < n; i++)
+        if (FuzzyIndex::boundedDistance(query, titles[i], maxDistance) <=
+            maxDistance)
+          scanned++;
+    }
+  });
+  printf("  full scan     %8.3f ms/query   (%.1f matches/query)\n",
+         scanMs / scanQueries, static_cast<double>(scanned) / scanQueries);
+  return 0;
+}
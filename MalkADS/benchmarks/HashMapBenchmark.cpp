@@ -0,0 +1,150 @@
+//
+// Compares HashMap hashers on the key shapes the managers actually store:
+// usernames, resource IDs ("R150B", "L004", "LAP123") and lower-cased book
+// titles. Real keys from data/ are used as seeds for the synthetic sets.
+//
+#include "structures/hash_map.h"
+#include "structures/string_hash.h"
+
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+struct StdStringHash {
+  size_t operator()(const string &key) const { return std::hash<string>{}(key); }
+};
+
+struct Fnv1aHash {
+  size_t operator()(const string &key) const {
+    uint64_t h = 1469598103934665603ull;
+    for (unsigned char c : key) {
+      h ^= c;
+      h *= 1099511628211ull;
+    }
+    return static_cast<size_t>(h);
+  }
+};
+
+// Read the first comma-separated column of a data file, if it exists.
+vector<string> readColumn(const string &path) {
+  vector<string> out;
+  ifstream file(path);
+  string line;
+  while (getline(file, line)) {
+    if (line.empty())
+      continue;
+    out.push_back(line.substr(0, line.find(',')));
+  }
+  return out;
+}
+
+vector<string> makeUsernames(int n) {
+  vector<string> keys = readColumn("data/users.txt");
+  static const char *stems[] = {"student", "faculty_", "alice", "bob", "malk",
+                                "sedra",   "radwa",    "hamdy"};
+  for (int i = 0; static_cast<int>(keys.size()) < n; i++)
+    keys.push_back(stems[i % 8] + to_string(i));
+  return keys;
+}
+
+vector<string> makeResourceIds(int n) {
+  vector<string> keys = readColumn("data/rooms.txt");
+  vector<string> laptops = readColumn("data/laptops.txt");
+  keys.insert(keys.end(), laptops.begin(), laptops.end());
+  char buf[16];
+  for (int i = 0; static_cast<int>(keys.size()) < n; i++) {
+    switch (i % 3) {
+    case 0:
+      snprintf(buf, sizeof(buf), "R%03d%c", i % 1000, 'A' + (i / 1000) % 26);
+      break;
+    case 1:
+      snprintf(buf, sizeof(buf), "L%03d", i % 1000 + (i / 1000) * 1000);
+      break;
+    default:
+      snprintf(buf, sizeof(buf), "LAP%d", i);
+    }
+    keys.push_back(buf);
+  }
+  return keys;
+}
+
+vector<string> makeTitles(int n) {
+  vector<string> keys = readColumn("data/books.txt");
+  static const char *words[] = {"the",     "art",       "of",       "computer",
+                                "data",    "structures", "java",    "python",
+                                "design",  "patterns",  "modern",   "c++",
+                                "algorithms", "crash",  "course",   "introduction",
+                                "to",      "systems",   "networks", "theory"};
+  for (int i = 0; static_cast<int>(keys.size()) < n; i++) {
+    string title;
+    int x = i;
+    int len = 2 + i % 5;
+    for (int w = 0; w < len; w++) {
+      if (w)
+        title += ' ';
+      title += words[x % 20];
+      x = x / 20 + w * 7 + 3;
+    }
+    title += " " + to_string(i / 20);
+    keys.push_back(title);
+  }
+  return keys;
+}
+
+template <typename Func> double timeMs(Func func) {
+  auto t0 = chrono::steady_clock::now();
+  func();
+  auto t1 = chrono::steady_clock::now();
+  return chrono::duration<double, milli>(t1 - t0).count();
+}
+
+template <typename Hash>
+void runHasher(const char *name, const vector<string> &keys, int rounds) {
+  Hash hasher;
+  volatile size_t sink = 0;
+  double hashMs = timeMs([&] {
+    for (int r = 0; r < rounds; r++)
+      for (const string &k : keys)
+        sink = sink + hasher(k);
+  });
+
+  double mapMs = timeMs([&] {
+    HashMap<string, int, Hash> map;
+    for (size_t i = 0; i < keys.size(); i++)
+      map.putNew(keys[i], static_cast<int>(i));
+    for (int r = 0; r < rounds; r++)
+      for (const string &k : keys)
+        sink = sink + *map.get(k);
+  });
+
+  const double ops = static_cast<double>(keys.size()) * rounds;
+  printf("  %-16s hash %7.2f ns/key   map build+lookup %7.2f ns/lookup\n", name,
+         hashMs * 1e6 / ops, mapMs * 1e6 / ops);
+}
+
+void runSet(const char *label, const vector<string> &keys, int rounds) {
+  printf("%s (%zu keys)\n", label, keys.size());
+  runHasher<StdStringHash>("std::hash", keys, rounds);
+  runHasher<Fnv1aHash>("fnv1a", keys, rounds);
+  runHasher<FastStringHash>("FastStringHash", keys, rounds);
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  int n = argc > 1 ? atoi(argv[1]) : 200000;
+  const int rounds = 10;
+
+  runSet("usernames", makeUsernames(n), rounds);
+  runSet("resource IDs", makeResourceIds(n), rounds);
+  runSet("book titles (lower-cased)", makeTitles(n), rounds);
+  return 0;
+}
@@ -0,0 +1,172 @@
+//
+// Builds a list of n book titles, scans it repeatedly (the author search
+// path) and then removes every other title, on the unrolled LinkedList and
+// on the node-per-element list the repo used before (kept here for
+// comparison).
+//
+// Then collects n catalog rows the way importBooksFromFile does (append
+// only, then several in-order passes) in a vector and in the
+// LinkedList<CatalogRow, 32> the import uses.
+//
+#include "structures/linked_list.h"
+#include "structures/string_arena.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+const int SCANS = 50;
+
+template <typename Func> double timeMs(Func func) {
+  auto t0 = chrono::steady_clock::now();
+  func();
+  auto t1 = chrono::steady_clock::now();
+  return chrono::duration<double, milli>(t1 - t0).count();
+}
+
+void report(const char *name, double buildMs, double scanMs, double removeMs,
+            size_t check) {
+  printf("  %-16s build %8.2f ms   scan %8.2f ms   remove %8.2f ms  (%zu)\n",
+         name, buildMs, scanMs, removeMs, check);
+}
+
+// The previous LinkedList: one heap node per element, T copied in, no tail
+// pointer so push_back walks the list
+template <typename T> class NodeList {
+  struct Node {
+    T data;
+    Node *next;
+    Node(T val) : data(val), next(nullptr) {}
+  };
+  Node *head = nullptr;
+
+public:
+  ~NodeList() {
+    while (head) {
+      Node *t = head;
+      head = head->next;
+      delete t;
+    }
+  }
+
+  void push_back(const T &value) {
+    Node *n = new Node(value);
+    if (!head) {
+      head = n;
+      return;
+    }
+    Node *cur = head;
+    while (cur->next)
+      cur = cur->next;
+    cur->next = n;
+  }
+
+  bool remove(const T &value) {
+    Node **link = &head;
+    while (*link) {
+      if ((*link)->data == value) {
+        Node *t = *link;
+        *link = t->next;
+        delete t;
+        return true;
+      }
+      link = &(*link)->next;
+    }
+    return false;
+  }
+
+  template <typename Func> void forEach(Func func) const {
+    for (Node *cur = head; cur; cur = cur->next)
+      func(cur->data);
+  }
+};
+
+template <typename List>
+void runValueList(const char *name, const vector<string> &titles) {
+  List list;
+  size_t check = 0;
+  double buildMs = timeMs([&] {
+    for (const string &t : titles)
+      list.push_back(t);
+  });
+  double scanMs = timeMs([&] {
+    for (int s = 0; s < SCANS; s++)
+      list.forEach([&](const string &t) { check += t.size(); });
+  });
+  double removeMs = timeMs([&] {
+    for (size_t i = 0; i < titles.size(); i += 2)
+      list.remove(titles[i]);
+  });
+  report(name, buildMs, scanMs, removeMs, check);
+}
+
+// Same layout as a catalog row in BooksManager.cpp
+struct Row {
+  StringRef id;
+  StringRef title;
+  StringRef author;
+  int copies;
+  void *book;
+};
+
+// Rows are appended, then walked once per import pass
+const int ROW_PASSES = 6;
+
+template <typename Rows>
+double collectRows(const vector<string> &titles, size_t &check) {
+  return timeMs([&] {
+    Rows rows;
+    for (const string &t : titles) {
+      Row row;
+      row.id = StringRef(t.data(), 5);
+      row.title = StringRef(t);
+      row.author = StringRef(t.data(), 3);
+      row.copies = 1;
+      row.book = nullptr;
+      rows.push_back(row);
+    }
+    for (int p = 0; p < ROW_PASSES; p++)
+      for (Row &row : rows)
+        check += row.title.size() + row.copies;
+  });
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  int n = argc > 1 ? atoi(argv[1]) : 20000;
+  vector<string> titles(n);
+  srand(2025);
+  for (int i = 0; i < n; i++)
+    titles[i] = "title " + to_string(rand()) + " " + to_string(i);
+
+  printf("%d titles, %d scans, then every other title removed by value\n", n,
+         SCANS);
+  runValueList<NodeList<string>>("node list (old)", titles);
+  runValueList<LinkedList<string>>("LinkedList", titles);
+
+  const int ROW_COPIES = 10; // import-sized: 10 rows per title
+  vector<string> rowTitles;
+  for (int c = 0; c < ROW_COPIES; c++)
+    rowTitles.insert(rowTitles.end(), titles.begin(), titles.end());
+  printf("%zu catalog rows appended, then %d passes\n", rowTitles.size(),
+         ROW_PASSES);
+  // Alternate the two and keep each one's best, so neither pays alone for
+  // the first touch of fresh memory
+  size_t check = 0;
+  double vectorMs = 1e9, listMs = 1e9;
+  for (int round = 0; round < 5; round++) {
+    vectorMs = min(vectorMs, collectRows<vector<Row>>(rowTitles, check));
+    listMs = min(listMs, collectRows<LinkedList<Row, 32>>(rowTitles, check));
+  }
+  printf("  %-16s %8.2f ms\n  %-16s %8.2f ms  (%zu)\n", "vector", vectorMs,
+         "LinkedList<,32>", listMs, check);
+  return 0;
+}
@@ -0,0 +1,176 @@
+//
+// Compares PriorityQueue arities on request-shaped elements (a username and
+// a book ID next to the integer priority), plus the previous binary heap that
+// copied elements through a default-constructed array.
+//
+#include "structures/priority_queue.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+struct Request {
+  long long priorityKey;
+  int seq;
+  string username;
+  string bookId;
+
+  bool operator<(const Request &o) const {
+    if (priorityKey != o.priorityKey)
+      return priorityKey < o.priorityKey;
+    return seq < o.seq;
+  }
+};
+
+// The heap as it was before it became d-ary and move-aware
+template <typename T> class CopyingBinaryHeap {
+  T *heapArray;
+  int capacity;
+  int currentSize;
+
+  void resize() {
+    int newCapacity = capacity * 2;
+    T *newArray = new T[newCapacity];
+    for (int i = 0; i < currentSize; i++)
+      newArray[i] = heapArray[i];
+    delete[] heapArray;
+    heapArray = newArray;
+    capacity = newCapacity;
+  }
+
+public:
+  CopyingBinaryHeap(int initialCapacity = 10)
+      : heapArray(new T[initialCapacity]), capacity(initialCapacity),
+        currentSize(0) {}
+  ~CopyingBinaryHeap() { delete[] heapArray; }
+
+  void push(const T &value) {
+    if (currentSize == capacity)
+      resize();
+    heapArray[currentSize] = value;
+    int index = currentSize++;
+    while (index > 0) {
+      int parent = (index - 1) / 2;
+      if (!(heapArray[index] < heapArray[parent]))
+        break;
+      T tmp = heapArray[index];
+      heapArray[index] = heapArray[parent];
+      heapArray[parent] = tmp;
+      index = parent;
+    }
+  }
+
+  T top() const { return heapArray[0]; }
+
+  void pop() {
+    heapArray[0] = heapArray[--currentSize];
+    int index = 0;
+    while (true) {
+      int left = 2 * index + 1, right = 2 * index + 2, target = index;
+      if (left < currentSize && heapArray[left] < heapArray[target])
+        target = left;
+      if (right < currentSize && heapArray[right] < heapArray[target])
+        target = right;
+      if (target == index)
+        break;
+      T tmp = heapArray[index];
+      heapArray[index] = heapArray[target];
+      heapArray[target] = tmp;
+      index = target;
+    }
+  }
+};
+
+vector<Request> makeRequests(int n) {
+  vector<Request> out;
+  out.reserve(n);
+  srand(12345);
+  for (int i = 0; i < n; i++) {
+    Request r;
+    r.priorityKey = 1700000000LL + rand() % (30 * 24 * 3600);
+    r.seq = i;
+    r.username = "student_with_a_long_name_" + to_string(i % 5000);
+    r.bookId = "B" + to_string(rand() % 100000);
+    out.push_back(r);
+  }
+  return out;
+}
+
+template <typename Func> double timeMs(Func func) {
+  auto t0 = chrono::steady_clock::now();
+  func();
+  auto t1 = chrono::steady_clock::now();
+  return chrono::duration<double, milli>(t1 - t0).count();
+}
+
+void report(const char *name, double pushMs, double popMs, int n) {
+  printf("  %-22s push %7.1f ns/op   pop %7.1f ns/op\n", name, pushMs * 1e6 / n,
+         popMs * 1e6 / n);
+}
+
+void runLegacy(const vector<Request> &reqs) {
+  const int n = static_cast<int>(reqs.size());
+  CopyingBinaryHeap<Request> pq;
+  volatile size_t sink = 0;
+  double pushMs = timeMs([&] {
+    for (const Request &r : reqs)
+      pq.push(r);
+  });
+  double popMs = timeMs([&] {
+    for (int i = 0; i < n; i++) {
+      Request r = pq.top();
+      pq.pop();
+      sink = sink + r.username.size();
+    }
+  });
+  report("binary, copying (old)", pushMs, popMs, n);
+}
+
+template <int Arity> void runArity(const char *name, const vector<Request> &reqs) {
+  const int n = static_cast<int>(reqs.size());
+  PriorityQueue<Request, DefaultComparator<Request>, Arity> pq;
+  volatile size_t sink = 0;
+  double pushMs = timeMs([&] {
+    for (const Request &r : reqs)
+      pq.push(r);
+  });
+  double popMs = timeMs([&] {
+    for (int i = 0; i < n; i++)
+      sink = sink + pq.pop().username.size();
+  });
+  report(name, pushMs, popMs, n);
+}
+
+template <int Arity>
+void runHeapify(const char *name, const vector<Request> &reqs) {
+  const int n = static_cast<int>(reqs.size());
+  double ms = timeMs([&] {
+    PriorityQueue<Request, DefaultComparator<Request>, Arity> pq(reqs.begin(),
+                                                                 reqs.end());
+  });
+  printf("  %-22s %7.1f ns/element\n", name, ms * 1e6 / n);
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  int n = argc > 1 ? atoi(argv[1]) : 500000;
+  vector<Request> reqs = makeRequests(n);
+
+  printf("push all, then pop all (%d requests)\n", n);
+  runLegacy(reqs);
+  runArity<2>("binary, moving", reqs);
+  runArity<4>("4-ary, moving", reqs);
+  runArity<8>("8-ary, moving", reqs);
+
+  printf("build from range (heapify)\n");
+  runHeapify<2>("binary", reqs);
+  runHeapify<4>("4-ary", reqs);
+  return 0;
+}
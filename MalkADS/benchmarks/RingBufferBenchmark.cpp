@@ -0,0 +1,167 @@
+//
+// Moves a few million small requests from producer threads to one consumer
+// through SpscRingBuffer / MpscRingBuffer and through a mutex-guarded
+// std::deque (the obvious alternative), one item at a time and in batches.
+//
+#include "structures/ring_buffer.h"
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdio>
+#include <cstdlib>
+#include <deque>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+const int BATCH = 32;
+
+template <typename Func> double timeMs(Func func) {
+  auto t0 = chrono::steady_clock::now();
+  func();
+  auto t1 = chrono::steady_clock::now();
+  return chrono::duration<double, milli>(t1 - t0).count();
+}
+
+void report(const char *name, int producers, double ms, int n) {
+  printf("  %-22s %d producer(s)  %8.1f ms  %7.1f ns/item\n", name, producers,
+         ms, ms * 1e6 / n);
+}
+
+// Bounded FIFO with the same try-push/try-pop shape as the ring buffers
+class LockedQueue {
+public:
+  explicit LockedQueue(int capacity) : cap(capacity) {}
+
+  bool tryPush(long long v) {
+    lock_guard<mutex> lock(m);
+    if (static_cast<int>(items.size()) >= cap)
+      return false;
+    items.push_back(v);
+    return true;
+  }
+
+  int tryPushBatch(const long long *v, int count) {
+    lock_guard<mutex> lock(m);
+    int n = 0;
+    while (n < count && static_cast<int>(items.size()) < cap)
+      items.push_back(v[n++]);
+    return n;
+  }
+
+  bool tryPop(long long &out) {
+    lock_guard<mutex> lock(m);
+    if (items.empty())
+      return false;
+    out = items.front();
+    items.pop_front();
+    return true;
+  }
+
+  int tryPopBatch(long long *out, int maxCount) {
+    lock_guard<mutex> lock(m);
+    int n = 0;
+    while (n < maxCount && !items.empty()) {
+      out[n++] = items.front();
+      items.pop_front();
+    }
+    return n;
+  }
+
+private:
+  mutex m;
+  deque<long long> items;
+  int cap;
+};
+
+template <typename Queue>
+double run(Queue &queue, int producers, int perProducer, bool batched) {
+  volatile long long sink = 0;
+  return timeMs([&] {
+    vector<thread> threads;
+    for (int p = 0; p < producers; p++) {
+      threads.push_back(thread([&queue, perProducer, batched] {
+        long long buffer[BATCH];
+        int next = 0;
+        while (next < perProducer) {
+          if (!batched) {
+            if (queue.tryPush(next))
+              next++;
+            else
+              this_thread::yield();
+            continue;
+          }
+          int n = 0;
+          while (n < BATCH && next + n < perProducer) {
+            buffer[n] = next + n;
+            n++;
+          }
+          int pushed = queue.tryPushBatch(buffer, n);
+          if (pushed == 0)
+            this_thread::yield();
+          next += pushed;
+        }
+      }));
+    }
+
+    const int total = producers * perProducer;
+    long long buffer[BATCH];
+    int received = 0;
+    while (received < total) {
+      if (!batched) {
+        long long v;
+        if (queue.tryPop(v)) {
+          sink = sink + v;
+          received++;
+        } else {
+          this_thread::yield();
+        }
+        continue;
+      }
+      int n = queue.tryPopBatch(buffer, BATCH);
+      if (n == 0)
+        this_thread::yield();
+      for (int i = 0; i < n; i++)
+        sink = sink + buffer[i];
+      received += n;
+    }
+    for (thread &t : threads)
+      t.join();
+  });
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  int n = argc > 1 ? atoi(argv[1]) : 4000000;
+  const int capacity = 4096;
+  const int manyProducers = 4;
+
+  printf("%d items, capacity %d, batches of %d\n", n, capacity, BATCH);
+  for (int batched = 0; batched <= 1; batched++) {
+    printf(batched ? "batched:\n" : "one at a time:\n");
+    {
+      SpscRingBuffer<long long> ring(capacity);
+      report("SpscRingBuffer", 1, run(ring, 1, n, batched != 0), n);
+    }
+    {
+      LockedQueue locked(capacity);
+      report("mutex + deque", 1, run(locked, 1, n, batched != 0), n);
+    }
+    {
+      MpscRingBuffer<long long> ring(capacity);
+      report("MpscRingBuffer", manyProducers,
+             run(ring, manyProducers, n / manyProducers, batched != 0), n);
+    }
+    {
+      LockedQueue locked(capacity);
+      report("mutex + deque", manyProducers,
+             run(locked, manyProducers, n / manyProducers, batched != 0), n);
+    }
+  }
+  return 0;
+}
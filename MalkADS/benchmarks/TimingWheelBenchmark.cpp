@@ -0,0 +1,107 @@
+//
+// Schedules a few million timers spread over 30 days of one-second ticks,
+// cancels half of them and runs the clock to the end, on TimingWheel and on
+// a plain PriorityQueue with lazy cancellation (the obvious alternative).
+//
+#include "structures/priority_queue.h"
+#include "structures/timing_wheel.h"
+
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+using namespace std;
+
+namespace {
+
+const long long HORIZON = 30LL * 24 * 3600;
+
+template <typename Func> double timeMs(Func func) {
+  auto t0 = chrono::steady_clock::now();
+  func();
+  auto t1 = chrono::steady_clock::now();
+  return chrono::duration<double, milli>(t1 - t0).count();
+}
+
+void report(const char *name, double scheduleMs, double cancelMs,
+            double advanceMs, int n, int fired) {
+  printf("  %-14s schedule %6.1f ns   cancel %6.1f ns   advance %8.1f ms "
+         "(%d fired)\n",
+         name, scheduleMs * 1e6 / n, cancelMs * 1e6 / (n / 2), advanceMs,
+         fired);
+}
+
+void runWheel(const vector<long long> &expiries) {
+  const int n = static_cast<int>(expiries.size());
+  TimingWheel<int> wheel;
+  vector<TimingWheel<int>::TimerId> ids(n);
+  volatile long long sink = 0;
+  int fired = 0;
+
+  double scheduleMs = timeMs([&] {
+    for (int i = 0; i < n; i++)
+      ids[i] = wheel.schedule(expiries[i], i);
+  });
+  double cancelMs = timeMs([&] {
+    for (int i = 0; i < n; i += 2)
+      wheel.cancel(ids[i]);
+  });
+  double advanceMs = timeMs([&] {
+    fired = wheel.advance(HORIZON, [&](long long e, int &v) { sink = sink + e + v; });
+  });
+  report("TimingWheel", scheduleMs, cancelMs, advanceMs, n, fired);
+}
+
+struct HeapTimer {
+  long long expiry;
+  int id;
+  bool operator<(const HeapTimer &o) const { return expiry < o.expiry; }
+};
+
+void runHeap(const vector<long long> &expiries) {
+  const int n = static_cast<int>(expiries.size());
+  PriorityQueue<HeapTimer> heap;
+  vector<char> cancelled(n, 0);
+  volatile long long sink = 0;
+  int fired = 0;
+
+  double scheduleMs = timeMs([&] {
+    for (int i = 0; i < n; i++) {
+      HeapTimer t;
+      t.expiry = expiries[i];
+      t.id = i;
+      heap.push(t);
+    }
+  });
+  double cancelMs = timeMs([&] {
+    for (int i = 0; i < n; i += 2)
+      cancelled[i] = 1;
+  });
+  double advanceMs = timeMs([&] {
+    while (!heap.isEmpty() && heap.top().expiry <= HORIZON) {
+      HeapTimer t = heap.pop();
+      if (cancelled[t.id])
+        continue;
+      sink = sink + t.expiry + t.id;
+      fired++;
+    }
+  });
+  report("PriorityQueue", scheduleMs, cancelMs, advanceMs, n, fired);
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+  int n = argc > 1 ? atoi(argv[1]) : 2000000;
+  vector<long long> expiries(n);
+  srand(2025);
+  for (int i = 0; i < n; i++)
+    expiries[i] =
+        1 + (static_cast<long long>(rand()) * 4099 + rand()) % HORIZON;
+
+  printf("%d timers over %lld one-second ticks, half cancelled\n", n, HORIZON);
+  runWheel(expiries);
+  runHeap(expiries);
+  return 0;
+}
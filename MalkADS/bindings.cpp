@@ -1,9 +1,12 @@
+#include "include/managers/BookingEngine.h"
 #include "include/managers/BooksManager.h"
 #include "include/managers/LaptopsManager.h"
 #include "include/managers/RoomsManager.h"
 #include "include/managers/UsersManager.h"
+#include "include/helpers/ClockThread.h"
 #include "include/models/user.h"
 #include <pybind11/pybind11.h>
+#include <stdexcept>
 
 namespace py = pybind11;
 
@@ -15,35 +18,91 @@ private:
   RoomsManager rooms;
   LaptopsManager laptops;
   BooksManager books;
+  // Sole writer of the managers once started; reads use engine.inspect()
+  BookingEngine engine;
+  // Optional background driver for the managers' timers
+  ClockThread clock;
+
+  // Apply a change on the engine thread. The GIL is released while we wait
+  // so other Python threads can submit, and their requests share a batch.
+  BookingResult run(const BookingRequest &request) {
+    py::gil_scoped_release release;
+    return engine.execute(request);
+  }
+
+  // Room attributes from keyword arguments; floor is an int (negative for
+  // basements) or None if unknown, equipment is "name|name|...". Unknown
+  // equipment names raise ValueError rather than being dropped.
+  static RoomAttributes roomAttributes(int capacity, const py::object &floor,
+                                       const std::string &equipment) {
+    RoomAttributes room(capacity, RoomAttributes::UNKNOWN_FLOOR, 0);
+    if (!floor.is_none()) {
+      room.floor = floor.cast<int>();
+      if (room.floor == RoomAttributes::UNKNOWN_FLOOR)
+        throw std::invalid_argument("Floor " + std::to_string(room.floor) +
+                                    " is out of range");
+    }
+    if (!RoomAttributes::parseEquipment(equipment, room.equipment))
+      throw std::invalid_argument("Unknown equipment in '" + equipment + "'");
+    return room;
+  }
+
+  static py::dict roomDetails(const std::string &id,
+                              const RoomAttributes &room) {
+    py::dict details;
+    details["id"] = id;
+    details["capacity"] = room.capacity;
+    if (room.floor == RoomAttributes::UNKNOWN_FLOOR)
+      details["floor"] = py::none();
+    else
+      details["floor"] = room.floor;
+    py::list equipment;
+    for (int i = 0; i < RoomAttributes::EQUIPMENT_KINDS; i++)
+      if (room.equipment & (1u << i))
+        equipment.append(std::string(RoomAttributes::equipmentName(i)));
+    details["equipment"] = equipment;
+    return details;
+  }
 
 public:
-  PyLibraryWrapper() {
+  PyLibraryWrapper() : engine(users, rooms, laptops, books) {
     users.loadUsersFromFile();
     rooms.syncUserBookings(users);
     laptops.syncUserBookings(users);
     books.syncUserBookings(users);
+    books.advanceClock(getCurrentSeconds());
+    engine.start();
   }
 
   ~PyLibraryWrapper() {
+    stopClock();
+    {
+      py::gil_scoped_release release;
+      engine.stop();
+    }
     // Ensure data is saved when object is destroyed
     saveAll();
   }
 
   void saveAll() {
     // Manually trigger saves to ensure data persists
-    rooms.saveRoomsToFile();
-    rooms.saveRoomBookingsToFile();
-    laptops.saveLaptopsToFile();
-    laptops.saveLaptopBookingsToFile();
-    books.saveBooksToFile();
-    books.saveBookBookingsToFile();
+    engine.inspect([&]() {
+      rooms.saveRoomsToFile();
+      rooms.saveRoomBookingsToFile();
+      laptops.saveLaptopsToFile();
+      laptops.saveLaptopBookingsToFile();
+      books.saveBooksToFile();
+      books.saveBookBookingsToFile();
+      books.saveWaitlistsToFile();
+    });
   }
 
   // Login - returns dict with success, username, is_admin
   py::dict login(const char *username, const char *password) {
     py::dict result;
 
-    User *loggedIn = users.login(username, password);
+    User *loggedIn = nullptr;
+    engine.inspect([&]() { loggedIn = users.login(username, password); });
     if (!loggedIn) {
       result["success"] = false;
       return result;
@@ -60,70 +119,223 @@ public:
   // Get list of rooms
   py::list getRooms() {
     py::list roomsList;
-    rooms.forEachRoom([&](const std::string &id) { roomsList.append(id); });
+    engine.inspect([&]() {
+      rooms.forEachRoom([&](const std::string &id) { roomsList.append(id); });
+    });
     return roomsList;
   }
 
+  // Every room with its attributes: [{"id", "capacity" (0: unknown),
+  // "floor" (None: unknown), "equipment": [name, ...]}, ...]
+  py::list getRoomDetails() {
+    py::list details;
+    engine.inspect([&]() {
+      rooms.forEachRoomWithAttributes(
+          [&](const std::string &id, const RoomAttributes &room) {
+            details.append(roomDetails(id, room));
+          });
+    });
+    return details;
+  }
+
   // Get bookings for a specific room
   py::list getRoomBookings(const char *roomId) {
     py::list bookingsList;
-    rooms.getRoomBookings(roomId,
-                          [&](int start, int end, const std::string &username) {
-                            py::dict booking;
-                            booking["start"] = start;
-                            booking["end"] = end;
-                            booking["username"] = username;
-                            bookingsList.append(booking);
-                          });
+    engine.inspect([&]() {
+      rooms.getRoomBookings(
+          roomId, [&](int start, int end, const std::string &username) {
+            py::dict booking;
+            booking["start"] = start;
+            booking["end"] = end;
+            booking["username"] = username;
+            bookingsList.append(booking);
+          });
+    });
     return bookingsList;
   }
 
+  // Free time of each room within [start, end): {room_id: [(gap_start,
+  // gap_end), ...]} with the gaps in time order. Pass room_id for just
+  // that room; an unknown room gives an empty dict.
+  py::dict getRoomsAvailability(int start, int end, const std::string &roomId) {
+    py::dict availability;
+    auto addRoom = [&](const std::string &id) {
+      py::list gaps;
+      if (rooms.forEachFreeGap(id, start, end, [&](int gapStart, int gapEnd) {
+            gaps.append(py::make_tuple(gapStart, gapEnd));
+          }))
+        availability[py::str(id)] = gaps;
+    };
+
+    engine.inspect([&]() {
+      if (!roomId.empty())
+        addRoom(roomId);
+      else
+        rooms.forEachRoom(addRoom);
+    });
+    return availability;
+  }
+
+  // Rooms free for the whole of [start, end), at most limit (0: all), with
+  // at least min_capacity seats, on floor (any if None) and with every piece
+  // of equipment named
+  py::list findFreeRooms(int start, int end, int limit, int minCapacity,
+                         const py::object &floor,
+                         const std::string &equipment) {
+    RoomAttributes need = roomAttributes(minCapacity, floor, equipment);
+    py::list roomsList;
+    engine.inspect([&]() {
+      rooms.findFreeRooms(start, end, need, limit,
+                          [&](const std::string &id) {
+                            roomsList.append(id);
+                          });
+    });
+    return roomsList;
+  }
+
   // Get list of laptops
   py::list getLaptops() {
     py::list laptopsList;
-    laptops.forEachLaptop(
-        [&](const std::string &id) { laptopsList.append(id); });
+    engine.inspect([&]() {
+      laptops.forEachLaptop(
+          [&](const std::string &id) { laptopsList.append(id); });
+    });
     return laptopsList;
   }
 
   // Get list of books
   py::list getBooks() {
     py::list booksList;
-    books.forEachBook([&](const std::string &id) { booksList.append(id); });
+    engine.inspect([&]() {
+      books.forEachBook([&](StringRef id) {
+        booksList.append(py::str(id.data(), id.size()));
+      });
+    });
     return booksList;
   }
 
-  // Get all books with details for search
-  py::list searchBooks() {
+  // Results a query returns when no limit is given
+  static const int DEFAULT_SEARCH_RESULTS = 100;
+
+  // The best limit books matching query (partial title/author words, see
+  // BooksManager::searchBooksRanked), best first, each with its "score".
+  // limit <= 0 means DEFAULT_SEARCH_RESULTS. An empty query lists the
+  // catalog instead, limit books of it (0: all).
+  py::list searchBooks(const std::string &query, int limit,
+                       bool byPopularity) {
     py::list booksList;
-    books.forEachBookWithDetails([&](const std::string &id,
-                                     const std::string &title,
-                                     const std::string &author) {
+    auto describe = [](StringRef id, StringRef title, StringRef author) {
       py::dict bookInfo;
-      bookInfo["id"] = id;
-      bookInfo["title"] = title;
-      bookInfo["author"] = author;
-      booksList.append(bookInfo);
+      bookInfo["id"] = py::str(id.data(), id.size());
+      bookInfo["title"] = py::str(title.data(), title.size());
+      bookInfo["author"] = py::str(author.data(), author.size());
+      return bookInfo;
+    };
+
+    engine.inspect([&]() {
+      if (!query.empty()) {
+        books.searchBooksRanked(
+            query, limit > 0 ? limit : DEFAULT_SEARCH_RESULTS, byPopularity,
+            [&](Book &book, double score) {
+              py::dict bookInfo =
+                  describe(book.idRef(), book.titleRef(), book.authorRef());
+              bookInfo["score"] = score;
+              booksList.append(bookInfo);
+            });
+        return;
+      }
+      books.forEachBookWithDetails(
+          [&](StringRef id, StringRef title, StringRef author) {
+            booksList.append(describe(id, title, author));
+          },
+          limit);
+    });
+    return booksList;
+  }
+
+  // searchBooks, with how many copies of each result are free for the
+  // whole of [start, end), checked in the same pass. Results are compact
+  // (id, title, author, free_copies, copies) tuples, best match first.
+  py::list searchBooksAvailable(const std::string &query, int start, int end,
+                                int limit, bool byPopularity) {
+    py::list booksList;
+    auto describe = [](StringRef id, StringRef title, StringRef author,
+                       int freeCopies, int copies) {
+      return py::make_tuple(py::str(id.data(), id.size()),
+                            py::str(title.data(), title.size()),
+                            py::str(author.data(), author.size()), freeCopies,
+                            copies);
+    };
+
+    engine.inspect([&]() {
+      if (!query.empty()) {
+        books.searchBooksAvailable(
+            query, start, end, limit > 0 ? limit : DEFAULT_SEARCH_RESULTS,
+            byPopularity, [&](Book &book, double, int freeCopies, int copies) {
+              booksList.append(describe(book.idRef(), book.titleRef(),
+                                        book.authorRef(), freeCopies,
+                                        copies));
+            });
+        return;
+      }
+      books.listBooksAvailable(
+          start, end, limit, [&](Book &book, int freeCopies, int copies) {
+            booksList.append(describe(book.idRef(), book.titleRef(),
+                                      book.authorRef(), freeCopies, copies));
+          });
     });
     return booksList;
   }
 
+  // Titles and authors starting with prefix, best first: each as
+  // {"text", "books"} where books is how many catalog entries it covers
+  py::list autocomplete(const std::string &prefix, int n) {
+    py::list suggestions;
+    engine.inspect([&]() {
+      books.autocomplete(prefix, n, [&](const std::string &text, int count) {
+        py::dict entry;
+        entry["text"] = text;
+        entry["books"] = count;
+        suggestions.append(entry);
+      });
+    });
+    return suggestions;
+  }
+
+  // Books whose title is within max_distance typos of title, closest
+  // first: each as {"id", "title", "author", "distance"}
+  py::list findSimilarBooks(const std::string &title, int maxDistance,
+                            int k) {
+    py::list matches;
+    engine.inspect([&]() {
+      books.findSimilarTitles(title, maxDistance, k,
+                              [&](Book &book, int distance) {
+                                py::dict bookInfo;
+                                bookInfo["id"] = book.getID();
+                                bookInfo["title"] = book.getTitle();
+                                bookInfo["author"] = book.getAuthor();
+                                bookInfo["distance"] = distance;
+                                matches.append(bookInfo);
+                              });
+    });
+    return matches;
+  }
+
   // Book a room
   py::dict bookRoom(const char *roomId, int start, int end,
                     const char *username) {
     py::dict result;
 
-    User *user = users.getUser(username);
-    if (!user) {
+    BookingResult r = run(BookingRequest(BookingRequest::BOOK_ROOM, username,
+                                         roomId, start, end));
+    if (r.status == BookingResult::UNKNOWN_USER) {
       result["success"] = false;
       result["message"] = "User not found";
       return result;
     }
 
-    bool success = rooms.bookRoomDirect(user, roomId, start, end);
-    result["success"] = success;
-
-    if (success) {
+    result["success"] = r.success();
+    if (r.success()) {
       result["message"] = "Room booked successfully!";
     } else {
       result["message"] = "Conflict detected! Room is already booked or you "
@@ -133,54 +345,85 @@ public:
     return result;
   }
 
+  // Book whichever room is free for [start, end) and meets the filters of
+  // find_free_rooms
+  py::dict bookAnyRoom(int start, int end, const std::string &username,
+                       int minCapacity, const py::object &floor,
+                       const std::string &equipment) {
+    py::dict result;
+    BookingRequest request(BookingRequest::BOOK_ANY_ROOM, username, "", start,
+                           end);
+    request.room = roomAttributes(minCapacity, floor, equipment);
+    BookingResult r = run(request);
+
+    result["success"] = r.success();
+    switch (r.status) {
+    case BookingResult::OK:
+      result["room_id"] = r.resourceId;
+      result["message"] = "Room " + r.resourceId + " booked successfully!";
+      break;
+    case BookingResult::UNKNOWN_USER:
+      result["message"] = "User not found";
+      break;
+    case BookingResult::LIMIT_REACHED:
+      result["message"] = "You already have another room booked during this "
+                          "period.";
+      break;
+    default:
+      result["message"] = "No rooms available for the selected time.";
+      break;
+    }
+    return result;
+  }
+
+  // Cancel the user's booking of a room for exactly [start, end]
+  py::dict cancelRoomBooking(const char *roomId, int start, int end,
+                             const char *username) {
+    py::dict result;
+
+    BookingResult r = run(BookingRequest(BookingRequest::CANCEL_ROOM_BOOKING,
+                                         username, roomId, start, end));
+    if (r.status == BookingResult::UNKNOWN_USER) {
+      result["success"] = false;
+      result["message"] = "User not found";
+      return result;
+    }
+
+    result["success"] = r.success();
+    result["message"] =
+        r.success() ? "Booking cancelled." : "No such booking found.";
+    return result;
+  }
+
   // Borrow a laptop (specific ID)
   bool borrowLaptop(const std::string &laptopId, int start, int end,
                     const std::string &username) {
-    User *user = users.getUser(username);
-    if (!user)
-      return false;
-    bool success = laptops.borrowLaptopDirect(user, laptopId, start, end);
-    if (success)
-      saveAll();
-    return success;
+    return run(BookingRequest(BookingRequest::BORROW_LAPTOP, username,
+                              laptopId, start, end))
+        .success();
   }
 
   // Borrow any available laptop
   py::dict borrowAnyLaptop(int start, int end, const std::string &username) {
     py::dict result;
-    User *user = users.getUser(username);
-    if (!user) {
-      result["success"] = false;
+    BookingResult r = run(BookingRequest(BookingRequest::BORROW_ANY_LAPTOP,
+                                         username, "", start, end));
+
+    result["success"] = r.success();
+    switch (r.status) {
+    case BookingResult::OK:
+      result["message"] = "Laptop " + r.resourceId + " assigned successfully!";
+      break;
+    case BookingResult::UNKNOWN_USER:
       result["message"] = "User not found";
-      return result;
-    }
-
-    if (!user->canBookLaptop(start, end)) {
-      result["success"] = false;
+      break;
+    case BookingResult::LIMIT_REACHED:
       result["message"] = "Limit reached: You already have a laptop borrowed "
                           "during this period.";
-      return result;
-    }
-
-    bool success = false;
-    std::string bookedId = "";
-
-    laptops.forEachLaptop([&](const std::string &id) {
-      if (!success) {
-        // Try to book this laptop
-        if (laptops.borrowLaptopDirect(user, id, start, end)) {
-          success = true;
-          bookedId = id;
-        }
-      }
-    });
-
-    result["success"] = success;
-    if (success) {
-      saveAll();
-      result["message"] = "Laptop " + bookedId + " assigned successfully!";
-    } else {
+      break;
+    default:
       result["message"] = "No laptops available for the selected time.";
+      break;
     }
     return result;
   }
@@ -190,18 +433,28 @@ public:
                       const char *username) {
     py::dict result;
 
-    User *user = users.getUser(username);
-    if (!user) {
+    BookingResult r = run(BookingRequest(BookingRequest::BORROW_BOOK,
+                                         username, bookId, start, end));
+    if (r.status == BookingResult::UNKNOWN_USER) {
       result["success"] = false;
       result["message"] = "User not found";
       return result;
     }
 
-    bool success = books.borrowBookDirect(user, bookId, start, end);
-    result["success"] = success;
+    result["success"] = r.success();
+    result["waitlisted"] = false;
 
-    if (success) {
+    if (r.success()) {
+      result["copy"] = r.copy + 1;
       result["message"] = "Book borrowed successfully!";
+    } else if (r.status == BookingResult::WAITLISTED) {
+      // Queued instead of making the GUI retry
+      result["waitlisted"] = true;
+      result["position"] = r.position;
+      result["message"] = "Book is on loan for that period. You are number " +
+                          std::to_string(r.position) +
+                          " on the waitlist and will get it automatically "
+                          "if it is returned in time.";
     } else {
       result["message"] = "Conflict detected! Book is not available or you've "
                           "reached the limit of 3 concurrent books.";
@@ -210,79 +463,243 @@ public:
     return result;
   }
 
+  // Cancel (or return early) a book loan; waiting requests are promoted
+  py::dict cancelBookLoan(const char *bookId, int start, int end,
+                          const char *username) {
+    py::dict result;
+
+    BookingResult r = run(BookingRequest(BookingRequest::CANCEL_BOOK_LOAN,
+                                         username, bookId, start, end));
+    if (r.status == BookingResult::UNKNOWN_USER) {
+      result["success"] = false;
+      result["message"] = "User not found";
+      return result;
+    }
+
+    result["success"] = r.success();
+    result["message"] = r.success() ? "Loan cancelled." : "No such loan found.";
+    return result;
+  }
+
+  // Withdraw from a book's waitlist
+  bool leaveWaitlist(const char *bookId, const char *username) {
+    return run(BookingRequest(BookingRequest::LEAVE_WAITLIST, username,
+                              bookId))
+        .success();
+  }
+
+  // Position in a book's waitlist (0 if not waiting) and queue length
+  py::dict getWaitlistStatus(const char *bookId, const char *username) {
+    py::dict result;
+    engine.inspect([&]() {
+      result["position"] = books.waitlistPosition(bookId, username);
+      result["length"] = books.waitlistSize(bookId);
+    });
+    return result;
+  }
+
+  // Run timers that came due (expired waitlist requests). Returns how many
+  // requests lapsed.
+  int advanceClock() {
+    BookingRequest tick;
+    tick.now = getCurrentSeconds();
+    return run(tick).count;
+  }
+
+  // Advance the clock from a background thread every intervalSeconds. Ticks
+  // are queued to the engine like any other change, so they need no GIL.
+  bool startClock(int intervalSeconds) {
+    return clock.start(intervalSeconds * 1000, [this]() {
+      BookingRequest tick;
+      tick.now = getCurrentSeconds();
+      engine.submit(tick);
+    });
+  }
+
+  void stopClock() {
+    py::gil_scoped_release release;
+    clock.stop();
+  }
+
   // Get user bookings
   py::list getUserBookings(const char *username) {
     py::list allBookings;
 
-    // Room bookings
-    rooms.forEachBooking([&](const std::string &resourceId, int start, int end,
-                             const std::string &bookedBy) {
-      if (bookedBy == username) {
-        py::dict booking;
-        booking["type"] = "room";
-        booking["resource_id"] = resourceId;
-        booking["start_time"] = start;
-        booking["end_time"] = end;
-        allBookings.append(booking);
-      }
-    });
+    engine.inspect([&]() {
+      // Room bookings
+      rooms.forEachBooking([&](const std::string &resourceId, int start,
+                               int end, const std::string &bookedBy) {
+        if (bookedBy == username) {
+          py::dict booking;
+          booking["type"] = "room";
+          booking["resource_id"] = resourceId;
+          booking["start_time"] = start;
+          booking["end_time"] = end;
+          allBookings.append(booking);
+        }
+      });
+
+      // Laptop bookings
+      laptops.forEachBooking([&](const std::string &resourceId, int start,
+                                 int end, const std::string &bookedBy) {
+        if (bookedBy == username) {
+          py::dict booking;
+          booking["type"] = "laptop";
+          booking["resource_id"] = resourceId;
+          booking["start_time"] = start;
+          booking["end_time"] = end;
+          allBookings.append(booking);
+        }
+      });
 
-    // Laptop bookings
-    laptops.forEachBooking([&](const std::string &resourceId, int start,
+      // Book bookings
+      books.forEachBooking([&](const std::string &resourceId, int start,
                                int end, const std::string &bookedBy) {
-      if (bookedBy == username) {
-        py::dict booking;
-        booking["type"] = "laptop";
-        booking["resource_id"] = resourceId;
-        booking["start_time"] = start;
-        booking["end_time"] = end;
-        allBookings.append(booking);
-      }
+        if (bookedBy == username) {
+          py::dict booking;
+          booking["type"] = "book";
+          booking["resource_id"] = resourceId;
+          booking["start_time"] = start;
+          booking["end_time"] = end;
+
+          // Add book details
+          Book *book = books.getBook(resourceId);
+          if (book) {
+            booking["title"] = book->getTitle();
+            booking["author"] = book->getAuthor();
+          } else {
+            booking["title"] = "Unknown Title";
+            booking["author"] = "Unknown Author";
+          }
+
+          allBookings.append(booking);
+        }
+      });
     });
 
-    // Book bookings
-    books.forEachBooking([&](const std::string &resourceId, int start, int end,
-                             const std::string &bookedBy) {
-      if (bookedBy == username) {
-        py::dict booking;
-        booking["type"] = "book";
-        booking["resource_id"] = resourceId;
-        booking["start_time"] = start;
-        booking["end_time"] = end;
-
-        // Add book details
-        Book *book = books.getBook(resourceId);
-        if (book) {
-          booking["title"] = book->getTitle();
-          booking["author"] = book->getAuthor();
-        } else {
-          booking["title"] = "Unknown Title";
-          booking["author"] = "Unknown Author";
-        }
+    return allBookings;
+  }
 
-        allBookings.append(booking);
-      }
+  // Hash table diagnostics - one entry per manager table
+  py::dict getDiagnostics() {
+    py::dict tables;
+    auto addTable = [&](const char *name, const HashMapStats &st) {
+      py::dict info;
+      info["size"] = st.size;
+      info["bucket_count"] = st.bucketCount;
+      info["used_buckets"] = st.usedBuckets;
+      info["load_factor"] = st.loadFactor;
+      info["max_chain_length"] = st.maxChainLength;
+      info["avg_chain_length"] = st.avgChainLength;
+      info["bytes_used"] = st.bytesUsed;
+      py::list histogram;
+      for (int i = 0; i < HashMapStats::HISTOGRAM_BINS; i++)
+        histogram.append(st.chainHistogram[i]);
+      info["chain_histogram"] = histogram;
+      tables[name] = info;
+    };
+
+    engine.inspect([&]() {
+      users.forEachTableStats(addTable);
+      rooms.forEachTableStats(addTable);
+      laptops.forEachTableStats(addTable);
+      books.forEachTableStats(addTable);
     });
+    return tables;
+  }
 
-    return allBookings;
+  // Most-booked resources of one kind ("rooms", "laptops" or "books")
+  // among bookings starting between start and end, most booked first. Any
+  // other kind raises ValueError rather than looking like no demand.
+  py::list getTopDemanded(const std::string &kind, int k, int start,
+                          int end) {
+    if (kind != "rooms" && kind != "laptops" && kind != "books")
+      throw std::invalid_argument("Unknown resource kind '" + kind +
+                                  "'; expected rooms, laptops or books");
+    py::list top;
+    auto add = [&](const std::string &id, int count) {
+      py::dict entry;
+      entry["id"] = id;
+      entry["count"] = count;
+      top.append(entry);
+    };
+
+    engine.inspect([&]() {
+      if (kind == "rooms")
+        rooms.topDemanded(k, start, end, add);
+      else if (kind == "laptops")
+        laptops.topDemanded(k, start, end, add);
+      else
+        books.topDemanded(k, start, end, add);
+    });
+    return top;
   }
 
   // Admin functions
-  void addRoom(const char *roomId) { rooms.addRoomDirect(roomId); }
+  void addRoom(const char *roomId, int capacity, const py::object &floor,
+               const std::string &equipment) {
+    BookingRequest request(BookingRequest::ADD_ROOM, "", roomId);
+    request.room = roomAttributes(capacity, floor, equipment);
+    run(request);
+  }
 
-  void removeRoom(const char *roomId) { rooms.removeRoomDirect(roomId); }
+  // Replace what is known about a room; returns False if there is no such
+  // room
+  bool setRoomAttributes(const char *roomId, int capacity,
+                         const py::object &floor,
+                         const std::string &equipment) {
+    BookingRequest request(BookingRequest::SET_ROOM_ATTRIBUTES, "", roomId);
+    request.room = roomAttributes(capacity, floor, equipment);
+    return run(request).success();
+  }
+
+  void removeRoom(const char *roomId) {
+    run(BookingRequest(BookingRequest::REMOVE_ROOM, "", roomId));
+  }
 
-  void addLaptop(const char *laptopId) { laptops.addLaptopDirect(laptopId); }
+  void addLaptop(const char *laptopId) {
+    run(BookingRequest(BookingRequest::ADD_LAPTOP, "", laptopId));
+  }
 
   void removeLaptop(const char *laptopId) {
-    laptops.removeLaptopDirect(laptopId);
+    run(BookingRequest(BookingRequest::REMOVE_LAPTOP, "", laptopId));
   }
 
-  void addBook(const char *bookId, const char *title, const char *author) {
-    books.addBookDirect(bookId, title, author);
+  void addBook(const char *bookId, const char *title, const char *author,
+               int copies) {
+    BookingRequest request(BookingRequest::ADD_BOOK, "", bookId);
+    request.title = title;
+    request.author = author;
+    request.copies = copies;
+    run(request);
   }
 
-  void removeBook(const char *bookId) { books.removeBookDirect(bookId); }
+  // Returns False if a copy that would be removed is still on loan
+  bool setBookCopies(const char *bookId, int copies) {
+    BookingRequest request(BookingRequest::SET_BOOK_COPIES, "", bookId);
+    request.copies = copies;
+    return run(request).success();
+  }
+
+  // How many copies of a book are free for the whole of [start, end)
+  int getAvailableCopies(const std::string &bookId, int start, int end) {
+    int available = 0;
+    engine.inspect(
+        [&]() { available = books.availableCopies(bookId, start, end); });
+    return available;
+  }
+
+  void removeBook(const char *bookId) {
+    run(BookingRequest(BookingRequest::REMOVE_BOOK, "", bookId));
+  }
+
+  // Add every book of a catalog file (id,title,author[,copies] lines).
+  // Returns how many were added, or -1 if the file cannot be read.
+  int importBooks(const std::string &path) {
+    BookingResult result =
+        run(BookingRequest(BookingRequest::IMPORT_BOOKS, "", path));
+    return result.success() ? result.count : -1;
+  }
 };
 
 PYBIND11_MODULE(library_system, m) {
@@ -293,20 +710,61 @@ PYBIND11_MODULE(library_system, m) {
       .def(py::init<>())
       .def("login", &PyLibraryWrapper::login)
       .def("get_rooms", &PyLibraryWrapper::getRooms)
+      .def("get_room_details", &PyLibraryWrapper::getRoomDetails)
       .def("get_room_bookings", &PyLibraryWrapper::getRoomBookings)
+      .def("get_rooms_availability", &PyLibraryWrapper::getRoomsAvailability,
+           py::arg("start"), py::arg("end"), py::arg("room_id") = "")
       .def("get_laptops", &PyLibraryWrapper::getLaptops)
       .def("get_books", &PyLibraryWrapper::getBooks)
-      .def("search_books", &PyLibraryWrapper::searchBooks)
+      .def("search_books", &PyLibraryWrapper::searchBooks,
+           py::arg("query") = "", py::arg("limit") = 0,
+           py::arg("by_popularity") = true)
+      .def("search_books_available", &PyLibraryWrapper::searchBooksAvailable,
+           py::arg("query"), py::arg("start"), py::arg("end"),
+           py::arg("limit") = 0, py::arg("by_popularity") = true)
+      .def("autocomplete", &PyLibraryWrapper::autocomplete,
+           py::arg("prefix"), py::arg("n") = 10)
+      .def("find_similar_books", &PyLibraryWrapper::findSimilarBooks,
+           py::arg("title"), py::arg("max_distance") = 2, py::arg("k") = 5)
       .def("book_room", &PyLibraryWrapper::bookRoom)
+      .def("book_any_room", &PyLibraryWrapper::bookAnyRoom, py::arg("start"),
+           py::arg("end"), py::arg("username"), py::arg("min_capacity") = 0,
+           py::arg("floor") = py::none(), py::arg("equipment") = "")
+      .def("cancel_room_booking", &PyLibraryWrapper::cancelRoomBooking)
+      .def("find_free_rooms", &PyLibraryWrapper::findFreeRooms,
+           py::arg("start"), py::arg("end"), py::arg("limit") = 0,
+           py::arg("min_capacity") = 0, py::arg("floor") = py::none(),
+           py::arg("equipment") = "")
       .def("borrow_laptop", &PyLibraryWrapper::borrowLaptop)
       .def("borrow_any_laptop", &PyLibraryWrapper::borrowAnyLaptop)
       .def("borrow_book", &PyLibraryWrapper::borrowBook)
+      .def("cancel_book_loan", &PyLibraryWrapper::cancelBookLoan)
+      .def("leave_waitlist", &PyLibraryWrapper::leaveWaitlist)
+      .def("get_waitlist_status", &PyLibraryWrapper::getWaitlistStatus)
       .def("get_user_bookings", &PyLibraryWrapper::getUserBookings)
-      .def("add_room", &PyLibraryWrapper::addRoom)
+      .def("add_room", &PyLibraryWrapper::addRoom, py::arg("room_id"),
+           py::arg("capacity") = 0, py::arg("floor") = py::none(),
+           py::arg("equipment") = "")
+      .def("set_room_attributes", &PyLibraryWrapper::setRoomAttributes,
+           py::arg("room_id"), py::arg("capacity") = 0,
+           py::arg("floor") = py::none(),
+           py::arg("equipment") = "")
       .def("remove_room", &PyLibraryWrapper::removeRoom)
       .def("add_laptop", &PyLibraryWrapper::addLaptop)
       .def("remove_laptop", &PyLibraryWrapper::removeLaptop)
-      .def("add_book", &PyLibraryWrapper::addBook)
+      .def("add_book", &PyLibraryWrapper::addBook, py::arg("book_id"),
+           py::arg("title"), py::arg("author"), py::arg("copies") = 1)
+      .def("set_book_copies", &PyLibraryWrapper::setBookCopies)
+      .def("get_available_copies", &PyLibraryWrapper::getAvailableCopies)
       .def("remove_book", &PyLibraryWrapper::removeBook)
+      .def("import_books", &PyLibraryWrapper::importBooks, py::arg("path"))
+      .def("get_diagnostics", &PyLibraryWrapper::getDiagnostics)
+      .def("get_top_demanded", &PyLibraryWrapper::getTopDemanded,
+           py::arg("kind"), py::arg("k") = 10, py::arg("start") = 0,
+           py::arg("end") = 2147483647)
+      .def("advance_clock", &PyLibraryWrapper::advanceClock)
+      .def("start_clock", &PyLibraryWrapper::startClock,
+           py::arg("interval_seconds") = 60)
+      .def("stop_clock", &PyLibraryWrapper::stopClock)
       .def("save", &PyLibraryWrapper::saveAll);
 }
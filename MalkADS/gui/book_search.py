@@ -17,13 +17,20 @@ try:
 except ImportError:
     LIBRARY_AVAILABLE = False
 
+# Most results fetched per keystroke; the backend stops searching there
+RESULT_LIMIT = 100
+# Title/author completions shown under the search box
+SUGGESTION_LIMIT = 5
+
 
 class BookSearchDialog(ctk.CTkToplevel):
     """Live search dialog for books with real-time filtering"""
     
-    def __init__(self, parent, lib_system=None, on_book_selected=None):
+    def __init__(self, parent, lib_system=None, on_book_selected=None, window=None):
         super().__init__(parent)
         self.on_book_selected = on_book_selected
+        # (start, end) of the loan being planned; results then show free copies
+        self.window = window
         
         # Use the shared library system instance
         self.lib_system = lib_system
@@ -64,7 +71,8 @@ class BookSearchDialog(ctk.CTkToplevel):
         
         StyledLabel(
             search_frame,
-            text="Search by title or author (partial match supported):",
+            text="Search by title or author. Words of 3+ letters match anywhere;\n"
+                 "1-2 letter words match the start of a word:",
             size="body_large"
         ).pack(anchor="w", pady=(0, 5))
         
@@ -82,6 +90,15 @@ class BookSearchDialog(ctk.CTkToplevel):
         )
         self.results_label.pack(anchor="w", pady=(5, 0))
         
+        # Prefix completions for what has been typed so far
+        self.suggestions_label = StyledLabel(
+            search_frame,
+            text="",
+            size="small",
+            text_color=COLORS["accent_blue"]
+        )
+        self.suggestions_label.pack(anchor="w")
+        
         # Results section
         results_container = ctk.CTkFrame(main_frame, fg_color="transparent")
         results_container.pack(expand=True, fill="both", padx=SPACING["md"])
@@ -105,42 +122,67 @@ class BookSearchDialog(ctk.CTkToplevel):
             command=self.destroy
         ).pack(pady=(SPACING["md"], 0))
         
-        # Load and display all books initially
-        self.all_books = self.load_all_books()
-        self.display_books(self.all_books)
+        # Display the start of the catalog initially
+        self.display_books(self.find_books(""))
     
-    def load_all_books(self):
-        """Load all books from the library system"""
+    def find_books(self, query):
+        """Ask the backend's search index for books matching query"""
         if self.lib_system and LIBRARY_AVAILABLE:
             try:
-                return list(self.lib_system.search_books())
+                if self.window:
+                    start, end = self.window
+                    books = [
+                        {"id": book_id, "title": title, "author": author,
+                         "free": free, "copies": copies}
+                        for book_id, title, author, free, copies in
+                        self.lib_system.search_books_available(query, start, end, RESULT_LIMIT)
+                    ]
+                else:
+                    books = list(self.lib_system.search_books(query, RESULT_LIMIT))
+                if not books and query:
+                    # Probably a typo: fall back to the closest titles
+                    books = list(self.lib_system.find_similar_books(query))
+                return books
             except Exception as e:
-                print(f"Error loading books: {e}")
+                print(f"Error searching books: {e}")
                 return []
-        else:
-            # Mock data for development
-            return [
-                {"id": "B0001", "title": "Introduction to Algorithms", "author": "Cormen"},
-                {"id": "B0002", "title": "Data Structures and Algorithms", "author": "Goodrich"},
-                {"id": "B0003", "title": "The Algorithm Design Manual", "author": "Skiena"},
-                {"id": "B0004", "title": "Database System Concepts", "author": "Silberschatz"},
-                {"id": "B0005", "title": "Operating System Concepts", "author": "Silberschatz"},
-            ]
+
+        # Mock data for development, filtered locally
+        query = query.lower()
+        return [
+            book for book in self.mock_books()
+            if query in book["title"].lower() or query in book["author"].lower()
+        ]
+
+    def find_suggestions(self, prefix):
+        """Ask the backend's autocomplete trie for titles and authors"""
+        if not prefix or not (self.lib_system and LIBRARY_AVAILABLE):
+            return []
+        try:
+            return [s["text"] for s in self.lib_system.autocomplete(prefix, SUGGESTION_LIMIT)]
+        except Exception as e:
+            print(f"Error completing '{prefix}': {e}")
+            return []
+
+    @staticmethod
+    def mock_books():
+        """Sample catalog used when the C++ module is not built"""
+        return [
+            {"id": "B0001", "title": "Introduction to Algorithms", "author": "Cormen"},
+            {"id": "B0002", "title": "Data Structures and Algorithms", "author": "Goodrich"},
+            {"id": "B0003", "title": "The Algorithm Design Manual", "author": "Skiena"},
+            {"id": "B0004", "title": "Database System Concepts", "author": "Silberschatz"},
+            {"id": "B0005", "title": "Operating System Concepts", "author": "Silberschatz"},
+        ]
     
     def on_search_changed(self, event=None):
-        """Handle search text change - filter books in real-time"""
-        search_text = self.search_entry.get().lower()
-        
-        if not search_text:
-            # Show all books if search is empty
-            self.display_books(self.all_books)
-        else:
-            # Filter books by partial match in title or author
-            filtered_books = [
-                book for book in self.all_books
-                if search_text in book["title"].lower() or search_text in book["author"].lower()
-            ]
-            self.display_books(filtered_books)
+        """Handle search text change - query the index in real-time"""
+        query = self.search_entry.get().strip()
+        suggestions = self.find_suggestions(query)
+        self.suggestions_label.configure(
+            text="Suggestions: " + " · ".join(suggestions) if suggestions else ""
+        )
+        self.display_books(self.find_books(query))
     
     def display_books(self, books):
         """Display the list of books"""
@@ -152,8 +194,12 @@ class BookSearchDialog(ctk.CTkToplevel):
         count = len(books)
         if count == 0:
             self.results_label.configure(text="No books found")
+        elif "distance" in books[0]:
+            self.results_label.configure(text="No exact match - showing the closest titles")
         elif count == 1:
             self.results_label.configure(text="1 book found")
+        elif count >= RESULT_LIMIT:
+            self.results_label.configure(text=f"Showing the {count} best matches - keep typing to narrow down")
         else:
             self.results_label.configure(text=f"{count} books found")
         
@@ -204,6 +250,17 @@ class BookSearchDialog(ctk.CTkToplevel):
                 text_color=COLORS["text_secondary"]
             )
             author_label.pack(anchor="w", pady=(2, 0))
+
+            # Availability for the chosen window, when the backend reported it
+            if "free" in book:
+                free = book["free"]
+                StyledLabel(
+                    content_frame,
+                    text=f"{free} of {book['copies']} copies free for your dates" if free
+                    else "No copy free for your dates - you can join the waitlist",
+                    size="small",
+                    text_color=COLORS["accent_green"] if free else COLORS["text_secondary"]
+                ).pack(anchor="w", pady=(2, 0))
             
             # Select button if callback provided
             if self.on_book_selected:
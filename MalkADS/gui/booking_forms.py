@@ -271,8 +271,6 @@ class BookingDialog(ctk.CTkToplevel):
         ):
             # Fetch bookings for selected room
             try:
-                bookings = self.lib_system.get_room_bookings(choice)
-
                 # Determine date based on selection
                 import datetime
 
@@ -287,20 +285,24 @@ class BookingDialog(ctk.CTkToplevel):
                 day_start_sec = get_seconds_from_start_of_year_for_date(d, m, y)
                 day_end_sec = day_start_sec + (24 * 3600)
 
-                day_bookings = []
-                for b in bookings:
-                    # Check overlap with the day
-                    b_start = b["start"]
-                    b_end = b["end"]
+                # The backend sweeps the room's bookings for that day into
+                # free gaps; everything between them is booked
+                gaps = self.lib_system.get_rooms_availability(
+                    day_start_sec, day_end_sec, choice
+                ).get(choice, [])
 
-                    if b_end > day_start_sec and b_start < day_end_sec:
+                day_bookings = []
+                busy_from = day_start_sec
+                for gap_start, gap_end in list(gaps) + [(day_end_sec, day_end_sec)]:
+                    if gap_start > busy_from:
                         # Map to minutes 0-1440
-                        start_min = max(0, int((b_start - day_start_sec) / 60))
+                        start_min = int((busy_from - day_start_sec) / 60)
                         end_min = min(
-                            1440, int((b_end - day_start_sec + 59) / 60)
+                            1440, int((gap_start - day_start_sec + 59) / 60)
                         )  # ceilish
 
                         day_bookings.append({"start": start_min, "end": end_min})
+                    busy_from = gap_end
 
                 if hasattr(self.time_slots, "set_blocked_intervals"):
                     # Handle past time visualization
@@ -315,15 +317,22 @@ class BookingDialog(ctk.CTkToplevel):
 
                     self.time_slots.set_blocked_intervals(day_bookings)
                     self.time_slots.set_blocked_intervals(day_bookings)
-                elif hasattr(self.time_slots, "set_booked_slots"):
+                elif hasattr(self.time_slots, "set_free_gaps"):
                     # Fallback if somehow grid is used (shouldn't be)
-                    self.time_slots.set_booked_slots([])
+                    self.time_slots.set_free_gaps(gaps, day_start_sec)
             except Exception as e:
                 print(f"Error fetching bookings: {e}")
 
     def open_book_search(self):
-        """Open the book search dialog"""
-        BookSearchDialog(self, self.lib_system, self.on_book_selected)
+        """Open the book search dialog, showing availability for the chosen dates"""
+        window = None
+        try:
+            start, end = self.time_slots.get_times()
+            if start is not None and end is not None and start < end:
+                window = (start, end)
+        except Exception:
+            pass
+        BookSearchDialog(self, self.lib_system, self.on_book_selected, window)
 
     def on_book_selected(self, book_id, title, author):
         """Callback when a book is selected"""
@@ -467,6 +476,10 @@ class BookingDialog(ctk.CTkToplevel):
                     if hasattr(self.parent, "refresh_bookings"):
                         self.parent.refresh_bookings()
                     self.after(2000, self.destroy)  # Wait a bit longer to read message
+                elif result.get("waitlisted"):
+                    # Request is queued in the backend; no need to retry
+                    self.show_notification(result["message"], "info")
+                    self.after(3000, self.destroy)
                 else:
                     self.show_notification(result["message"], "error")
             else:
@@ -67,6 +67,21 @@ class TimeSlotGrid(ctk.CTkFrame):
         self.selected_start = None
         self.selected_end = None
 
+    def set_free_gaps(self, gaps, day_start):
+        """Mark as booked every hour not wholly inside one of the free gaps
+        from get_rooms_availability ((start, end) seconds pairs for the day
+        starting at day_start)"""
+        booked = []
+        hour = 0
+        for gap_start, gap_end in list(gaps) + [(day_start + 24 * 3600, None)]:
+            first_free = max(hour, -(-(gap_start - day_start) // 3600))
+            if first_free > hour:
+                booked.append({'start': hour, 'end': min(first_free, 24)})
+            if gap_end is None:
+                break
+            hour = max(first_free, (gap_end - day_start) // 3600)
+        self.set_booked_slots(booked)
+
     def handle_click(self, hour):
         """Handle slot click"""
         if hour in self.booked_slots:
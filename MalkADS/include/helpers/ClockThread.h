@@ -0,0 +1,68 @@
+#ifndef MALKADS_CLOCKTHREAD_H
+#define MALKADS_CLOCKTHREAD_H
+
+#include <chrono>
+#include <condition_variable>
+#include <functional>
+#include <mutex>
+#include <thread>
+
+using namespace std;
+
+// Background thread that calls a tick function at a fixed interval, for
+// front ends that do not advance the managers' clocks themselves. The tick
+// runs on the worker thread, so it must take whatever lock guards the
+// managers. stop() wakes the worker immediately instead of waiting out the
+// interval.
+class ClockThread {
+public:
+  ClockThread() : running(false), stopping(false) {}
+
+  ~ClockThread() { stop(); }
+
+  ClockThread(const ClockThread &) = delete;
+  ClockThread &operator=(const ClockThread &) = delete;
+
+  // Returns false if already running
+  bool start(int intervalMs, const function<void()> &tick) {
+    if (running || intervalMs <= 0)
+      return false;
+    stopping = false;
+    running = true;
+    worker = thread([this, intervalMs, tick]() {
+      unique_lock<mutex> lock(m);
+      while (!stopping) {
+        if (cv.wait_for(lock, chrono::milliseconds(intervalMs),
+                        [this]() { return stopping; }))
+          break;
+        lock.unlock();
+        tick();
+        lock.lock();
+      }
+    });
+    return true;
+  }
+
+  void stop() {
+    if (!running)
+      return;
+    {
+      lock_guard<mutex> lock(m);
+      stopping = true;
+    }
+    cv.notify_all();
+    worker.join();
+    running = false;
+  }
+
+  bool isRunning() const { return running; }
+
+private:
+  thread worker;
+  mutex m;
+  condition_variable cv;
+  bool running;
+  bool stopping; // guarded by m
+};
+
+#endif // MALKADS_CLOCKTHREAD_H
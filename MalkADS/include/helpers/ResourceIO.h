@@ -58,8 +58,9 @@ void saveResourceIDsToFile(const string &path, const MapType &table) {
       });
 }
 
-template <typename MapType>
-void loadBookingsFromFile(const string &path, MapType &table) {
+// onLoaded(id, start, end, username) is called for every booking inserted
+template <typename MapType, typename Func>
+void loadBookingsFromFile(const string &path, MapType &table, Func onLoaded) {
   std::ifstream file(path);
   if (!file)
     return;
@@ -93,9 +94,16 @@ void loadBookingsFromFile(const string &path, MapType &table) {
 
     RedBlackIntervalTree *tree = *treePtr;
     tree->insert(start, end, user);
+    onLoaded(id, start, end, user);
   }
 }
 
+template <typename MapType>
+void loadBookingsFromFile(const string &path, MapType &table) {
+  loadBookingsFromFile(path, table,
+                       [](const string &, int, int, const string &) {});
+}
+
 template <typename MapType>
 void saveBookingsToFile(const string &path, const MapType &table) {
   ofstream file(path, ios::out | ios::trunc);
@@ -209,6 +217,24 @@ inline time_t getStartOfYearTimestamp() {
   return mktime(&ref);
 }
 
+// Current time in the same unit as booking intervals: seconds since the
+// start of the simulation year
+inline long long getCurrentSeconds() {
+  return static_cast<long long>(
+      difftime(time(nullptr), getStartOfYearTimestamp()));
+}
+
+// Midnight at the start of today, in seconds since the start of the year
+inline long long getStartOfTodaySeconds() {
+  time_t now = time(nullptr);
+  tm today = *localtime(&now);
+  today.tm_hour = 0;
+  today.tm_min = 0;
+  today.tm_sec = 0;
+  return static_cast<long long>(
+      difftime(mktime(&today), getStartOfYearTimestamp()));
+}
+
 inline string formatTimestamp(long long offsetSeconds) {
   time_t refStamp = getStartOfYearTimestamp();
   time_t targetStamp = refStamp + offsetSeconds;
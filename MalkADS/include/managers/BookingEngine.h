@@ -0,0 +1,180 @@
+#ifndef MALKADS_BOOKINGENGINE_H
+#define MALKADS_BOOKINGENGINE_H
+
+#include <atomic>
+#include <condition_variable>
+#include <future>
+#include <mutex>
+#include <string>
+#include <thread>
+
+#include "../structures/ring_buffer.h"
+#include "BooksManager.h"
+#include "LaptopsManager.h"
+#include "RoomsManager.h"
+#include "UsersManager.h"
+
+using namespace std;
+
+// One mutation for the engine to apply
+struct BookingRequest {
+  enum Kind {
+    BOOK_ROOM,
+    BOOK_ANY_ROOM, // resourceId is ignored; room is what it must offer
+    CANCEL_ROOM_BOOKING,
+    BORROW_LAPTOP,
+    BORROW_ANY_LAPTOP, // resourceId is ignored
+    BORROW_BOOK,       // joins the waitlist if the book is on loan
+    CANCEL_BOOK_LOAN,
+    LEAVE_WAITLIST,
+    ADVANCE_CLOCK, // uses now
+    ADD_ROOM,      // uses room
+    REMOVE_ROOM,
+    SET_ROOM_ATTRIBUTES, // uses room
+    ADD_LAPTOP,
+    REMOVE_LAPTOP,
+    ADD_BOOK, // uses title, author and copies
+    REMOVE_BOOK,
+    SET_BOOK_COPIES, // uses copies
+    IMPORT_BOOKS     // resourceId is the catalog file
+  };
+
+  Kind kind;
+  string username;
+  string resourceId;
+  string title;
+  string author;
+  int start;
+  int end;
+  long long now;
+  int copies;
+  RoomAttributes room;
+
+  BookingRequest()
+      : kind(ADVANCE_CLOCK), start(0), end(0), now(0), copies(1) {}
+
+  BookingRequest(Kind k, const string &user, const string &id, int s = 0,
+                 int e = 0)
+      : kind(k), username(user), resourceId(id), start(s), end(e), now(0),
+        copies(1) {}
+};
+
+struct BookingResult {
+  enum Status {
+    OK,
+    UNKNOWN_USER,
+    REJECTED,      // conflict, unknown resource or per-user limit
+    LIMIT_REACHED, // BORROW_ANY_LAPTOP / BOOK_ANY_ROOM: user already has
+                   // one then
+    WAITLISTED     // BORROW_BOOK: queued at position
+  };
+
+  Status status;
+  string resourceId; // the laptop or room assigned by BORROW_ANY_LAPTOP or
+                     // BOOK_ANY_ROOM
+  int position;      // waitlist position when WAITLISTED
+  int count;         // requests lapsed by ADVANCE_CLOCK, books added by
+                     // IMPORT_BOOKS
+  int copy;          // the copy lent by BORROW_BOOK, -1 otherwise
+
+  BookingResult() : status(REJECTED), position(0), count(0), copy(-1) {}
+
+  bool success() const { return status == OK; }
+};
+
+// Single writer for the managers.
+//
+// Front ends submit BookingRequests from any thread; they go through a
+// bounded MPSC ring buffer to one engine thread, which drains them in
+// batches, applies each batch in submission order, saves the files the
+// batch touched once, and only then completes the callers' futures. N
+// concurrent bookings cost one rewrite of each affected file instead of N,
+// and the managers themselves need no locks.
+//
+// While the engine runs, the managers must only be changed through
+// submit(). Reads go through inspect(), which runs between batches.
+// submit() must not race with stop().
+class BookingEngine {
+public:
+  static const int MAX_BATCH = 64;
+
+  BookingEngine(UsersManager &users, RoomsManager &rooms,
+                LaptopsManager &laptops, BooksManager &books,
+                int queueCapacity = 1024);
+
+  ~BookingEngine();
+
+  BookingEngine(const BookingEngine &) = delete;
+  BookingEngine &operator=(const BookingEngine &) = delete;
+
+  // Start the engine thread. Returns false if already running.
+  bool start();
+
+  // Apply everything already submitted, then stop the engine thread
+  void stop();
+
+  bool isRunning() const { return running.load(); }
+
+  // Queue a request. Blocks only while the queue is full. If the engine is
+  // not running the request is applied and saved on the calling thread.
+  future<BookingResult> submit(const BookingRequest &request);
+
+  // submit() and wait for the result. Rethrows if applying the request or
+  // saving its batch threw.
+  BookingResult execute(const BookingRequest &request) {
+    return submit(request).get();
+  }
+
+  // Run func with no batch in progress, for reading the managers
+  template <typename Func> void inspect(Func func) {
+    lock_guard<mutex> lock(applyMutex);
+    func();
+  }
+
+  long long requestsApplied() const { return requestCount.load(); }
+  long long batchesApplied() const { return batchCount.load(); }
+  long long flushes() const { return flushCount.load(); }
+
+private:
+  struct Job {
+    BookingRequest request;
+    promise<BookingResult> result;
+  };
+
+  // Which managers' files a batch has to rewrite
+  enum Dirty { ROOMS_DIRTY = 1, LAPTOPS_DIRTY = 2, BOOKS_DIRTY = 4 };
+
+  UsersManager &users;
+  RoomsManager &rooms;
+  LaptopsManager &laptops;
+  BooksManager &books;
+
+  MpscRingBuffer<Job> queue;
+  thread worker;
+  // Held while a batch is applied and saved, and by inspect()
+  mutex applyMutex;
+
+  // Lets the engine sleep while the queue is empty
+  mutex wakeMutex;
+  condition_variable wakeCv;
+  atomic<bool> sleeping;
+  atomic<bool> stopping;
+  atomic<bool> running;
+
+  atomic<long long> requestCount;
+  atomic<long long> batchCount;
+  atomic<long long> flushCount;
+
+  void workerLoop();
+
+  void wake();
+
+  // Apply, flush, then complete the jobs' futures
+  void runBatch(Job *jobs, int n);
+
+  BookingResult apply(const BookingRequest &request, unsigned &dirty);
+
+  void flush(unsigned dirty);
+};
+
+#endif // MALKADS_BOOKINGENGINE_H
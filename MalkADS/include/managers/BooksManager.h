@@ -1,32 +1,147 @@
 #ifndef BOOKS_H
 #define BOOKS_H
 
+#include <cctype>
 #include <string>
 
 #include "../helpers/ResourceIO.h"
 #include "../models/book.h"
 #include "../models/user.h"
+#include "../models/waitlist_request.h"
 #include "../structures/IntervalTreeComplete.h"
+#include "../structures/copy_pool.h"
+#include "../structures/demand_index.h"
+#include "../structures/fuzzy_index.h"
 #include "../structures/hash_map.h"
-#include "../structures/linked_list.h"
+#include "../structures/posting_list.h"
+#include "../structures/radix_trie.h"
+#include "../structures/string_arena.h"
+#include "../structures/text_index.h"
+#include "../structures/timing_wheel.h"
+#include "../structures/top_k.h"
 #include "UsersManager.h"
 
 using namespace std;
 
+// One scored search hit
+struct RankedMatch {
+  double score;
+  int catalogId;
+  StringRef title;
+
+  RankedMatch() : score(0), catalogId(-1) {}
+  RankedMatch(double s, int id, StringRef t)
+      : score(s), catalogId(id), title(t) {}
+};
+
+// Higher score first, then alphabetical by title
+struct MatchRanking {
+  bool operator()(const RankedMatch &a, const RankedMatch &b) const {
+    if (a.score != b.score)
+      return a.score > b.score;
+    return a.title < b.title;
+  }
+};
+
 class BooksManager {
 private:
-  // Data Structure Change
-  HashMap<string, Book> ID_To_BookTable;
-  // Data Structure Change
-  HashMap<string, RedBlackIntervalTree *> BookTable;
-  // Secondary Index for O(1) Author Search
-  HashMap<string, LinkedList<string> *> Author_To_BooksTable;
+  // Every book's ID and title, and each distinct author once. Books and
+  // the tables below hold StringRefs into it, so each string is stored a
+  // single time however many indexes use it.
+  StringArena strings;
+  StringInterner authors{strings};
+
+  // Primary index: book ID -> Book
+  HashMap<StringRef, Book> ID_To_BookTable;
+  // Secondary index: title (any case) -> book ID
+  HashMap<StringRef, StringRef, CaseInsensitiveHash, CaseInsensitiveEqual>
+      Title_To_IDTable;
+  // Book ID -> loans of each of its copies
+  HashMap<StringRef, CopyPool *> BookTable;
+  // Secondary Index for O(1) Author Search: author (any case) to the
+  // catalog IDs of their books. Each Book remembers its position in the
+  // list, so removing a book is O(1) however many books the author has.
+  HashMap<StringRef, PostingList *, CaseInsensitiveHash, CaseInsensitiveEqual>
+      Author_To_BooksTable;
+  // Compact catalog ID -> book (nullptr for freed IDs, which are reused).
+  // The books' strings are also kept column by column, so scans of the
+  // whole catalog read flat arrays instead of visiting every Book.
+  Book **catalog = nullptr;
+  StringRef *catalogIds = nullptr;
+  StringRef *catalogTitles = nullptr;
+  StringRef *catalogAuthors = nullptr;
+  // All-time loans by catalog ID (demand.total of the book), so ranking
+  // reads a number instead of building an ID string per match
+  long long *catalogLoans = nullptr;
+  int catalogCapacity = 0;
+  int catalogEnd = 0;
+  PostingList freeCatalogIds;
+  // Title and author words and trigrams, by catalog ID, for partial search
+  TextIndex searchIndex;
+  // Normalized titles and authors for prefix completion. An author's weight
+  // is their number of books, so prolific authors are suggested first.
+  RadixTrie completions{AUTOCOMPLETE_LIMIT};
+  // Titles by catalog ID, for near-miss lookups
+  FuzzyIndex titleMatcher;
+  // Per-book queue of borrow requests waiting for the book to free up
+  HashMap<string, BookWaitlist *> waitlistTable;
+  // Loans per book per day, for demand statistics
+  DemandIndex demand;
+  int nextWaitlistSeq = 0;
+  // Expires waitlisted requests whose window started before they were
+  // allocated. Ticks are seconds since the start of the year.
+  TimingWheel<WaitlistLapse> waitlistTimers;
 
-  void loadBooksFromFile(); // read book IDs from "books.txt" and create
-                            // interval tree
+  // A repeat borrower's request is ordered as if made this much later
+  static constexpr long long REPEAT_BORROWER_PENALTY = 3 * 24 * 3600;
+
+  void loadBooksFromFile(); // import "books.txt" (see importBooksFromFile)
 
   void loadBookBookingsFromFile();
 
+  void loadWaitlistsFromFile();
+
+  // Add a book to the primary and secondary indexes and give its copies
+  // empty loan trees. Fails if the ID or the title is already taken.
+  bool insertBook(const string &bookId, const string &title,
+                  const string &author, int copies = 1);
+
+  // Copy a title into the arena in display form (Book::formatTitle)
+  StringRef storeTitle(StringRef title);
+
+  // Case-insensitive exact title lookup
+  Book *findBookByTitle(const string &title);
+
+  // findBookByTitle for the CLI: on a miss, offers the closest titles and
+  // lets the user pick one. nullptr if nothing was chosen.
+  Book *findBookByTitleInteractive(const string &title);
+
+  // Give a stored book a catalog ID and add it to its author's list
+  void indexBook(Book *book);
+
+  // The parts of indexBook that importBooksFromFile runs on their own
+  int assignCatalogId(Book *book);
+  void indexAuthor(Book *book);
+
+  // Undo indexBook before the book is erased
+  void unindexBook(Book *book);
+
+  // demand.record, keeping catalogLoans in step
+  void recordLoan(const string &bookId, long long start, int delta = 1);
+
+  // Queue a request and arm its lapse timer
+  bool enqueueWaitlistRequest(const string &bookId, WaitlistRequest &req);
+
+  // Delete a book's waitlist along with its pending timers
+  void dropWaitlist(const string &bookId);
+
+  static bool hasBorrowedBefore(const CopyPool *pool,
+                                const string &username);
+
+  // Score every match of query and offer it to best
+  void rankMatches(const string &query, bool byPopularity,
+                   TopK<RankedMatch, MatchRanking> &best) const;
+
 public:
   BooksManager();
 
@@ -34,16 +149,32 @@ public:
 
   void BorrowBook(User *user);
 
-  // Non-interactive version for Python API
+  // Non-interactive version for Python API. Lends whichever copy is free
+  // for the period and stores its index in assignedCopy if given.
   bool borrowBookDirect(User *user, const string &bookId, int startTime,
-                        int endTime);
+                        int endTime, int *assignedCopy = nullptr);
 
   // admin operations
   void addBookInteractive();
 
   // Non-interactive version for Python API
   bool addBookDirect(const string &bookId, const string &title,
-                     const string &author);
+                     const string &author, int copies = 1);
+
+  // Add every book of a catalog file in the books.txt format
+  // (id,title,author[,copies] per line). The file is read in one go, its
+  // lines are parsed on up to threads threads (0: one per core), and the
+  // indexes are then built side by side. A line is skipped if it is
+  // malformed or an earlier line or existing book has its ID or title.
+  // Returns the number of books added, or -1 if the file cannot be read.
+  int importBooksFromFile(const string &path, int threads = 0);
+
+  // Change how many copies of a book there are. Fails for unknown books,
+  // copies < 1, or if a copy that would go still has loans.
+  bool setBookCopies(const string &bookId, int copies);
+
+  // Copies of a book free for the whole of [startTime, endTime)
+  int availableCopies(StringRef bookId, int startTime, int endTime) const;
 
   void removeBookInteractive();
 
@@ -53,9 +184,40 @@ public:
   // Get book details
   Book *getBook(const string &bookId);
 
+  // Waitlist: queue a request for a book that is on loan during
+  // [startTime, endTime]. Fails if the book is free (borrow it instead),
+  // unknown, or the user is already waiting for it.
+  bool joinWaitlist(User *user, const string &bookId, int startTime,
+                    int endTime);
+
+  // Withdraw the user's waiting request for a book
+  bool leaveWaitlist(User *user, const string &bookId);
+
+  // 1-based position of username in the book's waitlist, 0 if not waiting
+  int waitlistPosition(const string &bookId, const string &username) const;
+
+  int waitlistSize(const string &bookId) const;
+
+  // Allocate the book to waiting requests from the head of its queue while
+  // they fit. Returns the number of requests allocated.
+  int promoteWaitlist(const string &bookId);
+
+  // Cancel (or return early) a loan and hand the book to the waitlist
+  bool cancelBookLoanDirect(User *user, const string &bookId, int startTime,
+                            int endTime);
+
+  // Move the manager's clock to now (seconds since the start of the year)
+  // and run what came due: waitlisted requests whose window has started are
+  // dropped and the next ones promoted. Returns the number of requests
+  // that lapsed.
+  int advanceClock(long long now);
+
+  int pendingTimers() const { return waitlistTimers.size(); }
+
   // Save methods - made public for Python access
   void saveBooksToFile();
   void saveBookBookingsToFile() const;
+  void saveWaitlistsToFile() const;
 
   void showUserBookings(const std::string &username) const;
 
@@ -63,27 +225,171 @@ public:
 
   // Iterator for Python bindings
   template <typename Func> void forEachBooking(Func func) {
-    BookTable.forEach([&](const string &bookId, RedBlackIntervalTree *&tree) {
-      if (!tree)
+    BookTable.forEach([&](const StringRef &bookId, CopyPool *&pool) {
+      if (!pool)
         return;
-      tree->forEachInterval([&](int low, int high, const string &username) {
-        func(bookId, low, high, username);
-      });
+      const string id = bookId.str();
+      pool->forEachLoan(
+          [&](int, int low, int high, const string &username) {
+            func(id, low, high, username);
+          });
     });
   }
 
-  // Get list of all resource IDs
-  template <typename Func> void forEachBook(Func func) {
-    ID_To_BookTable.forEach(
-        [&](const string &bookId, Book &book) { func(bookId); });
+  // The k books with the most bookings starting on the days covered by
+  // [from, to] (seconds since the start of the year). Calls func(id, count)
+  // from most to least booked; returns the number reported.
+  template <typename Func>
+  int topDemanded(int k, long long from, long long to, Func func) const {
+    return demand.topK(k, from, to, func);
+  }
+
+  // Diagnostics - callback receives (tableName, HashMapStats)
+  template <typename Func> void forEachTableStats(Func func) const {
+    func("ID_To_BookTable", ID_To_BookTable.stats());
+    func("Title_To_IDTable", Title_To_IDTable.stats());
+    func("BookTable", BookTable.stats());
+    func("Author_To_BooksTable", Author_To_BooksTable.stats());
+  }
+
+  // Get list of all resource IDs, as func(StringRef)
+  template <typename Func> void forEachBook(Func func) const {
+    for (int i = 0; i < catalogEnd; i++)
+      if (catalog[i])
+        func(catalogIds[i]);
+  }
+
+  // Books by an author (case-insensitive exact match), in no particular
+  // order. Calls func(Book&) for each and returns how many there were.
+  template <typename Func>
+  int forEachBookByAuthor(const string &author, Func func) {
+    PostingList **listPtr = Author_To_BooksTable.get(author);
+    if (!listPtr || !(*listPtr))
+      return 0;
+    (*listPtr)->forEach([&](int catalogId) { func(*catalog[catalogId]); });
+    return (*listPtr)->size();
+  }
+
+  // Books whose title or author matches every word of query: words of 3+
+  // characters anywhere (substring), shorter ones at the start of a word.
+  // Calls func(Book&) for at most limit books (limit <= 0: all) and
+  // returns how many were reported.
+  template <typename Func>
+  int searchBooks(const string &query, int limit, Func func) {
+    return searchIndex.search(query, limit, [&](int catalogId) {
+      func(*catalog[catalogId]);
+    });
   }
 
-  // Get all book details (ID, title, author) for search
-  template <typename Func> void forEachBookWithDetails(Func func) {
-    ID_To_BookTable.forEach([&](const string &bookId, Book &book) {
-      func(book.getID(), book.getTitle(), book.getAuthor());
+  // Weights of searchBooksRanked's score: every occurrence of a query word
+  // counts its field's weight, plus the bonus again if it starts a word
+  static constexpr int TITLE_TERM_WEIGHT = 3;
+  static constexpr int AUTHOR_TERM_WEIGHT = 1;
+  static constexpr int WORD_START_BONUS = 2;
+
+  // The k best books matching query (by searchBooks' rules), best first,
+  // as func(Book&, score). byPopularity adds log2(1 + all-time loans) to
+  // the score. Costs O(m log k) for m matches; returns the number reported.
+  template <typename Func>
+  int searchBooksRanked(const string &query, int k, bool byPopularity,
+                        Func func) {
+    TopK<RankedMatch, MatchRanking> best(k);
+    rankMatches(query, byPopularity, best);
+    int reported = 0;
+    best.drain([&](RankedMatch &match) {
+      func(*catalog[match.catalogId], match.score);
+      reported++;
     });
+    return reported;
+  }
+
+  // searchBooksRanked, also telling how many copies of each book are free
+  // for the whole of [startTime, endTime): func(Book&, score, freeCopies,
+  // copies). The checks run as the results are reported, so a caller gets
+  // the matches and their availability in one pass.
+  template <typename Func>
+  int searchBooksAvailable(const string &query, int startTime, int endTime,
+                           int k, bool byPopularity, Func func) {
+    return searchBooksRanked(
+        query, k, byPopularity, [&](Book &book, double score) {
+          CopyPool **poolPtr = BookTable.get(book.idRef());
+          if (poolPtr && *poolPtr)
+            func(book, score, (*poolPtr)->freeCount(startTime, endTime),
+                 (*poolPtr)->copies());
+          else
+            func(book, score, 0, book.getCopies());
+        });
+  }
+
+  // The first limit books of the catalog (limit <= 0: all) in catalog
+  // order, with their free copies for [startTime, endTime), as
+  // func(Book&, freeCopies, copies). Each book's pool is found once, and
+  // the walk stops at limit. Returns the number listed.
+  template <typename Func>
+  int listBooksAvailable(int startTime, int endTime, int limit, Func func) {
+    int listed = 0;
+    for (int i = 0; i < catalogEnd && (limit <= 0 || listed < limit); i++) {
+      if (!catalog[i])
+        continue;
+      CopyPool **poolPtr = BookTable.get(catalogIds[i]);
+      if (poolPtr && *poolPtr)
+        func(*catalog[i], (*poolPtr)->freeCount(startTime, endTime),
+             (*poolPtr)->copies());
+      else
+        func(*catalog[i], 0, catalog[i]->getCopies());
+      listed++;
+    }
+    return listed;
+  }
+
+  // Edits tolerated by the CLI's "did you mean" suggestions
+  static constexpr int TITLE_TYPO_DISTANCE = 2;
+
+  // Up to k books whose title is within maxDistance edits (insertions,
+  // deletions, substitutions) of title, ignoring case and punctuation.
+  // Calls func(Book&, distance) closest first and returns how many were
+  // reported.
+  template <typename Func>
+  int findSimilarTitles(const string &title, int maxDistance, int k,
+                        Func func) const {
+    return titleMatcher.search(title, maxDistance, k,
+                               [&](int catalogId, int distance) {
+                                 func(*catalog[catalogId], distance);
+                               });
+  }
+
+  // Most completions autocomplete() can return for one prefix
+  static constexpr int AUTOCOMPLETE_LIMIT = 10;
+
+  // Up to n titles and authors (n is capped at AUTOCOMPLETE_LIMIT) that
+  // start with prefix, ignoring case and punctuation. Calls
+  // func(text, bookCount) best first and returns how many were reported.
+  template <typename Func>
+  int autocomplete(const string &prefix, int n, Func func) const {
+    const string key = TextIndex::normalize(prefix);
+    if (key.empty())
+      return 0;
+    return completions.complete(key, n, func);
   }
+
+  // Get book details for search, as func(id, title, author) with
+  // StringRefs into the catalog: nothing is copied or allocated. Stops
+  // after limit books (limit <= 0: all); returns the number listed.
+  template <typename Func>
+  int forEachBookWithDetails(Func func, int limit = 0) const {
+    int listed = 0;
+    for (int i = 0; i < catalogEnd && (limit <= 0 || listed < limit); i++)
+      if (catalog[i]) {
+        func(catalogIds[i], catalogTitles[i], catalogAuthors[i]);
+        listed++;
+      }
+    return listed;
+  }
+
+  // Bytes of book and author strings stored, and of arena blocks holding
+  // them
+  size_t stringBytesStored() const { return strings.bytesStored(); }
+  size_t stringBytesReserved() const { return strings.bytesReserved(); }
 };
 
 #endif
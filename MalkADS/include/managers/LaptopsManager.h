@@ -6,6 +6,7 @@
 #include "../helpers/ResourceIO.h"
 #include "../models/user.h"
 #include "../structures/IntervalTreeComplete.h"
+#include "../structures/demand_index.h"
 #include "../structures/hash_map.h"
 #include "UsersManager.h"
 
@@ -15,10 +16,12 @@ class LaptopsManager {
 private:
   // Data Structure Change
   HashMap<string, RedBlackIntervalTree *> laptopTable;
+  // Bookings per laptop per day, for demand statistics
+  DemandIndex demand;
 
   void loadLaptopsFromFile(); // read laptop IDs from "laptop.txt"
 
-  void loadLaptopBookingsFromFile() const;
+  void loadLaptopBookingsFromFile();
 
 public:
   LaptopsManager();
@@ -62,6 +65,19 @@ public:
         });
   }
 
+  // The k laptops with the most bookings starting on the days covered by
+  // [from, to] (seconds since the start of the year). Calls func(id, count)
+  // from most to least booked; returns the number reported.
+  template <typename Func>
+  int topDemanded(int k, long long from, long long to, Func func) const {
+    return demand.topK(k, from, to, func);
+  }
+
+  // Diagnostics - callback receives (tableName, HashMapStats)
+  template <typename Func> void forEachTableStats(Func func) const {
+    func("laptopTable", laptopTable.stats());
+  }
+
   // Get list of all laptop IDs
   template <typename Func> void forEachLaptop(Func func) {
     laptopTable.forEach([&](const string &laptopId,
@@ -4,9 +4,14 @@
 #include <string>
 
 #include "../helpers/ResourceIO.h"
+#include "../models/room.h"
 #include "../models/user.h"
 #include "../structures/IntervalTreeComplete.h"
+#include "../structures/attribute_index.h"
+#include "../structures/demand_index.h"
+#include "../structures/free_slot_index.h"
 #include "../structures/hash_map.h"
+#include "../structures/posting_list.h"
 #include "UsersManager.h"
 
 using namespace std;
@@ -15,25 +20,72 @@ class RoomsManager {
 private:
   // Data Structure Change
   HashMap<string, RedBlackIntervalTree *> roomTable;
-
-  void
-  loadRoomsFromFile(); // read room IDs from rooms.txt and create interval trees
-
-  void loadRoomBookingsFromFile() const;
-
-  struct SimpleInterval {
-    int start;
-    int end;
+  // Bookings per room per day, for demand statistics
+  DemandIndex demand;
+
+  // Rooms are also numbered 0, 1, 2, ... for the free-room index. Numbers
+  // of removed rooms are reused.
+  struct NumberedRoom {
+    string id; // empty if the number is unused
+    RedBlackIntervalTree *tree;
+    RoomAttributes attributes;
   };
-
-  static constexpr int MAX_INTERVALS = 64;
-
-  static int collectBookedIntervals(RedBlackIntervalTree *tree,
-                                    SimpleInterval *arr, int maxCount);
-
-  static void sortIntervals(SimpleInterval *arr, int n);
-
-  static int mergeIntervals(SimpleInterval *arr, int n);
+  HashMap<string, int> roomNumbers;
+  NumberedRoom *numberedRooms = nullptr;
+  int numberedCapacity = 0;
+  int numberedEnd = 0;
+  PostingList freeRoomNumbers;
+
+  // Rooms free in each quarter hour of today and tomorrow, the days rooms
+  // can be booked for. Rebuilt from the trees when the day changes.
+  static constexpr int FREE_SLOT_SECONDS = 15 * 60;
+  static constexpr int FREE_SLOT_COUNT = 2 * 24 * 4;
+  FreeSlotIndex freeRooms{FREE_SLOT_SECONDS, FREE_SLOT_COUNT};
+  // Rooms by equipment, floor and capacity, by room number
+  AttributeIndex roomAttributes;
+
+  // Read rooms.txt (IDs and attributes) and create interval trees
+  void loadRoomsFromFile();
+
+  void loadRoomBookingsFromFile();
+
+  void numberRoom(const string &roomId, RedBlackIntervalTree *tree,
+                  const RoomAttributes &attributes);
+  void unnumberRoom(const string &roomId);
+
+  // Move the free-room index to today if the day has changed
+  void refreshFreeRooms();
+
+  // Keep the free-room index in step with a room's bookings
+  void indexBooking(const string &roomId, int startTime, int endTime);
+  void unindexBooking(const string &roomId, int startTime, int endTime);
+
+  // Numbers of up to limit rooms (limit <= 0: all) that offer need and
+  // are free for the whole of [startTime, endTime), in number order
+  int freeRoomNumbersFor(int startTime, int endTime, const RoomAttributes &need,
+                         int limit, PostingList &found);
+
+  // Rooms can be booked from now until the end of tomorrow, for at most
+  // three hours at a time
+  static bool isBookableWindow(int startTime, int endTime);
+
+  // func(gapStart, gapEnd) for each free gap of tree in [windowStart,
+  // windowEnd). The bookings overlapping the window arrive sorted by start,
+  // so overlapping and touching ones merge in one pass as they stream by.
+  template <typename Func>
+  static void sweepFreeGaps(RedBlackIntervalTree *tree, int windowStart,
+                            int windowEnd, Func func) {
+    int freeFrom = windowStart;
+    tree->forEachOverlap(windowStart, windowEnd,
+                         [&](int low, int high, const string &) {
+                           if (low > freeFrom)
+                             func(freeFrom, low);
+                           if (high > freeFrom)
+                             freeFrom = high;
+                         });
+    if (freeFrom < windowEnd)
+      func(freeFrom, windowEnd);
+  }
 
 public:
   RoomsManager();
@@ -46,11 +98,54 @@ public:
   bool bookRoomDirect(User *user, const string &roomId, int startTime,
                       int endTime);
 
+  // Book whichever room offering need is free for [startTime, endTime),
+  // the first in room order. Fails if the user already has a room then or
+  // none is free. The room booked is stored in *bookedRoom.
+  bool bookAnyRoom(User *user, int startTime, int endTime,
+                   string *bookedRoom = nullptr,
+                   const RoomAttributes &need = RoomAttributes());
+
+  // Cancel the user's booking of roomId for exactly [startTime, endTime]
+  bool cancelRoomBookingDirect(User *user, const string &roomId,
+                               int startTime, int endTime);
+
+  // Up to limit rooms (limit <= 0: all) free for the whole of
+  // [startTime, endTime), as func(roomId). Inside today and tomorrow the
+  // answer comes from the free-room index: the sets of free rooms of the
+  // quarter hours the window covers are intersected, a word of 64 rooms
+  // at a time, and only rooms busy in a partly covered quarter hour are
+  // checked against their bookings. Returns the number reported.
+  template <typename Func>
+  int findFreeRooms(int startTime, int endTime, int limit, Func func) {
+    return findFreeRooms(startTime, endTime, RoomAttributes(), limit, func);
+  }
+
+  // The same, only for rooms with at least need.capacity seats, on
+  // need.floor (any if UNKNOWN_FLOOR) and with all of need.equipment. The
+  // attribute index narrows the free rooms before any of them is reported.
+  template <typename Func>
+  int findFreeRooms(int startTime, int endTime, const RoomAttributes &need,
+                    int limit, Func func) {
+    PostingList found;
+    freeRoomNumbersFor(startTime, endTime, need, limit, found);
+    found.forEach([&](int number) { func(numberedRooms[number].id); });
+    return found.size();
+  }
+
   // admin operations
   void addRoomInteractive();
 
   // Non-interactive version for Python API
-  bool addRoomDirect(const string &roomId);
+  bool addRoomDirect(const string &roomId,
+                     const RoomAttributes &attributes = RoomAttributes());
+
+  // Replace what is known about a room; false for unknown rooms
+  bool setRoomAttributes(const string &roomId,
+                         const RoomAttributes &attributes);
+
+  // What a room offers; false for unknown rooms
+  bool getRoomAttributes(const string &roomId,
+                         RoomAttributes &attributes) const;
 
   void removeRoomInteractive();
 
@@ -65,6 +160,21 @@ public:
 
   void showRoomsWithAvailableTimes(int openStart, int openEnd);
 
+  // Free time of a room within [windowStart, windowEnd): func(gapStart,
+  // gapEnd) for each gap between its bookings, in time order. Touches only
+  // the bookings that overlap the window, however many the room has.
+  // Returns false for unknown rooms.
+  template <typename Func>
+  bool forEachFreeGap(const string &roomId, int windowStart, int windowEnd,
+                      Func func) const {
+    RedBlackIntervalTree **treePtr = roomTable.get(roomId);
+    if (!treePtr || !(*treePtr))
+      return false;
+    if (windowStart < windowEnd)
+      sweepFreeGaps(*treePtr, windowStart, windowEnd, func);
+    return true;
+  }
+
   void syncUserBookings(UsersManager &usersManager);
 
   // Iterator for Python bindings - callback receives (roomId, start, end,
@@ -79,6 +189,13 @@ public:
     });
   }
 
+  // func(roomId, attributes) for every room, in room order
+  template <typename Func> void forEachRoomWithAttributes(Func func) const {
+    for (int r = 0; r < numberedEnd; r++)
+      if (numberedRooms[r].tree)
+        func(numberedRooms[r].id, numberedRooms[r].attributes);
+  }
+
   // Iterator for all rooms
   template <typename Func> void forEachRoom(Func func) {
     roomTable.forEach([&](const string &roomId, RedBlackIntervalTree *&tree) {
@@ -86,6 +203,19 @@ public:
     });
   }
 
+  // The k rooms with the most bookings starting on the days covered by
+  // [from, to] (seconds since the start of the year). Calls func(id, count)
+  // from most to least booked; returns the number reported.
+  template <typename Func>
+  int topDemanded(int k, long long from, long long to, Func func) const {
+    return demand.topK(k, from, to, func);
+  }
+
+  // Diagnostics - callback receives (tableName, HashMapStats)
+  template <typename Func> void forEachTableStats(Func func) const {
+    func("roomTable", roomTable.stats());
+  }
+
   // Get bookings for specific room
   template <typename Func>
   void getRoomBookings(const string &roomId, Func func) {
@@ -28,6 +28,11 @@ public:
   }
 
   // Checks entered username and password against hashmap
+
+  // Diagnostics - callback receives (tableName, HashMapStats)
+  template <typename Func> void forEachTableStats(Func func) const {
+    func("userTable", userTable.stats());
+  }
 };
 
 #endif
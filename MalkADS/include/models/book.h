@@ -1,24 +1,57 @@
 #ifndef BOOK_H
 #define BOOK_H
 #include <string>
+
+#include "../structures/string_arena.h"
 using namespace std;
 
 class Book {
 private:
-  string bookid;
-  string title;
-  string author;
+  // Views of strings owned by BooksManager's arena
+  StringRef bookid;
+  StringRef title; // as displayed: each word capitalized
+  StringRef author;
+  // Compact catalog ID assigned by BooksManager, -1 until indexed
+  int catalogId;
+  // Position of catalogId in the author's posting list
+  int authorPos;
+  // Physical copies that can be lent out at the same time
+  int copies;
 
 public:
   Book();
 
-  Book(const string &bookid, const string &title, const string &author);
+  // The strings are not copied, so they must outlive the book
+  Book(StringRef bookid, StringRef title, StringRef author, int copies = 1);
+
+  string getID() const { return bookid.str(); }
+
+  string getAuthor() const { return author.str(); }
+
+  string getTitle() const { return title.str(); }
+
+  // The same without copying
+  StringRef idRef() const { return bookid; }
+
+  StringRef titleRef() const { return title; }
+
+  StringRef authorRef() const { return author; }
+
+  int getCatalogId() const { return catalogId; }
+
+  void setCatalogId(int id) { catalogId = id; }
+
+  int getAuthorPos() const { return authorPos; }
+
+  void setAuthorPos(int pos) { authorPos = pos; }
 
-  string getID();
+  int getCopies() const { return copies; }
 
-  string getAuthor();
+  void setCopies(int n) { copies = n; }
 
-  string getTitle();
+  // Capitalize the first letter of every word and lower-case the rest, in
+  // place: how titles are displayed whatever case they were entered in
+  static void formatTitle(char *title, int length);
 };
 
 #endif
@@ -0,0 +1,58 @@
+#ifndef ROOM_H
+#define ROOM_H
+
+#include <climits>
+#include <string>
+
+using namespace std;
+
+// What a study room offers. rooms.txt lists it after the room's ID:
+//   id[,capacity[,floor[,equipment|equipment|...]]]
+// so a file of bare IDs still loads (capacity and floor unknown). Floors
+// may be negative (basements).
+struct RoomAttributes {
+  // Equipment flags; equipmentName(i) is the name of flag 1 << i
+  enum Equipment {
+    PROJECTOR = 1,
+    WHITEBOARD = 2,
+    SCREEN = 4,
+    VIDEO_CALL = 8,
+    COMPUTER = 16
+  };
+  static const int EQUIPMENT_KINDS = 5;
+  // The floor of a room nobody has said it is on; not a floor itself
+  static const int UNKNOWN_FLOOR = INT_MIN;
+
+  int capacity;       // seats, 0 if unknown
+  int floor;          // UNKNOWN_FLOOR if unknown
+  unsigned equipment; // Equipment flags
+
+  RoomAttributes() : capacity(0), floor(UNKNOWN_FLOOR), equipment(0) {}
+
+  RoomAttributes(int seats, int floorNumber, unsigned equipmentFlags)
+      : capacity(seats), floor(floorNumber), equipment(equipmentFlags) {}
+
+  bool isKnown() const {
+    return capacity > 0 || floor != UNKNOWN_FLOOR || equipment;
+  }
+
+  static const char *equipmentName(int kind);
+
+  // The flag called name (any case), or 0 if there is none
+  static unsigned equipmentFlag(const string &name);
+
+  // Flags of a "name|name|..." list; false if a name is unknown
+  static bool parseEquipment(const string &names, unsigned &flags);
+
+  // "name|name|..." for flags
+  static string formatEquipment(unsigned flags);
+
+  // Parse the fields after the ID on a rooms.txt line ("" for none).
+  // Returns false, leaving out unchanged, if they are malformed.
+  static bool parse(const string &fields, RoomAttributes &out);
+
+  // The fields after the ID, "" if nothing is known
+  string format() const;
+};
+
+#endif
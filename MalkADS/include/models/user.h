@@ -34,6 +34,10 @@ public:
     roomBookings.insert(start, end, username);
   }
 
+  void removeRoomBooking(const int start, const int end) {
+    roomBookings.remove(start, end);
+  }
+
   bool canBookLaptop(const int start, const int end) {
     return !laptopBookings.searchOverlap(start, end, false);
   }
@@ -56,6 +60,10 @@ public:
   void addBookBooking(const int start, const int end) {
     bookBookings.insert(start, end, username);
   }
+
+  void removeBookBooking(const int start, const int end) {
+    bookBookings.remove(start, end);
+  }
 };
 
 #endif
@@ -0,0 +1,78 @@
+#ifndef WAITLIST_REQUEST_H
+#define WAITLIST_REQUEST_H
+
+#include <string>
+
+#include "../structures/hash_map.h"
+#include "../structures/indexed_priority_queue.h"
+#include "user.h"
+
+using namespace std;
+
+// A pending borrow request for a book that was on loan when requested
+struct WaitlistRequest {
+  string username;
+  User *user; // resolved in syncUserBookings after a reload, may be null
+  int start;
+  int end;
+  long long requestTime; // seconds since the start of 2025
+  long long priorityKey; // requestTime, pushed back for repeat borrowers
+  int seq;               // arrival order, breaks ties
+  bool repeatBorrower;   // user has borrowed this book before
+  long long lapseTimer;  // BooksManager timer that expires the request
+
+  WaitlistRequest()
+      : user(nullptr), start(0), end(0), requestTime(0), priorityKey(0),
+        seq(0), repeatBorrower(false), lapseTimer(-1) {}
+};
+
+// Timer payload: the request to expire if it is still waiting when its
+// window starts
+struct WaitlistLapse {
+  string bookId;
+  string username;
+  int seq;
+
+  WaitlistLapse() : seq(0) {}
+  WaitlistLapse(const string &book, const string &user, int s)
+      : bookId(book), username(user), seq(s) {}
+};
+
+// Earlier priorityKey first, then arrival order
+struct WaitlistComparator {
+  bool operator()(const WaitlistRequest &a, const WaitlistRequest &b) const {
+    if (a.priorityKey != b.priorityKey)
+      return a.priorityKey < b.priorityKey;
+    return a.seq < b.seq;
+  }
+};
+
+// One book's waitlist: the queue plus each waiting user's handle into it,
+// so a request can be found, withdrawn or re-prioritized in O(log n)
+struct BookWaitlist {
+  IndexedPriorityQueue<WaitlistRequest, WaitlistComparator> queue;
+  HashMap<string, int> handleByUser;
+
+  bool push(const WaitlistRequest &req) {
+    if (handleByUser.contains(req.username))
+      return false;
+    handleByUser.putNew(req.username, queue.push(req));
+    return true;
+  }
+
+  bool erase(const string &username) {
+    int *handle = handleByUser.get(username);
+    if (!handle)
+      return false;
+    queue.erase(*handle);
+    handleByUser.erase(username);
+    return true;
+  }
+
+  void pop() {
+    handleByUser.erase(queue.top().username);
+    queue.pop();
+  }
+};
+
+#endif
@@ -33,7 +33,7 @@ private:
 
   void fixInsert(Node *&node);
 
-  void fixDelete(Node *&node);
+  void fixDelete(Node *x, Node *xParent);
 
   Node *minValueNode(Node *&node);
 
@@ -47,6 +47,8 @@ private:
 
   Node *overlapSearch(Node *root, int low, int high);
 
+  Node *findNode(Node *node, int low, int high);
+
   // void listAvailableIntervalsHelper(Node* node, int StartLooking, int
   // EndLooking, int &currenttime, std::vector<std::pair<int,int> >
   // &availabletimes);
@@ -62,6 +64,20 @@ private:
     forEachIntervalHelper(node->right, func);
   }
 
+  // Subtrees whose intervals all end by low, or start at or after high,
+  // are skipped
+  template <typename Func>
+  void forEachOverlapHelper(Node *node, int low, int high, Func &func) {
+    if (!node || node->max <= low)
+      return;
+    forEachOverlapHelper(node->left, low, high, func);
+    if (node->low >= high)
+      return;
+    if (node->high > low)
+      func(node->low, node->high, node->bookedBy);
+    forEachOverlapHelper(node->right, low, high, func);
+  }
+
 public:
   RedBlackIntervalTree();
 
@@ -70,7 +86,11 @@ public:
   // Public functions
   void insert(int low, int high, const std::string &user);
 
-  void remove(int low, int high);
+  // Returns false if no interval [low, high] is stored
+  bool remove(int low, int high);
+
+  // True if exactly [low, high] is stored and booked by user
+  bool hasInterval(int low, int high, const std::string &user);
 
   bool searchOverlap(int low, int high, bool announce);
 
@@ -78,9 +98,21 @@ public:
 
   void printTree();
 
+  // Largest high endpoint stored (INT_MIN if empty): nothing is booked
+  // from then on
+  int maxHigh() const { return root ? root->max : INT_MIN; }
+
+  bool isEmpty() const { return root == nullptr; }
+
   template <typename Func> void forEachInterval(Func func) {
     forEachIntervalHelper(root, func);
   }
+
+  // func(low, high, user) for each interval overlapping [low, high), in
+  // order of low endpoint. Only the paths to those intervals are walked.
+  template <typename Func> void forEachOverlap(int low, int high, Func func) {
+    forEachOverlapHelper(root, low, high, func);
+  }
 };
 
 #endif
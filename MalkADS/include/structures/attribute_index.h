@@ -0,0 +1,153 @@
+#ifndef ATTRIBUTE_INDEX_H
+#define ATTRIBUTE_INDEX_H
+
+#include <climits>
+
+#include "bit_set.h"
+#include "hash_map.h"
+using namespace std;
+
+// Members numbered 0, 1, 2, ... described by up to 32 flags, an int
+// category and a size, indexed so filters are answered with a few BitSet
+// operations instead of a look at every member.
+//
+// There is one BitSet per flag and per category in use. Categories are
+// hashed rather than used as array indexes, so any int is one (negative
+// floors included) and a large one costs no more than a small one. Sizes
+// are bucketed: the set of bucket b holds the members whose size is at
+// least its bound, so "size >= n" starts from the set of the largest bucket
+// bound <= n and only the members of that set still have their size
+// compared.
+class AttributeIndex {
+public:
+  static const int FLAG_COUNT = 32;
+  static const int SIZE_BUCKET_COUNT = 10;
+  static const int NO_CATEGORY = INT_MIN;
+
+private:
+  BitSet flagSets[FLAG_COUNT];
+  HashMap<int, BitSet *> categorySets;
+  BitSet sizeSets[SIZE_BUCKET_COUNT];
+  BitSet members;
+  int *sizes; // by member
+
+  static const int *sizeBuckets() {
+    static const int bounds[SIZE_BUCKET_COUNT] = {1,  2,  4,  6,  8,
+                                                  10, 12, 16, 24, 40};
+    return bounds;
+  }
+
+  // The last bucket whose bound is <= size, or -1
+  static int bucketOf(int size) {
+    int b = -1;
+    while (b + 1 < SIZE_BUCKET_COUNT && sizeBuckets()[b + 1] <= size)
+      b++;
+    return b;
+  }
+
+  void growTo(int member) {
+    int bits = members.size() ? members.size() : 64;
+    while (bits <= member)
+      bits *= 2;
+    int *grownSizes = new int[bits];
+    for (int i = 0; i < bits; i++)
+      grownSizes[i] = i < members.size() ? sizes[i] : 0;
+    delete[] sizes;
+    sizes = grownSizes;
+
+    members.resize(bits);
+    for (int f = 0; f < FLAG_COUNT; f++)
+      flagSets[f].resize(bits);
+    categorySets.forEach([&](int, BitSet *set) { set->resize(bits); });
+    for (int b = 0; b < SIZE_BUCKET_COUNT; b++)
+      sizeSets[b].resize(bits);
+  }
+
+  BitSet *categorySet(int category) {
+    BitSet **set = categorySets.get(category);
+    if (set)
+      return *set;
+    BitSet *created = new BitSet(members.size());
+    try {
+      categorySets.putNew(category, created);
+    } catch (...) {
+      delete created;
+      throw;
+    }
+    return created;
+  }
+
+public:
+  AttributeIndex() : sizes(nullptr) {}
+
+  ~AttributeIndex() {
+    categorySets.forEach([](int, BitSet *set) { delete set; });
+    delete[] sizes;
+  }
+
+  AttributeIndex(const AttributeIndex &) = delete;
+  AttributeIndex &operator=(const AttributeIndex &) = delete;
+
+  // Add member, or replace what is known about it. category NO_CATEGORY
+  // means none, size <= 0 unknown. Everything that allocates happens
+  // before the member's old entry is touched, so if it throws the index
+  // still describes the member as it was.
+  void set(int member, unsigned flags, int category, int size) {
+    if (member >= members.size())
+      growTo(member);
+    BitSet *inCategory =
+        category == NO_CATEGORY ? nullptr : categorySet(category);
+    remove(member);
+    members.set(member);
+    for (int f = 0; f < FLAG_COUNT; f++)
+      if (flags & (1u << f))
+        flagSets[f].set(member);
+    if (inCategory)
+      inCategory->set(member);
+    sizes[member] = size;
+    for (int b = 0; b <= bucketOf(size); b++)
+      sizeSets[b].set(member);
+  }
+
+  void remove(int member) {
+    if (!members.test(member))
+      return;
+    members.reset(member);
+    for (int f = 0; f < FLAG_COUNT; f++)
+      flagSets[f].reset(member);
+    categorySets.forEach([&](int, BitSet *set) { set->reset(member); });
+    for (int b = 0; b < SIZE_BUCKET_COUNT; b++)
+      sizeSets[b].reset(member);
+    sizes[member] = 0;
+  }
+
+  // Keep only the members of candidates that have every flag of
+  // requiredFlags, are in category (any if NO_CATEGORY) and have
+  // size >= minSize (any if <= 0)
+  void filter(BitSet &candidates, unsigned requiredFlags, int category,
+              int minSize) const {
+    candidates.andWith(members);
+    for (int f = 0; f < FLAG_COUNT; f++)
+      if (requiredFlags & (1u << f))
+        candidates.andWith(flagSets[f]);
+    if (category != NO_CATEGORY) {
+      BitSet **inCategory = categorySets.get(category);
+      if (!inCategory) {
+        candidates.clear();
+        return;
+      }
+      candidates.andWith(**inCategory);
+    }
+    if (minSize <= 0)
+      return;
+    int b = bucketOf(minSize);
+    candidates.andWith(sizeSets[b]);
+    if (sizeBuckets()[b] == minSize)
+      return;
+    for (int m = candidates.next(0); m >= 0; m = candidates.next(m + 1))
+      if (sizes[m] < minSize)
+        candidates.reset(m);
+  }
+};
+
+#endif // ATTRIBUTE_INDEX_H
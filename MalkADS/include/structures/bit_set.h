@@ -0,0 +1,146 @@
+#ifndef BIT_SET_H
+#define BIT_SET_H
+
+#include <cstdint>
+
+using namespace std;
+
+// Fixed-size set of small integers, one bit each, packed into 64-bit words.
+//
+// Set operations (andWith, orWith, andNotWith) work a word at a time, so
+// intersecting two sets of n members costs n / 64 word operations. next()
+// skips empty words, so walking the members costs O(n / 64 + members).
+class BitSet {
+private:
+  uint64_t *words;
+  int wordCount;
+  int bitCount;
+
+  static int wordsFor(int bits) { return (bits + 63) / 64; }
+
+  static int lowestBit(uint64_t word) {
+#if defined(__GNUC__)
+    return __builtin_ctzll(word);
+#else
+    int i = 0;
+    while (!(word & 1)) {
+      word >>= 1;
+      i++;
+    }
+    return i;
+#endif
+  }
+
+  static int bitsIn(uint64_t word) {
+#if defined(__GNUC__)
+    return __builtin_popcountll(word);
+#else
+    int n = 0;
+    for (; word; word &= word - 1)
+      n++;
+    return n;
+#endif
+  }
+
+public:
+  explicit BitSet(int bits = 0) : words(nullptr), wordCount(0), bitCount(0) {
+    resize(bits);
+  }
+
+  ~BitSet() { delete[] words; }
+
+  BitSet(const BitSet &) = delete;
+  BitSet &operator=(const BitSet &) = delete;
+
+  int size() const { return bitCount; }
+
+  // Change the number of bits. Bits added are clear; bits dropped are lost.
+  void resize(int bits) {
+    if (bits < 0)
+      bits = 0;
+    int newWordCount = wordsFor(bits);
+    if (newWordCount != wordCount) {
+      uint64_t *resized = newWordCount ? new uint64_t[newWordCount] : nullptr;
+      for (int w = 0; w < newWordCount; w++)
+        resized[w] = w < wordCount ? words[w] : 0;
+      delete[] words;
+      words = resized;
+      wordCount = newWordCount;
+    }
+    bitCount = bits;
+    // Keep the bits past the end clear so count() and next() ignore them
+    if (bitCount % 64)
+      words[wordCount - 1] &= (uint64_t(1) << (bitCount % 64)) - 1;
+  }
+
+  void set(int i) { words[i / 64] |= uint64_t(1) << (i % 64); }
+
+  void reset(int i) { words[i / 64] &= ~(uint64_t(1) << (i % 64)); }
+
+  bool test(int i) const {
+    return i >= 0 && i < bitCount && (words[i / 64] >> (i % 64)) & 1;
+  }
+
+  void clear() {
+    for (int w = 0; w < wordCount; w++)
+      words[w] = 0;
+  }
+
+  // Become a copy of other (resizing to match)
+  void assign(const BitSet &other) {
+    resize(other.bitCount);
+    for (int w = 0; w < wordCount; w++)
+      words[w] = other.words[w];
+  }
+
+  // The set operations treat bits past the end of other as clear
+  void andWith(const BitSet &other) {
+    for (int w = 0; w < wordCount; w++)
+      words[w] &= w < other.wordCount ? other.words[w] : 0;
+  }
+
+  void orWith(const BitSet &other) {
+    int n = wordCount < other.wordCount ? wordCount : other.wordCount;
+    for (int w = 0; w < n; w++)
+      words[w] |= other.words[w];
+    resize(bitCount);
+  }
+
+  void andNotWith(const BitSet &other) {
+    int n = wordCount < other.wordCount ? wordCount : other.wordCount;
+    for (int w = 0; w < n; w++)
+      words[w] &= ~other.words[w];
+  }
+
+  bool any() const {
+    for (int w = 0; w < wordCount; w++)
+      if (words[w])
+        return true;
+    return false;
+  }
+
+  int count() const {
+    int n = 0;
+    for (int w = 0; w < wordCount; w++)
+      n += bitsIn(words[w]);
+    return n;
+  }
+
+  // The smallest member >= from, or -1 if there is none
+  int next(int from) const {
+    if (from < 0)
+      from = 0;
+    if (from >= bitCount)
+      return -1;
+    int w = from / 64;
+    uint64_t word = words[w] & (~uint64_t(0) << (from % 64));
+    while (!word) {
+      if (++w == wordCount)
+        return -1;
+      word = words[w];
+    }
+    return w * 64 + lowestBit(word);
+  }
+};
+
+#endif // BIT_SET_H
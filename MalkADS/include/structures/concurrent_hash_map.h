@@ -0,0 +1,227 @@
+#ifndef ADS_PROJECT_CONCURRENT_HASH_MAP_H
+#define ADS_PROJECT_CONCURRENT_HASH_MAP_H
+
+#include <mutex>
+
+#include "hash_map.h"
+#include "rw_spin_lock.h"
+
+/**
+ * @file concurrent_hash_map.h
+ * @brief Lock-striped hash map for use from several threads
+ */
+
+/**
+ * @enum ForEachMode
+ * @brief Consistency of ConcurrentHashMap::forEach
+ */
+enum class ForEachMode {
+  PerShard,  ///< Lock one shard at a time; writers to other shards proceed
+  Consistent ///< Lock every shard first; sees one point-in-time state
+};
+
+/**
+ * @class ConcurrentHashMap
+ * @brief A HashMap split into independently locked shards
+ *
+ * Keys are spread over N shards by the high bits of their hash. Each shard
+ * is an ordinary HashMap guarded by its own RWSpinLock, so lookups on
+ * different shards never contend and lookups on the same shard share the
+ * lock. putNew / erase take the shard lock exclusively.
+ *
+ * Because another thread may erase an entry at any time, lookups never hand
+ * out pointers into the table: get() copies the value out, and visit() runs
+ * a callback while the shard lock is held.
+ *
+ * @tparam K Key type
+ * @tparam V Value type (copied out by get())
+ * @tparam Hash Hash functor, defaults to DefaultHasher<K>
+ * @tparam KeyEqual Key equality functor, defaults to std::equal_to<K>
+ *
+ * Example Usage:
+ * @code
+ *  ConcurrentHashMap<std::string, int> map(32);
+ *  map.putNew("R150B", 1);
+ *  int v;
+ *  if (map.get("R150B", v)) { ... }
+ *  map.visit("R150B", [](int &val) { val++; });
+ * @endcode
+ */
+template <typename K, typename V, typename Hash = DefaultHasher<K>,
+          typename KeyEqual = std::equal_to<K>>
+class ConcurrentHashMap {
+public:
+  /**
+   * @brief Construct with a fixed number of shards
+   *
+   * @param shardCount Number of lock stripes; rounded up to at least 1.
+   * Around 2-4x the number of worker threads is a good choice.
+   */
+  explicit ConcurrentHashMap(int shardCount = 16)
+      : shards_(nullptr), shardCount_(shardCount < 1 ? 1 : shardCount) {
+    shards_ = new Shard[shardCount_];
+  }
+
+  ~ConcurrentHashMap() { delete[] shards_; }
+
+  ConcurrentHashMap(const ConcurrentHashMap &) = delete;
+  ConcurrentHashMap &operator=(const ConcurrentHashMap &) = delete;
+
+  /**
+   * @brief Insert a new key-value pair (exclusive shard lock)
+   * @return true if inserted, false if the key already exists
+   */
+  bool putNew(const K &key, const V &value) {
+    Shard &s = shardFor(key);
+    std::lock_guard<RWSpinLock> guard(s.lock);
+    return s.map.putNew(key, value);
+  }
+
+  /**
+   * @brief Copy the value for a key (shared shard lock)
+   * @param key The key to look up
+   * @param out Receives a copy of the value if found
+   * @return true if the key was found
+   */
+  bool get(const K &key, V &out) const {
+    Shard &s = shardFor(key);
+    SharedLockGuard guard(s.lock);
+    V *v = s.map.get(key);
+    if (!v)
+      return false;
+    out = *v;
+    return true;
+  }
+
+  /**
+   * @brief Check if a key exists (shared shard lock)
+   */
+  bool contains(const K &key) const {
+    Shard &s = shardFor(key);
+    SharedLockGuard guard(s.lock);
+    return s.map.get(key) != nullptr;
+  }
+
+  /**
+   * @brief Remove a key (exclusive shard lock)
+   * @return true if the key was found and removed
+   */
+  bool erase(const K &key) {
+    Shard &s = shardFor(key);
+    std::lock_guard<RWSpinLock> guard(s.lock);
+    return s.map.erase(key);
+  }
+
+  /**
+   * @brief Run func(V&) on the value for key under the exclusive shard lock
+   * @return true if the key was found
+   */
+  template <typename Func> bool visit(const K &key, Func func) {
+    Shard &s = shardFor(key);
+    std::lock_guard<RWSpinLock> guard(s.lock);
+    V *v = s.map.get(key);
+    if (!v)
+      return false;
+    func(*v);
+    return true;
+  }
+
+  /**
+   * @brief Run func(const V&) on the value for key under the shared lock
+   * @return true if the key was found
+   */
+  template <typename Func> bool visitShared(const K &key, Func func) const {
+    Shard &s = shardFor(key);
+    SharedLockGuard guard(s.lock);
+    V *v = s.map.get(key);
+    if (!v)
+      return false;
+    func(static_cast<const V &>(*v));
+    return true;
+  }
+
+  /**
+   * @brief Apply func(const K&, V&) to every entry
+   *
+   * The callback runs under the shard's exclusive lock, so it may modify
+   * the value but must not call back into this map.
+   *
+   * @param mode PerShard locks shards one after another. Consistent locks
+   * all shards (always in index order, so two consistent walks cannot
+   * deadlock) before visiting any entry.
+   */
+  template <typename Func>
+  void forEach(Func func, ForEachMode mode = ForEachMode::PerShard) {
+    if (mode == ForEachMode::Consistent) {
+      for (int i = 0; i < shardCount_; i++)
+        shards_[i].lock.lock();
+      for (int i = 0; i < shardCount_; i++)
+        shards_[i].map.forEach(func);
+      for (int i = shardCount_ - 1; i >= 0; i--)
+        shards_[i].lock.unlock();
+      return;
+    }
+    for (int i = 0; i < shardCount_; i++) {
+      std::lock_guard<RWSpinLock> guard(shards_[i].lock);
+      shards_[i].map.forEach(func);
+    }
+  }
+
+  /**
+   * @brief Remove every entry (shard by shard)
+   */
+  void clear() {
+    for (int i = 0; i < shardCount_; i++) {
+      std::lock_guard<RWSpinLock> guard(shards_[i].lock);
+      shards_[i].map.clear();
+    }
+  }
+
+  /**
+   * @brief Number of entries
+   *
+   * Sums the shard sizes; under concurrent writers this is only a snapshot.
+   */
+  int size() const {
+    int total = 0;
+    for (int i = 0; i < shardCount_; i++) {
+      SharedLockGuard guard(shards_[i].lock);
+      total += shards_[i].map.size();
+    }
+    return total;
+  }
+
+  bool empty() const { return size() == 0; }
+
+  int shardCount() const { return shardCount_; }
+
+private:
+  /**
+   * @struct Shard
+   * @brief One lock stripe, padded so neighbouring locks do not share a
+   * cache line
+   */
+  struct Shard {
+    RWSpinLock lock;
+    HashMap<K, V, Hash, KeyEqual> map;
+    char pad[64];
+  };
+
+  Shard *shards_;  ///< Array of shardCount_ shards
+  int shardCount_; ///< Number of shards
+  Hash hasher_;    ///< Used only to pick the shard
+
+  /**
+   * @brief Pick the shard for a key
+   *
+   * Uses the high bits of the hash: the shard's own HashMap indexes buckets
+   * by the low bits, so reusing them would leave most buckets empty.
+   */
+  Shard &shardFor(const K &key) const {
+    const uint64_t h = static_cast<uint64_t>(hasher_(key));
+    const uint64_t mixed = (h ^ (h >> 29)) * 0x9e3779b97f4a7c15ull;
+    return shards_[static_cast<int>((mixed >> 32) % shardCount_)];
+  }
+};
+
+#endif // ADS_PROJECT_CONCURRENT_HASH_MAP_H
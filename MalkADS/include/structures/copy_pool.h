@@ -0,0 +1,148 @@
+#ifndef COPY_POOL_H
+#define COPY_POOL_H
+
+#include <climits>
+#include <string>
+
+#include "IntervalTreeComplete.h"
+using namespace std;
+
+// Loans of the physical copies of one book: an interval tree per copy,
+// plus a min segment tree over the copies keyed by the end of each copy's
+// last loan (the time from which it is free for good).
+//
+// findFree(start, end) first descends the segment tree to the leftmost
+// copy whose last loan ends by start, in O(log copies). Only when every
+// copy is still booked after start does it look for a gap that fits,
+// checking each copy's tree (O(copies * log loans)). Preferring copies that
+// are free from start on keeps the gaps in the other copies open for
+// requests that need them.
+class CopyPool {
+private:
+  RedBlackIntervalTree **trees;
+  int copyCount;
+  int leafCount; // power of two >= copyCount
+  // Heap-ordered segment tree: node i covers children 2i and 2i+1, leaf
+  // leafCount + c is copy c (INT_MAX past the last copy)
+  int *lastEnd;
+
+  void refresh(int copy) {
+    int i = leafCount + copy;
+    lastEnd[i] = trees[copy]->maxHigh();
+    for (i /= 2; i >= 1; i /= 2)
+      lastEnd[i] = lastEnd[2 * i] < lastEnd[2 * i + 1] ? lastEnd[2 * i]
+                                                       : lastEnd[2 * i + 1];
+  }
+
+  void rebuild() {
+    delete[] lastEnd;
+    leafCount = 1;
+    while (leafCount < copyCount)
+      leafCount *= 2;
+    lastEnd = new int[2 * leafCount];
+    for (int i = 0; i < leafCount; i++)
+      lastEnd[leafCount + i] = i < copyCount ? trees[i]->maxHigh() : INT_MAX;
+    for (int i = leafCount - 1; i >= 1; i--)
+      lastEnd[i] = lastEnd[2 * i] < lastEnd[2 * i + 1] ? lastEnd[2 * i]
+                                                       : lastEnd[2 * i + 1];
+  }
+
+public:
+  explicit CopyPool(int copies = 1)
+      : trees(nullptr), copyCount(0), leafCount(0), lastEnd(nullptr) {
+    resize(copies > 0 ? copies : 1);
+  }
+
+  ~CopyPool() {
+    for (int i = 0; i < copyCount; i++)
+      delete trees[i];
+    delete[] trees;
+    delete[] lastEnd;
+  }
+
+  CopyPool(const CopyPool &) = delete;
+  CopyPool &operator=(const CopyPool &) = delete;
+
+  int copies() const { return copyCount; }
+
+  // Change the number of copies. Copies are added or dropped at the end;
+  // fails if a copy that would be dropped still has loans.
+  bool resize(int copies) {
+    if (copies < 1)
+      return false;
+    for (int i = copies; i < copyCount; i++)
+      if (!trees[i]->isEmpty())
+        return false;
+
+    RedBlackIntervalTree **resized = new RedBlackIntervalTree *[copies];
+    for (int i = 0; i < copies; i++)
+      resized[i] = i < copyCount ? trees[i] : new RedBlackIntervalTree();
+    for (int i = copies; i < copyCount; i++)
+      delete trees[i];
+    delete[] trees;
+    trees = resized;
+    copyCount = copies;
+    rebuild();
+    return true;
+  }
+
+  // A copy that is free for [start, end), or -1 if none is
+  int findFree(int start, int end) const {
+    if (lastEnd[1] <= start) {
+      int i = 1;
+      while (i < leafCount)
+        i = lastEnd[2 * i] <= start ? 2 * i : 2 * i + 1;
+      return i - leafCount;
+    }
+    for (int c = 0; c < copyCount; c++)
+      if (!trees[c]->searchOverlap(start, end, false))
+        return c;
+    return -1;
+  }
+
+  bool isFree(int copy, int start, int end) const {
+    return copy >= 0 && copy < copyCount &&
+           !trees[copy]->searchOverlap(start, end, false);
+  }
+
+  // Number of copies free for [start, end)
+  int freeCount(int start, int end) const {
+    int count = 0;
+    for (int c = 0; c < copyCount; c++)
+      if (lastEnd[leafCount + c] <= start ||
+          !trees[c]->searchOverlap(start, end, false))
+        count++;
+    return count;
+  }
+
+  // Record a loan of copy (callers check isFree or findFree first)
+  void insert(int copy, int start, int end, const string &username) {
+    trees[copy]->insert(start, end, username);
+    refresh(copy);
+  }
+
+  // The copy on loan to username for exactly [start, end], or -1
+  int findLoan(int start, int end, const string &username) const {
+    for (int c = 0; c < copyCount; c++)
+      if (trees[c]->hasInterval(start, end, username))
+        return c;
+    return -1;
+  }
+
+  bool remove(int copy, int start, int end) {
+    if (copy < 0 || copy >= copyCount || !trees[copy]->remove(start, end))
+      return false;
+    refresh(copy);
+    return true;
+  }
+
+  // func(copy, low, high, username) for every loan, copy by copy
+  template <typename Func> void forEachLoan(Func func) const {
+    for (int c = 0; c < copyCount; c++)
+      trees[c]->forEachInterval([&](int low, int high, const string &user) {
+        func(c, low, high, user);
+      });
+  }
+};
+
+#endif // COPY_POOL_H
@@ -0,0 +1,123 @@
+#ifndef DEMAND_INDEX_H
+#define DEMAND_INDEX_H
+
+#include <string>
+
+#include "fenwick_tree.h"
+#include "hash_map.h"
+#include "top_k.h"
+using namespace std;
+
+// One row of a "most demanded" answer
+struct DemandEntry {
+  string id;
+  int count;
+
+  DemandEntry() : count(0) {}
+  DemandEntry(const string &resourceId, int c) : id(resourceId), count(c) {}
+};
+
+// Higher count first, then smaller ID so ties come out in a stable order
+struct DemandRanking {
+  bool operator()(const DemandEntry &a, const DemandEntry &b) const {
+    if (a.count != b.count)
+      return a.count > b.count;
+    return a.id < b.id;
+  }
+};
+
+// Per-resource booking counters, kept up to date by the managers as
+// bookings are made and cancelled so demand questions never walk the
+// interval trees.
+//
+// Each resource has a FenwickTree of bookings per day (by the day the
+// booking starts), so the count over any window of days is O(log days) and
+// the top k resources over a window are O(n log k) for n resources.
+class DemandIndex {
+private:
+  HashMap<string, FenwickTree *> counters;
+
+  static const int BUCKET_SECONDS = 24 * 3600;
+
+  static int bucketOf(long long seconds) {
+    return seconds < 0 ? 0 : static_cast<int>(seconds / BUCKET_SECONDS);
+  }
+
+public:
+  DemandIndex() {}
+
+  ~DemandIndex() { clear(); }
+
+  DemandIndex(const DemandIndex &) = delete;
+  DemandIndex &operator=(const DemandIndex &) = delete;
+
+  // Count (delta = 1) or uncount (delta = -1) a booking starting at start
+  void record(const string &id, long long start, int delta = 1) {
+    FenwickTree **counterPtr = counters.get(id);
+    FenwickTree *counter = counterPtr ? *counterPtr : nullptr;
+    if (!counter) {
+      counter = new FenwickTree();
+      counters.putNew(id, counter);
+    }
+    counter->add(bucketOf(start), delta);
+  }
+
+  // Forget a resource that was removed
+  void removeResource(const string &id) {
+    FenwickTree **counterPtr = counters.get(id);
+    if (!counterPtr)
+      return;
+    delete *counterPtr;
+    counters.erase(id);
+  }
+
+  // Bookings of id starting on the days covered by [from, to]
+  int count(const string &id, long long from, long long to) const {
+    FenwickTree **counterPtr = counters.get(id);
+    if (!counterPtr || !(*counterPtr))
+      return 0;
+    return (*counterPtr)->rangeSum(bucketOf(from), bucketOf(to));
+  }
+
+  // All-time bookings of id
+  long long total(const string &id) const {
+    FenwickTree **counterPtr = counters.get(id);
+    return (counterPtr && *counterPtr) ? (*counterPtr)->sum() : 0;
+  }
+
+  // The k resources with the most bookings starting on the days covered by
+  // [from, to], reported as func(id, count) from most to least booked.
+  // Resources with no bookings in the window are skipped. Returns the
+  // number reported.
+  template <typename Func>
+  int topK(int k, long long from, long long to, Func func) const {
+    TopK<DemandEntry, DemandRanking> best(k);
+    const int lo = bucketOf(from);
+    const int hi = bucketOf(to);
+    const_cast<HashMap<string, FenwickTree *> &>(counters).forEach(
+        [&](const string &id, FenwickTree *&counter) {
+          if (!counter)
+            return;
+          int c = counter->rangeSum(lo, hi);
+          if (c > 0)
+            best.offer(DemandEntry(id, c));
+        });
+
+    int reported = 0;
+    best.drain([&](DemandEntry &e) {
+      func(static_cast<const string &>(e.id), e.count);
+      reported++;
+    });
+    return reported;
+  }
+
+  void clear() {
+    counters.forEach([](const string &, FenwickTree *&counter) {
+      delete counter;
+      counter = nullptr;
+    });
+    counters.clear();
+  }
+};
+
+#endif // DEMAND_INDEX_H
@@ -0,0 +1,98 @@
+#ifndef FENWICK_TREE_H
+#define FENWICK_TREE_H
+
+using namespace std;
+
+// Fenwick (binary indexed) tree of integer counts over indices 0, 1, 2, ...
+// add() and rangeSum() are O(log n). The index range grows on demand: the
+// tree doubles and is rebuilt from the per-index counts in O(n).
+class FenwickTree {
+private:
+  int *tree;   // 1-based Fenwick array, tree[i] covers (i - lowbit(i), i]
+  int *counts; // plain per-index counts, used to rebuild on growth
+  int n;
+  long long total;
+
+  void grow(int minSize) {
+    int newSize = n;
+    while (newSize < minSize)
+      newSize *= 2;
+
+    int *newCounts = new int[newSize];
+    for (int i = 0; i < newSize; i++)
+      newCounts[i] = i < n ? counts[i] : 0;
+
+    // Linear-time build: push each node's sum into its parent
+    int *newTree = new int[newSize + 1];
+    newTree[0] = 0;
+    for (int i = 1; i <= newSize; i++)
+      newTree[i] = newCounts[i - 1];
+    for (int i = 1; i <= newSize; i++) {
+      int parent = i + (i & -i);
+      if (parent <= newSize)
+        newTree[parent] += newTree[i];
+    }
+
+    delete[] tree;
+    delete[] counts;
+    tree = newTree;
+    counts = newCounts;
+    n = newSize;
+  }
+
+  // Sum of counts at indices [0, index]
+  int prefixSum(int index) const {
+    if (index >= n)
+      index = n - 1;
+    int sum = 0;
+    for (int i = index + 1; i > 0; i -= i & -i)
+      sum += tree[i];
+    return sum;
+  }
+
+public:
+  explicit FenwickTree(int initialSize = 64) : total(0) {
+    n = initialSize < 1 ? 1 : initialSize;
+    tree = new int[n + 1]();
+    counts = new int[n]();
+  }
+
+  ~FenwickTree() {
+    delete[] tree;
+    delete[] counts;
+  }
+
+  FenwickTree(const FenwickTree &) = delete;
+  FenwickTree &operator=(const FenwickTree &) = delete;
+
+  // Add delta to the count at index (index >= 0)
+  void add(int index, int delta) {
+    if (index < 0)
+      return;
+    if (index >= n)
+      grow(index + 1);
+    counts[index] += delta;
+    total += delta;
+    for (int i = index + 1; i <= n; i += i & -i)
+      tree[i] += delta;
+  }
+
+  // Sum of counts at indices [lo, hi]
+  int rangeSum(int lo, int hi) const {
+    if (lo < 0)
+      lo = 0;
+    if (hi < lo || lo >= n)
+      return 0;
+    return prefixSum(hi) - (lo > 0 ? prefixSum(lo - 1) : 0);
+  }
+
+  int at(int index) const {
+    return (index >= 0 && index < n) ? counts[index] : 0;
+  }
+
+  long long sum() const { return total; }
+
+  int size() const { return n; }
+};
+
+#endif // FENWICK_TREE_H
@@ -0,0 +1,143 @@
+#ifndef FREE_SLOT_INDEX_H
+#define FREE_SLOT_INDEX_H
+
+#include "bit_set.h"
+using namespace std;
+
+// Which resources are free when, over a fixed horizon of equal time slots.
+//
+// Resources are numbered 0, 1, 2, ... by the caller. Each slot has a
+// BitSet of the members with no booking overlapping any part of it, so
+// the members free for a window are the AND of the sets of the slots it
+// covers: O(slots * members / 64) however many bookings there are.
+//
+// A window rarely starts and ends on slot boundaries. A member that is busy
+// in an edge slot may still be free for the part of it the window covers,
+// so query() reports those members separately for the caller to check
+// against the bookings themselves.
+class FreeSlotIndex {
+private:
+  int slotSeconds;
+  int slotCount;
+  long long horizonStart; // -1 until reset()
+  BitSet *slots;
+  BitSet members;
+
+  // First and one-past-last slot overlapping [start, end), clamped
+  void slotsOverlapping(long long start, long long end, int &first,
+                        int &last) const {
+    long long from = (start - horizonStart) / slotSeconds;
+    long long to = (end - horizonStart + slotSeconds - 1) / slotSeconds;
+    first = from < 0 ? 0 : static_cast<int>(from);
+    last = to > slotCount ? slotCount : static_cast<int>(to);
+  }
+
+public:
+  FreeSlotIndex(int slotSeconds, int slotCount)
+      : slotSeconds(slotSeconds), slotCount(slotCount), horizonStart(-1) {
+    slots = new BitSet[slotCount];
+  }
+
+  ~FreeSlotIndex() { delete[] slots; }
+
+  FreeSlotIndex(const FreeSlotIndex &) = delete;
+  FreeSlotIndex &operator=(const FreeSlotIndex &) = delete;
+
+  bool isBuilt() const { return horizonStart >= 0; }
+
+  long long start() const { return horizonStart; }
+
+  long long end() const {
+    return horizonStart + static_cast<long long>(slotCount) * slotSeconds;
+  }
+
+  int slotLength() const { return slotSeconds; }
+
+  // Whether [start, end) lies inside the horizon
+  bool covers(long long start, long long end) const {
+    return isBuilt() && start >= horizonStart && end <= this->end() &&
+           start < end;
+  }
+
+  // Move the horizon to begin at start, with every member free throughout.
+  // The caller then marks the bookings that fall in it.
+  void reset(long long start) {
+    horizonStart = start;
+    for (int s = 0; s < slotCount; s++)
+      slots[s].assign(members);
+  }
+
+  // Add member r, free in every slot
+  void addMember(int r) {
+    if (r >= members.size()) {
+      int bits = members.size() ? members.size() : 64;
+      while (bits <= r)
+        bits *= 2;
+      members.resize(bits);
+      for (int s = 0; s < slotCount; s++)
+        slots[s].resize(bits);
+    }
+    members.set(r);
+    for (int s = 0; s < slotCount; s++)
+      slots[s].set(r);
+  }
+
+  void removeMember(int r) {
+    if (r >= members.size())
+      return;
+    members.reset(r);
+    for (int s = 0; s < slotCount; s++)
+      slots[s].reset(r);
+  }
+
+  // Member r is booked for [start, end)
+  void markBusy(int r, long long start, long long end) {
+    if (!isBuilt() || !members.test(r))
+      return;
+    int first, last;
+    slotsOverlapping(start, end, first, last);
+    for (int s = first; s < last; s++)
+      slots[s].reset(r);
+  }
+
+  // A booking of member r for [start, end) is gone. Each slot it overlapped
+  // is marked free again unless isBusy(slotStart, slotEnd) says another
+  // booking still overlaps it.
+  template <typename Func>
+  void markFree(int r, long long start, long long end, Func isBusy) {
+    if (!isBuilt() || !members.test(r))
+      return;
+    int first, last;
+    slotsOverlapping(start, end, first, last);
+    for (int s = first; s < last; s++) {
+      long long slotStart = horizonStart + static_cast<long long>(s) *
+                                               slotSeconds;
+      if (!isBusy(slotStart, slotStart + slotSeconds))
+        slots[s].set(r);
+    }
+  }
+
+  // For a window inside the horizon: sure gets the members free in every
+  // slot the window touches (so free for the whole window), and maybe the
+  // others that are free in every slot the window covers completely (so
+  // free for the window unless a booking overlaps one of its edges).
+  void query(long long start, long long end, BitSet &sure,
+             BitSet &maybe) const {
+    int first, last;
+    slotsOverlapping(start, end, first, last);
+    sure.assign(members);
+    for (int s = first; s < last; s++)
+      sure.andWith(slots[s]);
+
+    maybe.assign(members);
+    long long from = start - horizonStart;
+    long long to = end - horizonStart;
+    int innerFirst = static_cast<int>((from + slotSeconds - 1) / slotSeconds);
+    int innerLast = static_cast<int>(to / slotSeconds);
+    for (int s = innerFirst; s < innerLast; s++)
+      maybe.andWith(slots[s]);
+    maybe.andNotWith(sure);
+  }
+};
+
+#endif // FREE_SLOT_INDEX_H
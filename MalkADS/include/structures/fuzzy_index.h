@@ -0,0 +1,404 @@
+#ifndef FUZZY_INDEX_H
+#define FUZZY_INDEX_H
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "hash_map.h"
+#include "text_index.h"
+using namespace std;
+
+// Approximate-match index: finds the stored texts within a few edits
+// (Levenshtein distance: insertions, deletions, substitutions) of a query,
+// closest first. Texts are normalized like TextIndex and keyed by
+// caller-chosen non-negative document IDs.
+//
+// Every text is indexed by the distinct trigrams of its padded form. To
+// find texts within d edits, the padded query is cut into d+1 pieces: the
+// d edits can touch at most d of them, so every match contains one piece
+// unchanged and therefore all of that piece's trigrams. The cut points are
+// chosen so the pieces' rarest trigrams are as rare as possible.
+// Candidates are the texts in the intersection of some piece's trigram
+// lists (rarest list first). Texts whose length is more than d away from
+// the query's are dropped as the rarest list is walked, before the other
+// lists are searched, and each survivor is checked once with a banded edit
+// distance that gives up as soon as the bound is exceeded. Queries too
+// short to give every piece a trigram scan the texts of similar length
+// instead.
+class FuzzyIndex {
+private:
+  // Pads mark the start and end so short texts still have trigrams and
+  // edits at either end are noticed
+  static const char PAD_START = '\x02';
+  static const char PAD_END = '\x03';
+
+  struct Match {
+    int docId;
+    int distance;
+  };
+
+  HashMap<int, SortedIdList *> postings;
+  SortedIdList **byLength; // documents by normalized text length
+  int lengthCapacity;
+  string *texts; // normalized text by document ID ("" if absent)
+  int *lengths;  // texts[docId].size(), packed so the length filter
+                 // rejects candidates without touching their strings
+  int textCapacity;
+  int docCount;
+
+  static int packGram(const string &s, size_t i) {
+    return (static_cast<unsigned char>(s[i]) << 16) |
+           (static_cast<unsigned char>(s[i + 1]) << 8) |
+           static_cast<unsigned char>(s[i + 2]);
+  }
+
+  // Sorted distinct trigrams of normalized text s; returns their count.
+  // grams must hold s.size() + 1 ints.
+  static int gramsOf(const string &s, int *grams) {
+    const string padded = string(2, PAD_START) + s + PAD_END;
+    int n = 0;
+    for (size_t i = 0; i + 3 <= padded.size(); i++)
+      grams[n++] = packGram(padded, i);
+    sort(grams, grams + n);
+    return static_cast<int>(unique(grams, grams + n) - grams);
+  }
+
+  template <typename T> static void grow(T *&arr, int &cap, int index) {
+    if (index < cap)
+      return;
+    int newCap = cap ? cap : 64;
+    while (newCap <= index)
+      newCap *= 2;
+    T *grown = new T[newCap]();
+    for (int i = 0; i < cap; i++)
+      grown[i] = std::move(arr[i]);
+    delete[] arr;
+    arr = grown;
+    cap = newCap;
+  }
+
+  SortedIdList *listFor(int gram) const {
+    SortedIdList *const *listPtr = postings.get(gram);
+    return listPtr ? *listPtr : nullptr;
+  }
+
+  // Cut padded (at least 3 * pieces long) into pieces of 3+ characters so
+  // that the sum over pieces of their rarest trigram's list size is
+  // smallest: a piece inside a common word would otherwise flood the
+  // candidates. Piece p is [cuts[p], cuts[p + 1]).
+  void choosePieces(const string &padded, int pieces, int *cuts) const {
+    const int len = static_cast<int>(padded.size());
+    const int gramCount = len - 2;
+    int *gramSize = new int[gramCount];
+    for (int i = 0; i < gramCount; i++) {
+      const SortedIdList *list = listFor(packGram(padded, i));
+      gramSize[i] = list ? list->size() : 0;
+    }
+
+    // cost[p * (len + 1) + e]: cheapest split of padded[0, e) into p
+    // pieces; from[...] is where the last of those pieces starts
+    const int stride = len + 1;
+    const long long INF = 1LL << 62;
+    long long *cost = new long long[(pieces + 1) * stride];
+    int *from = new int[(pieces + 1) * stride];
+    for (int i = 0; i < (pieces + 1) * stride; i++)
+      cost[i] = INF;
+    cost[0] = 0;
+    for (int p = 1; p <= pieces; p++) {
+      for (int a = 3 * (p - 1); a + 3 <= len; a++) {
+        const long long before = cost[(p - 1) * stride + a];
+        if (before == INF)
+          continue;
+        // Grow the piece [a, e), tracking its rarest trigram
+        int rarest = gramSize[a];
+        for (int e = a + 3; e <= len; e++) {
+          if (gramSize[e - 3] < rarest)
+            rarest = gramSize[e - 3];
+          if (before + rarest < cost[p * stride + e]) {
+            cost[p * stride + e] = before + rarest;
+            from[p * stride + e] = a;
+          }
+        }
+      }
+    }
+
+    cuts[pieces] = len;
+    for (int p = pieces; p > 0; p--)
+      cuts[p - 1] = from[p * stride + cuts[p]];
+
+    delete[] from;
+    delete[] cost;
+    delete[] gramSize;
+  }
+
+public:
+  FuzzyIndex()
+      : byLength(nullptr), lengthCapacity(0), texts(nullptr),
+        lengths(nullptr), textCapacity(0), docCount(0) {}
+
+  ~FuzzyIndex() {
+    clear();
+    for (int i = 0; i < lengthCapacity; i++)
+      delete byLength[i];
+    delete[] byLength;
+    delete[] texts;
+    delete[] lengths;
+  }
+
+  FuzzyIndex(const FuzzyIndex &) = delete;
+  FuzzyIndex &operator=(const FuzzyIndex &) = delete;
+
+  // Levenshtein distance between a and b if it is at most maxDistance,
+  // otherwise maxDistance + 1. Only the diagonal band of width
+  // 2 * maxDistance + 1 is filled, and it stops once a whole row is over.
+  static int boundedDistance(const string &a, const string &b,
+                             int maxDistance) {
+    const int la = static_cast<int>(a.size());
+    const int lb = static_cast<int>(b.size());
+    const int over = maxDistance + 1;
+    if (la - lb > maxDistance || lb - la > maxDistance)
+      return over;
+
+    // Titles fit the stack rows; longer texts get heap rows
+    const int STACK_ROW = 128;
+    int stackRows[2 * STACK_ROW];
+    int *heapRows = lb < STACK_ROW ? nullptr : new int[2 * (lb + 1)];
+    int *prev = heapRows ? heapRows : stackRows;
+    int *cur = prev + (heapRows ? lb + 1 : STACK_ROW);
+    for (int j = 0; j <= lb; j++)
+      prev[j] = j <= maxDistance ? j : over;
+
+    int result = over;
+    bool gaveUp = false;
+    for (int i = 1; i <= la && !gaveUp; i++) {
+      const int lo = max(1, i - maxDistance);
+      const int hi = min(lb, i + maxDistance);
+      cur[0] = i <= maxDistance ? i : over;
+      if (lo > 1)
+        cur[lo - 1] = over;
+      int rowMin = lo == 1 ? cur[0] : over;
+      for (int j = lo; j <= hi; j++) {
+        int best = prev[j - 1] + (a[i - 1] != b[j - 1]);
+        best = min(best, prev[j] + 1);
+        best = min(best, cur[j - 1] + 1);
+        cur[j] = min(best, over);
+        rowMin = min(rowMin, cur[j]);
+      }
+      if (hi < lb)
+        cur[hi + 1] = over;
+      gaveUp = rowMin > maxDistance;
+      swap(prev, cur);
+    }
+    if (!gaveUp)
+      result = prev[lb];
+
+    delete[] heapRows;
+    return result;
+  }
+
+  // Index text under docId, replacing whatever docId had before
+  void add(int docId, const string &text) {
+    if (docId < 0)
+      return;
+    remove(docId);
+    if (docId >= textCapacity) {
+      int lengthsCapacity = textCapacity;
+      grow(lengths, lengthsCapacity, docId);
+      grow(texts, textCapacity, docId);
+    }
+    texts[docId] = TextIndex::normalize(text);
+    const string &s = texts[docId];
+    lengths[docId] = static_cast<int>(s.size());
+    if (s.empty())
+      return;
+    docCount++;
+
+    int *grams = new int[s.size() + 1];
+    const int n = gramsOf(s, grams);
+    for (int i = 0; i < n; i++) {
+      SortedIdList *list = listFor(grams[i]);
+      if (!list) {
+        list = new SortedIdList();
+        postings.putNew(grams[i], list);
+      }
+      list->insert(docId);
+    }
+    delete[] grams;
+
+    const int len = static_cast<int>(s.size());
+    grow(byLength, lengthCapacity, len);
+    if (!byLength[len])
+      byLength[len] = new SortedIdList();
+    byLength[len]->insert(docId);
+  }
+
+  void remove(int docId) {
+    if (docId < 0 || docId >= textCapacity || texts[docId].empty())
+      return;
+    const string &s = texts[docId];
+    int *grams = new int[s.size() + 1];
+    const int n = gramsOf(s, grams);
+    for (int i = 0; i < n; i++) {
+      SortedIdList *list = listFor(grams[i]);
+      if (!list)
+        continue;
+      list->erase(docId);
+      if (list->empty()) {
+        delete list;
+        postings.erase(grams[i]);
+      }
+    }
+    delete[] grams;
+
+    byLength[s.size()]->erase(docId);
+    texts[docId].clear();
+    lengths[docId] = 0;
+    docCount--;
+  }
+
+  // Up to k documents within maxDistance edits of query, closest first
+  // (ties by ascending ID), as func(docId, distance). Returns the number
+  // reported.
+  template <typename Func>
+  int search(const string &query, int maxDistance, int k, Func func) const {
+    const string q = TextIndex::normalize(query);
+    if (q.empty() || k <= 0 || maxDistance < 0)
+      return 0;
+
+    // A vector, as func may throw while the matches are reported
+    vector<Match> best(k);
+    int found = 0;
+    auto consider = [&](int docId) {
+      // Once k matches are held, only closer ones are worth the DP
+      const int bound = found == k ? best[k - 1].distance : maxDistance;
+      const int d = boundedDistance(q, texts[docId], bound);
+      if (d > bound)
+        return;
+      if (found == k &&
+          (d == best[k - 1].distance && docId > best[k - 1].docId))
+        return;
+      int pos = found < k ? found++ : k - 1;
+      while (pos > 0 && (best[pos - 1].distance > d ||
+                         (best[pos - 1].distance == d &&
+                          best[pos - 1].docId > docId))) {
+        best[pos] = best[pos - 1];
+        pos--;
+      }
+      best[pos].docId = docId;
+      best[pos].distance = d;
+    };
+
+    // d edits touch at most d of d+1 non-overlapping pieces of the padded
+    // query, so every match contains some piece verbatim
+    const string padded = string(2, PAD_START) + q + PAD_END;
+    const int pieces = maxDistance + 1;
+    const int paddedLen = static_cast<int>(padded.size());
+
+    if (paddedLen < 3 * pieces) {
+      // Too short for every piece to hold a trigram: scan the lengths
+      // within reach instead
+      const int len = static_cast<int>(q.size());
+      for (int l = max(1, len - maxDistance);
+           l <= len + maxDistance && l < lengthCapacity; l++) {
+        if (!byLength[l])
+          continue;
+        for (int i = 0; i < byLength[l]->size(); i++)
+          consider(byLength[l]->at(i));
+      }
+    } else {
+      const int len = static_cast<int>(q.size());
+      int candidateCount = 0;
+      int candidateCap = 64;
+      int *candidates = new int[candidateCap];
+      SortedIdList **lists = new SortedIdList *[paddedLen];
+      int *cursor = new int[paddedLen];
+      int *cuts = new int[pieces + 1];
+      choosePieces(padded, pieces, cuts);
+
+      for (int p = 0; p < pieces; p++) {
+        const int from = cuts[p];
+        const int to = cuts[p + 1];
+        int listCount = 0;
+        bool missing = false;
+        for (int i = from; i + 3 <= to && !missing; i++) {
+          lists[listCount] = listFor(packGram(padded, i));
+          missing = !lists[listCount++];
+        }
+        if (missing)
+          continue;
+        sort(lists, lists + listCount,
+             [](const SortedIdList *a, const SortedIdList *b) {
+               return a->size() < b->size();
+             });
+
+        // Texts holding every trigram of the piece, driven by the rarest.
+        // Most of the rarest list is too long or too short to match, and
+        // its length is one array read, so that is checked first.
+        for (int i = 0; i < listCount; i++)
+          cursor[i] = 0;
+        const SortedIdList *driver = lists[0];
+        for (int d = 0; d < driver->size(); d++) {
+          const int docId = driver->at(d);
+          const int lenDiff = lengths[docId] - len;
+          if (lenDiff > maxDistance || -lenDiff > maxDistance)
+            continue;
+          bool inAll = true;
+          for (int i = 1; i < listCount && inAll; i++) {
+            cursor[i] = lists[i]->lowerBound(docId, cursor[i]);
+            inAll = cursor[i] < lists[i]->size() &&
+                    lists[i]->at(cursor[i]) == docId;
+          }
+          if (!inAll)
+            continue;
+          if (candidateCount == candidateCap) {
+            int *grown = new int[candidateCap * 2];
+            for (int i = 0; i < candidateCount; i++)
+              grown[i] = candidates[i];
+            delete[] candidates;
+            candidates = grown;
+            candidateCap *= 2;
+          }
+          candidates[candidateCount++] = docId;
+        }
+      }
+
+      // Pieces overlap in their matches; check each text once
+      sort(candidates, candidates + candidateCount);
+      candidateCount = static_cast<int>(
+          unique(candidates, candidates + candidateCount) - candidates);
+      for (int c = 0; c < candidateCount; c++)
+        consider(candidates[c]);
+
+      delete[] cuts;
+      delete[] cursor;
+      delete[] lists;
+      delete[] candidates;
+    }
+
+    for (int i = 0; i < found; i++)
+      func(best[i].docId, best[i].distance);
+    return found;
+  }
+
+  int size() const { return docCount; }
+
+  void clear() {
+    postings.forEach([](const int &, SortedIdList *&list) {
+      delete list;
+      list = nullptr;
+    });
+    postings.clear();
+    for (int i = 0; i < lengthCapacity; i++) {
+      delete byLength[i];
+      byLength[i] = nullptr;
+    }
+    for (int i = 0; i < textCapacity; i++) {
+      texts[i].clear();
+      lengths[i] = 0;
+    }
+    docCount = 0;
+  }
+};
+
+#endif // FUZZY_INDEX_H
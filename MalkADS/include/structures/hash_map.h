@@ -5,31 +5,64 @@
 #include <string>
 #include <utility>
 
+#include "string_hash.h"
 
 /**
  * @file hash_map.h
  * @brief Template-based hash map implementation using separate chaining for
  * collision resolution
  *
- * @tparam K Key type (must support std::hash and equality comparison)
+ * @tparam K Key type (must be hashable by Hash and comparable by KeyEqual)
  * @tparam V Value type
+ * @tparam Hash Hash functor, defaults to DefaultHasher<K>
+ * @tparam KeyEqual Key equality functor, defaults to std::equal_to<K>
  */
 
+/**
+ * @struct HashMapStats
+ * @brief Snapshot of a HashMap's occupancy, returned by HashMap::stats()
+ *
+ * chainHistogram[i] counts buckets whose chain holds exactly i nodes, the
+ * last bin counts every bucket with HISTOGRAM_BINS - 1 or more nodes.
+ * bytesUsed covers the bucket array and the chain nodes, not memory owned
+ * by the keys or values themselves (string buffers, pointed-to trees).
+ */
+struct HashMapStats {
+  static const int HISTOGRAM_BINS = 9;
+
+  int size;              ///< Number of key-value pairs
+  int bucketCount;       ///< Number of buckets
+  int usedBuckets;       ///< Buckets with at least one node
+  float loadFactor;      ///< size / bucketCount
+  int maxChainLength;    ///< Longest chain
+  float avgChainLength;  ///< Average chain length over non-empty buckets
+  size_t bytesUsed;      ///< Table + bucket array + node memory
+  int chainHistogram[HISTOGRAM_BINS]; ///< Buckets per chain length
+};
+
 /**
  * @class HashMap
  * @brief A generic hash map implementation using separate chaining
  *
  * This class implements a hash table with separate chaining collision
  * resolution. It provides O(1) average-case complexity for insertion, lookup,
- * and deletion operations. The hash map automatically resizes when the load
- * factor exceeds a threshold (default 0.75).
+ * and deletion operations. The hash map automatically grows when the load
+ * factor exceeds a threshold (default 0.75) and halves its bucket array when
+ * erasures drop the load factor below a low-water mark (default 0.1875).
+ * The gap between the two marks means a shrink leaves the table at a load
+ * factor of about 0.375, so alternating inserts and erases never thrash.
  *
- * @tparam K The Key type - must be hashable via std::hash and support equality
- * comparison
+ * @tparam K The Key type - must be hashable via Hash and support equality
+ * comparison via KeyEqual
  * @tparam V the Value type - can be any type including pointers
+ * @tparam Hash Hash functor. std::string keys default to FastStringHash
+ * (see string_hash.h), every other key type to std::hash
+ * @tparam KeyEqual Equality functor used to match keys inside a chain
  *
  * Features:
  * - Automatic resizing when load factor exceeds threshold
+ * - Automatic shrinking after mass deletions, plus explicit shrinkToFit()
+ * - Rehashing relinks nodes, so pointers returned by get() stay valid
  * - Separate chaining for collision resolution
  * - Copy constructor and assignment operator deleted for safety
  *
@@ -43,7 +76,9 @@
  *  }
  * @endcode
  */
-template <typename K, typename V> class HashMap {
+template <typename K, typename V, typename Hash = DefaultHasher<K>,
+          typename KeyEqual = std::equal_to<K>>
+class HashMap {
 public:
   /**
    * @brief Default constructor
@@ -56,6 +91,16 @@ public:
    */
   HashMap();
 
+  /**
+   * @brief Construct with explicit hash and equality functors
+   *
+   * Only needed for stateful functors (e.g. a seeded hash).
+   *
+   * @param hasher The hash functor instance
+   * @param equal The key equality functor instance
+   */
+  explicit HashMap(const Hash &hasher, const KeyEqual &equal = KeyEqual());
+
   /**
    * @brief Destructor
    *
@@ -114,11 +159,13 @@ public:
    * @brief Remove a key-value pair
    *
    * Removes the entry with the specified key if it exists.
+   * If the removal drops the load factor below the low-water mark,
+   * the bucket array is halved.
    *
    * @param key The key to remove
    * @return true if key was found and removed, false otherwise
    *
-   * Time Complexity: O(1) average case, O(n) worst case
+   * Time Complexity: O(1) amortized, O(n) worst case (during shrink)
    * Space Complexity: O(1)
    */
   bool erase(const K &key);
@@ -155,14 +202,40 @@ public:
   /**
    * @brief Remove all entries from the map
    *
-   * Removes and deallocates all nodes, but retains the bucket array.
-   * Does not deallocate memory pointed to by stored pointers.
+   * Removes and deallocates all nodes and returns the bucket array to
+   * its initial capacity. Does not deallocate memory pointed to by stored
+   * pointers.
    *
-   * Time Complexity: O(n) where n is the number of elements
+   * Time Complexity: O(n + m) where m is the number of buckets
    * Space Complexity: O(1)
    */
   void clear();
 
+  /**
+   * @brief Shrink the bucket array to the smallest capacity that holds the
+   * current entries without exceeding the maximum load factor
+   *
+   * Useful after bulk removals (e.g. retiring many laptops), so that
+   * forEach no longer walks mostly empty buckets.
+   *
+   * Time Complexity: O(n + m) where m is the number of buckets
+   * Space Complexity: O(n)
+   */
+  void shrinkToFit();
+
+  /**
+   * @brief Grow the bucket array so that n entries fit without rehashing
+   *
+   * For bulk loads that know their size up front: one rehash instead of
+   * one per doubling. Never shrinks the table.
+   *
+   * @param n The number of entries to make room for
+   *
+   * Time Complexity: O(n + m) where m is the number of buckets
+   * Space Complexity: O(n)
+   */
+  void reserve(int n);
+
   /**
    * @brief Get the number of key-value pairs
    *
@@ -183,6 +256,18 @@ public:
    */
   bool empty() const { return size_ == 0; }
 
+  /**
+   * @brief Collect occupancy and chain-length statistics
+   *
+   * Walks every bucket once; meant for diagnostics, not hot paths.
+   *
+   * @return HashMapStats snapshot
+   *
+   * Time Complexity: O(n + m) where m is the number of buckets
+   * Space Complexity: O(1)
+   */
+  HashMapStats stats() const;
+
 private:
   /**
    * @struct Node
@@ -208,18 +293,33 @@ private:
   int capacity_;   ///< Current number of buckets
   int size_;       ///< Current number of key-value pairs
   float max_load_; ///< Maximum load factor before rehashing
+  float min_load_; ///< Load factor below which erase() halves the table
+  Hash hasher_;    ///< Hash functor
+  KeyEqual equal_; ///< Key equality functor
 
   /**
    * @brief Hash function for keys
    *
-   * Uses std::hash to compute hash value for the given key.
+   * Uses the Hash functor to compute hash value for the given key.
    *
    * @param key The key to hash
    * @return Hash value for the key
    *
-   * Time Complexity: O(1) for most types
+   * Time Complexity: O(1) for most types, O(length) for strings
    */
-  static size_t hash(const K &key);
+  size_t hash(const K &key) const;
+
+  static const int MIN_CAPACITY = 16; ///< Initial and minimum bucket count
+
+  /**
+   * @brief Allocate and null-initialise the bucket array
+   */
+  void initBuckets();
+
+  /**
+   * @brief Delete every node, leaving all buckets empty
+   */
+  void destroyNodes();
 
   /**
    * @brief Rehash the table with a new capacity
@@ -244,28 +344,52 @@ private:
    * Space Complexity: O(1) if no rehash needed, O(n) if rehashing
    */
   void ensureCapacity();
+
+  /**
+   * @brief Halve the table if the load factor fell below min_load_
+   *
+   * Time Complexity: O(1) if no rehash needed, O(n) if rehashing
+   */
+  void maybeShrink();
 };
 
 // ---------------- Implementation -------------------
 
-template <typename K, typename V>
-HashMap<K, V>::HashMap()
-    : buckets_(nullptr), capacity_(16), size_(0), max_load_(0.75f) {
+template <typename K, typename V, typename Hash, typename KeyEqual>
+HashMap<K, V, Hash, KeyEqual>::HashMap()
+    : buckets_(nullptr), capacity_(MIN_CAPACITY), size_(0), max_load_(0.75f),
+      min_load_(0.1875f) {
+  initBuckets();
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+HashMap<K, V, Hash, KeyEqual>::HashMap(const Hash &hasher,
+                                       const KeyEqual &equal)
+    : buckets_(nullptr), capacity_(MIN_CAPACITY), size_(0), max_load_(0.75f),
+      min_load_(0.1875f), hasher_(hasher), equal_(equal) {
+  initBuckets();
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+void HashMap<K, V, Hash, KeyEqual>::initBuckets() {
   buckets_ = new Node *[capacity_];
   for (int i = 0; i < capacity_; i++)
     buckets_[i] = nullptr;
 }
 
-template <typename K, typename V> HashMap<K, V>::~HashMap() {
-  clear();
+template <typename K, typename V, typename Hash, typename KeyEqual>
+HashMap<K, V, Hash, KeyEqual>::~HashMap() {
+  destroyNodes();
   delete[] buckets_;
 }
 
-template <typename K, typename V> size_t HashMap<K, V>::hash(const K &key) {
-  return std::hash<K>{}(key);
+template <typename K, typename V, typename Hash, typename KeyEqual>
+size_t HashMap<K, V, Hash, KeyEqual>::hash(const K &key) const {
+  return hasher_(key);
 }
 
-template <typename K, typename V> void HashMap<K, V>::rehash(const int newCap) {
+template <typename K, typename V, typename Hash, typename KeyEqual>
+void HashMap<K, V, Hash, KeyEqual>::rehash(const int newCap) {
   Node **newBuckets = new Node *[newCap];
   for (int i = 0; i < newCap; i++)
     newBuckets[i] = nullptr;
@@ -287,25 +411,53 @@ template <typename K, typename V> void HashMap<K, V>::rehash(const int newCap) {
   capacity_ = newCap;
 }
 
-template <typename K, typename V> void HashMap<K, V>::ensureCapacity() {
+template <typename K, typename V, typename Hash, typename KeyEqual>
+void HashMap<K, V, Hash, KeyEqual>::ensureCapacity() {
   const float lf = (capacity_ == 0) ? 1.0f
                                     : static_cast<float>(size_) /
                                           static_cast<float>(capacity_);
   if (lf > max_load_) {
     int newCap = capacity_ * 2;
-    if (newCap < 16)
-      newCap = 16;
+    if (newCap < MIN_CAPACITY)
+      newCap = MIN_CAPACITY;
     rehash(newCap);
   }
 }
 
-template <typename K, typename V>
-bool HashMap<K, V>::putNew(const K &key, const V &value) {
+template <typename K, typename V, typename Hash, typename KeyEqual>
+void HashMap<K, V, Hash, KeyEqual>::maybeShrink() {
+  if (capacity_ <= MIN_CAPACITY)
+    return;
+  const float lf = static_cast<float>(size_) / static_cast<float>(capacity_);
+  if (lf < min_load_)
+    rehash(capacity_ / 2);
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+void HashMap<K, V, Hash, KeyEqual>::shrinkToFit() {
+  int newCap = MIN_CAPACITY;
+  while (static_cast<float>(size_) > static_cast<float>(newCap) * max_load_)
+    newCap *= 2;
+  if (newCap < capacity_)
+    rehash(newCap);
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+void HashMap<K, V, Hash, KeyEqual>::reserve(const int n) {
+  int newCap = capacity_;
+  while (static_cast<float>(n) > static_cast<float>(newCap) * max_load_)
+    newCap *= 2;
+  if (newCap > capacity_)
+    rehash(newCap);
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+bool HashMap<K, V, Hash, KeyEqual>::putNew(const K &key, const V &value) {
   const size_t h = hash(key);
   int idx = static_cast<int>(h % capacity_);
   Node *cur = buckets_[idx];
   while (cur) {
-    if (cur->key == key)
+    if (equal_(cur->key, key))
       return false;
     cur = cur->next;
   }
@@ -317,31 +469,34 @@ bool HashMap<K, V>::putNew(const K &key, const V &value) {
   return true;
 }
 
-template <typename K, typename V> V *HashMap<K, V>::get(const K &key) const {
+template <typename K, typename V, typename Hash, typename KeyEqual>
+V *HashMap<K, V, Hash, KeyEqual>::get(const K &key) const {
   const size_t h = hash(key);
   int idx = static_cast<int>(h % capacity_);
   Node *cur = buckets_[idx];
   while (cur) {
-    if (cur->key == key)
+    if (equal_(cur->key, key))
       return &cur->val;
     cur = cur->next;
   }
   return nullptr;
 }
 
-template <typename K, typename V> bool HashMap<K, V>::erase(const K &key) {
+template <typename K, typename V, typename Hash, typename KeyEqual>
+bool HashMap<K, V, Hash, KeyEqual>::erase(const K &key) {
   const size_t h = hash(key);
   int idx = static_cast<int>(h % capacity_);
   Node *cur = buckets_[idx];
   Node *prev = nullptr;
   while (cur) {
-    if (cur->key == key) {
+    if (equal_(cur->key, key)) {
       if (prev)
         prev->next = cur->next;
       else
         buckets_[idx] = cur->next;
       delete cur;
       size_ -= 1;
+      maybeShrink();
       return true;
     }
     prev = cur;
@@ -350,11 +505,59 @@ template <typename K, typename V> bool HashMap<K, V>::erase(const K &key) {
   return false;
 }
 
-template <typename K, typename V> bool HashMap<K, V>::contains(const K &key) {
+template <typename K, typename V, typename Hash, typename KeyEqual>
+bool HashMap<K, V, Hash, KeyEqual>::contains(const K &key) {
   return get(key) != nullptr;
 }
 
-template <typename K, typename V> void HashMap<K, V>::clear() {
+template <typename K, typename V, typename Hash, typename KeyEqual>
+HashMapStats HashMap<K, V, Hash, KeyEqual>::stats() const {
+  HashMapStats st;
+  st.size = size_;
+  st.bucketCount = capacity_;
+  st.usedBuckets = 0;
+  st.maxChainLength = 0;
+  for (int b = 0; b < HashMapStats::HISTOGRAM_BINS; b++)
+    st.chainHistogram[b] = 0;
+
+  for (int i = 0; i < capacity_; i++) {
+    int len = 0;
+    for (Node *cur = buckets_[i]; cur; cur = cur->next)
+      len++;
+    if (len > 0)
+      st.usedBuckets++;
+    if (len > st.maxChainLength)
+      st.maxChainLength = len;
+    const int bin = len < HashMapStats::HISTOGRAM_BINS
+                        ? len
+                        : HashMapStats::HISTOGRAM_BINS - 1;
+    st.chainHistogram[bin]++;
+  }
+
+  st.loadFactor = capacity_ == 0 ? 0.0f
+                                 : static_cast<float>(size_) /
+                                       static_cast<float>(capacity_);
+  st.avgChainLength = st.usedBuckets == 0
+                          ? 0.0f
+                          : static_cast<float>(size_) /
+                                static_cast<float>(st.usedBuckets);
+  st.bytesUsed = sizeof(*this) + static_cast<size_t>(capacity_) * sizeof(Node *) +
+                 static_cast<size_t>(size_) * sizeof(Node);
+  return st;
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+void HashMap<K, V, Hash, KeyEqual>::clear() {
+  destroyNodes();
+  if (capacity_ > MIN_CAPACITY) {
+    delete[] buckets_;
+    capacity_ = MIN_CAPACITY;
+    initBuckets();
+  }
+}
+
+template <typename K, typename V, typename Hash, typename KeyEqual>
+void HashMap<K, V, Hash, KeyEqual>::destroyNodes() {
   for (int i = 0; i < capacity_; i++) {
     Node *cur = buckets_[i];
     while (cur) {
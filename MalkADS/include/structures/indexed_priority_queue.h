@@ -0,0 +1,255 @@
+#ifndef INDEXED_PRIORITY_QUEUE_H
+#define INDEXED_PRIORITY_QUEUE_H
+
+#include <cstdlib>
+#include <iostream>
+
+#include "priority_queue.h"
+using namespace std;
+
+// Binary heap whose elements can be re-prioritized or removed after insertion.
+// push() returns a handle that stays valid until that element is popped or
+// erased; handles of removed elements are recycled by later pushes.
+//
+// Elements live in a slot array that never moves them; the heap orders slot
+// indices, and each slot remembers its current heap position, so
+// update(handle) and erase(handle) can sift from the right place in O(log n).
+template <typename T, typename Comparator = DefaultComparator<T>>
+class IndexedPriorityQueue {
+private:
+  T *values;       // slot -> element
+  int *heapPos;    // slot -> index in heap, -1 if the slot is free
+  int *heap;       // heap index -> slot
+  int *freeSlots;  // stack of recycled slots
+  int capacity;
+  int currentSize;
+  int usedSlots;   // slots handed out at least once
+  int freeCount;
+  Comparator comp;
+
+  void resize();
+
+  bool higher(int i, int j) const {
+    return comp(values[heap[i]], values[heap[j]]);
+  }
+
+  void swapNodes(int i, int j);
+
+  void heapifyUp(int index);
+
+  void heapifyDown(int index);
+
+  void removeAt(int index);
+
+public:
+  IndexedPriorityQueue(int initialCapacity = 10);
+
+  ~IndexedPriorityQueue();
+
+  IndexedPriorityQueue(const IndexedPriorityQueue &) = delete;
+  IndexedPriorityQueue &operator=(const IndexedPriorityQueue &) = delete;
+
+  bool isEmpty() const { return currentSize == 0; }
+
+  int size() const { return currentSize; }
+
+  // Insert and return the element's handle. O(log n)
+  int push(const T &value);
+
+  // Highest-priority element / its handle. O(1)
+  const T &top() const;
+
+  int topHandle() const;
+
+  // Remove the highest-priority element. O(log n)
+  void pop();
+
+  // True if handle refers to an element still in the queue
+  bool contains(int handle) const {
+    return handle >= 0 && handle < usedSlots && heapPos[handle] >= 0;
+  }
+
+  // Element for a live handle
+  const T &get(int handle) const { return values[handle]; }
+
+  // Replace the element and restore heap order. O(log n)
+  bool update(int handle, const T &value);
+
+  // Remove the element. O(log n)
+  bool erase(int handle);
+
+  // Visit every (handle, element) in internal heap order
+  template <typename Func> void forEach(Func func) {
+    for (int i = 0; i < currentSize; i++)
+      func(heap[i], values[heap[i]]);
+  }
+
+  template <typename Func> void forEach(Func func) const {
+    for (int i = 0; i < currentSize; i++)
+      func(heap[i], static_cast<const T &>(values[heap[i]]));
+  }
+};
+
+template <typename T, typename Comparator>
+IndexedPriorityQueue<T, Comparator>::IndexedPriorityQueue(int initialCapacity) {
+  capacity = initialCapacity < 1 ? 1 : initialCapacity;
+  values = new T[capacity];
+  heapPos = new int[capacity];
+  heap = new int[capacity];
+  freeSlots = new int[capacity];
+  currentSize = 0;
+  usedSlots = 0;
+  freeCount = 0;
+}
+
+template <typename T, typename Comparator>
+IndexedPriorityQueue<T, Comparator>::~IndexedPriorityQueue() {
+  delete[] values;
+  delete[] heapPos;
+  delete[] heap;
+  delete[] freeSlots;
+}
+
+template <typename T, typename Comparator>
+void IndexedPriorityQueue<T, Comparator>::resize() {
+  int newCapacity = capacity * 2;
+  T *newValues = new T[newCapacity];
+  int *newHeapPos = new int[newCapacity];
+  int *newHeap = new int[newCapacity];
+  int *newFree = new int[newCapacity];
+  for (int i = 0; i < usedSlots; i++) {
+    newValues[i] = values[i];
+    newHeapPos[i] = heapPos[i];
+  }
+  for (int i = 0; i < currentSize; i++)
+    newHeap[i] = heap[i];
+  for (int i = 0; i < freeCount; i++)
+    newFree[i] = freeSlots[i];
+  delete[] values;
+  delete[] heapPos;
+  delete[] heap;
+  delete[] freeSlots;
+  values = newValues;
+  heapPos = newHeapPos;
+  heap = newHeap;
+  freeSlots = newFree;
+  capacity = newCapacity;
+}
+
+template <typename T, typename Comparator>
+void IndexedPriorityQueue<T, Comparator>::swapNodes(int i, int j) {
+  int tmp = heap[i];
+  heap[i] = heap[j];
+  heap[j] = tmp;
+  heapPos[heap[i]] = i;
+  heapPos[heap[j]] = j;
+}
+
+template <typename T, typename Comparator>
+void IndexedPriorityQueue<T, Comparator>::heapifyUp(int index) {
+  while (index > 0) {
+    int parent = (index - 1) / 2;
+    if (higher(index, parent)) {
+      swapNodes(index, parent);
+      index = parent;
+    } else
+      break;
+  }
+}
+
+template <typename T, typename Comparator>
+void IndexedPriorityQueue<T, Comparator>::heapifyDown(int index) {
+  while (true) {
+    int left = 2 * index + 1;
+    int right = 2 * index + 2;
+    int target = index;
+
+    if (left < currentSize && higher(left, target))
+      target = left;
+    if (right < currentSize && higher(right, target))
+      target = right;
+
+    if (target == index)
+      break;
+
+    swapNodes(index, target);
+    index = target;
+  }
+}
+
+// Move the last heap entry into index, then sift it whichever way it needs
+template <typename T, typename Comparator>
+void IndexedPriorityQueue<T, Comparator>::removeAt(int index) {
+  int slot = heap[index];
+  currentSize--;
+  if (index != currentSize) {
+    heap[index] = heap[currentSize];
+    heapPos[heap[index]] = index;
+    heapifyDown(index);
+    heapifyUp(index);
+  }
+  heapPos[slot] = -1;
+  values[slot] = T(); // release resources held by the element
+  freeSlots[freeCount++] = slot;
+}
+
+template <typename T, typename Comparator>
+int IndexedPriorityQueue<T, Comparator>::push(const T &value) {
+  int slot;
+  if (freeCount > 0) {
+    slot = freeSlots[--freeCount];
+  } else {
+    if (usedSlots == capacity)
+      resize();
+    slot = usedSlots++;
+  }
+  values[slot] = value;
+  heap[currentSize] = slot;
+  heapPos[slot] = currentSize;
+  heapifyUp(currentSize);
+  currentSize++;
+  return slot;
+}
+
+template <typename T, typename Comparator>
+const T &IndexedPriorityQueue<T, Comparator>::top() const {
+  if (isEmpty()) {
+    cerr << "IndexedPriorityQueue is empty!\n";
+    exit(EXIT_FAILURE);
+  }
+  return values[heap[0]];
+}
+
+template <typename T, typename Comparator>
+int IndexedPriorityQueue<T, Comparator>::topHandle() const {
+  return isEmpty() ? -1 : heap[0];
+}
+
+template <typename T, typename Comparator>
+void IndexedPriorityQueue<T, Comparator>::pop() {
+  if (isEmpty()) {
+    cerr << "IndexedPriorityQueue is empty!\n";
+    return;
+  }
+  removeAt(0);
+}
+
+template <typename T, typename Comparator>
+bool IndexedPriorityQueue<T, Comparator>::update(int handle, const T &value) {
+  if (!contains(handle))
+    return false;
+  values[handle] = value;
+  heapifyUp(heapPos[handle]);
+  heapifyDown(heapPos[handle]);
+  return true;
+}
+
+template <typename T, typename Comparator>
+bool IndexedPriorityQueue<T, Comparator>::erase(int handle) {
+  if (!contains(handle))
+    return false;
+  removeAt(heapPos[handle]);
+  return true;
+}
+
+#endif // INDEXED_PRIORITY_QUEUE_H
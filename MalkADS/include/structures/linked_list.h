@@ -1,71 +1,189 @@
 #ifndef LINKED_LIST_H
 #define LINKED_LIST_H
 
-#include <iostream>
+#include <cstdint>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+using namespace std;
+
+// Unrolled linked list: elements are stored BlockSize at a time in a
+// doubly-linked chain of blocks, so a scan touches one cache line run per
+// block instead of one heap node per element.
+//
+// push_back is O(1) through a tail pointer; erase(iterator) is O(1).
+// Elements never move once inserted: a removal leaves a hole in its block
+// (tracked in the block's live mask) and a block is freed once it is empty,
+// so iterators and pointers to other elements stay valid across any
+// push_back or erase. New elements always go after the last one, so the
+// list keeps insertion order.
+template <typename T, int BlockSize = 16> class LinkedList {
+  static_assert(BlockSize > 0 && BlockSize <= 32,
+                "BlockSize must fit the 32-bit live mask");
 
-template <typename T> class LinkedList {
 private:
-  struct Node {
-    T data;
-    Node *next;
-    Node(T val) : data(val), next(nullptr) {}
+  struct Block {
+    typename aligned_storage<sizeof(T), alignof(T)>::type slots[BlockSize];
+    uint32_t live; // bit i set if slots[i] holds an element
+    int used;      // slots [0, used) have been handed out
+    Block *prev;
+    Block *next;
+
+    Block() : live(0), used(0), prev(nullptr), next(nullptr) {}
+
+    T *at(int i) { return reinterpret_cast<T *>(&slots[i]); }
   };
 
-  Node *head;
+  Block *head;
+  Block *tail;
   int size_;
 
+  // First live slot at or after index i in block b, or BlockSize
+  static int nextLive(const Block *b, int i) {
+    while (i < BlockSize && !(b->live & (1u << i)))
+      i++;
+    return i;
+  }
+
+  // Slot for a new element at the end of the list
+  T *claimSlot(Block *&block, int &index) {
+    if (!tail || tail->used == BlockSize) {
+      Block *b = new Block();
+      b->prev = tail;
+      if (tail)
+        tail->next = b;
+      else
+        head = b;
+      tail = b;
+    }
+    block = tail;
+    index = tail->used++;
+    return tail->at(index);
+  }
+
+  void unlink(Block *b) {
+    if (b->prev)
+      b->prev->next = b->next;
+    else
+      head = b->next;
+    if (b->next)
+      b->next->prev = b->prev;
+    else
+      tail = b->prev;
+    delete b;
+  }
+
 public:
-  LinkedList() : head(nullptr), size_(0) {}
+  class iterator {
+  public:
+    iterator() : block(nullptr), index(0) {}
 
-  ~LinkedList() { clear(); }
+    T &operator*() const { return *block->at(index); }
+    T *operator->() const { return block->at(index); }
 
-  void push_back(const T &value) {
-    Node *newNode = new Node(value);
-    if (!head) {
-      head = newNode;
-    } else {
-      Node *current = head;
-      while (current->next) {
-        current = current->next;
+    iterator &operator++() {
+      index = nextLive(block, index + 1);
+      while (index == BlockSize) {
+        block = block->next;
+        if (!block) {
+          index = 0;
+          break;
+        }
+        index = nextLive(block, 0);
       }
-      current->next = newNode;
+      return *this;
     }
+
+    bool operator==(const iterator &o) const {
+      return block == o.block && index == o.index;
+    }
+    bool operator!=(const iterator &o) const { return !(*this == o); }
+
+  private:
+    friend class LinkedList;
+    iterator(Block *b, int i) : block(b), index(i) {}
+
+    Block *block;
+    int index;
+  };
+
+  LinkedList() : head(nullptr), tail(nullptr), size_(0) {}
+
+  ~LinkedList() { clear(); }
+
+  LinkedList(const LinkedList &) = delete;
+  LinkedList &operator=(const LinkedList &) = delete;
+
+  LinkedList(LinkedList &&other)
+      : head(other.head), tail(other.tail), size_(other.size_) {
+    other.head = other.tail = nullptr;
+    other.size_ = 0;
+  }
+
+  LinkedList &operator=(LinkedList &&other) {
+    if (this != &other) {
+      clear();
+      head = other.head;
+      tail = other.tail;
+      size_ = other.size_;
+      other.head = other.tail = nullptr;
+      other.size_ = 0;
+    }
+    return *this;
+  }
+
+  template <typename... Args> T &emplace_back(Args &&...args) {
+    Block *block;
+    int index;
+    T *slot = claimSlot(block, index);
+    new (slot) T(std::forward<Args>(args)...);
+    block->live |= 1u << index;
     size_++;
+    return *slot;
+  }
+
+  void push_back(const T &value) { emplace_back(value); }
+
+  void push_back(T &&value) { emplace_back(std::move(value)); }
+
+  // Remove the element at it; returns an iterator to the next element
+  iterator erase(iterator it) {
+    iterator next = it;
+    ++next;
+    Block *b = it.block;
+    b->at(it.index)->~T();
+    b->live &= ~(1u << it.index);
+    size_--;
+    // A block with no live elements and no room left is dead weight
+    if (b->live == 0 && (b->used == BlockSize || b != tail))
+      unlink(b);
+    return next;
   }
 
   // Remove the first occurrence of value
   bool remove(const T &value) {
-    if (!head)
-      return false;
-
-    if (head->data == value) {
-      Node *temp = head;
-      head = head->next;
-      delete temp;
-      size_--;
-      return true;
-    }
-
-    Node *current = head;
-    while (current->next) {
-      if (current->next->data == value) {
-        Node *temp = current->next;
-        current->next = current->next->next;
-        delete temp;
-        size_--;
-        return true;
+    for (Block *b = head; b; b = b->next) {
+      for (int i = nextLive(b, 0); i < BlockSize; i = nextLive(b, i + 1)) {
+        if (*b->at(i) == value) {
+          erase(iterator(b, i));
+          return true;
+        }
       }
-      current = current->next;
     }
     return false;
   }
 
   void clear() {
-    while (head) {
-      Node *temp = head;
-      head = head->next;
-      delete temp;
+    Block *b = head;
+    while (b) {
+      for (int i = nextLive(b, 0); i < BlockSize; i = nextLive(b, i + 1))
+        b->at(i)->~T();
+      Block *next = b->next;
+      delete b;
+      b = next;
     }
+    head = tail = nullptr;
     size_ = 0;
   }
 
@@ -73,22 +191,29 @@ public:
 
   bool empty() const { return size_ == 0; }
 
-  template <typename Func> void forEach(Func func) const {
-    Node *current = head;
-    while (current) {
-      func(current->data);
-      current = current->next;
+  iterator begin() {
+    for (Block *b = head; b; b = b->next) {
+      int i = nextLive(b, 0);
+      if (i < BlockSize)
+        return iterator(b, i);
     }
+    return end();
+  }
+
+  iterator end() { return iterator(nullptr, 0); }
+
+  template <typename Func> void forEach(Func func) const {
+    for (Block *b = head; b; b = b->next)
+      for (int i = nextLive(b, 0); i < BlockSize; i = nextLive(b, i + 1))
+        func(*reinterpret_cast<const T *>(&b->slots[i]));
   }
 
   // Check if value exists
   bool contains(const T &value) const {
-    Node *current = head;
-    while (current) {
-      if (current->data == value)
-        return true;
-      current = current->next;
-    }
+    for (Block *b = head; b; b = b->next)
+      for (int i = nextLive(b, 0); i < BlockSize; i = nextLive(b, i + 1))
+        if (*reinterpret_cast<const T *>(&b->slots[i]) == value)
+          return true;
     return false;
   }
 };
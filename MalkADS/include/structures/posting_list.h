@@ -0,0 +1,73 @@
+#ifndef POSTING_LIST_H
+#define POSTING_LIST_H
+
+using namespace std;
+
+// Unordered set of compact integer IDs stored in one contiguous array.
+//
+// append() is amortized O(1) and returns the position the ID landed at.
+// removeAt() is O(1): the last ID is moved into the hole, so callers that
+// keep each element's position (a back-pointer) must update the moved one,
+// which removeAt() returns. Iteration is a linear scan of plain ints.
+class PostingList {
+private:
+  int *ids;
+  int count;
+  int cap;
+
+  void grow() {
+    int newCap = cap * 2;
+    int *newIds = new int[newCap];
+    for (int i = 0; i < count; i++)
+      newIds[i] = ids[i];
+    delete[] ids;
+    ids = newIds;
+    cap = newCap;
+  }
+
+public:
+  explicit PostingList(int initialCapacity = 4) : count(0) {
+    cap = initialCapacity < 1 ? 1 : initialCapacity;
+    ids = new int[cap];
+  }
+
+  ~PostingList() { delete[] ids; }
+
+  PostingList(const PostingList &) = delete;
+  PostingList &operator=(const PostingList &) = delete;
+
+  // Add id and return its position
+  int append(int id) {
+    if (count == cap)
+      grow();
+    ids[count] = id;
+    return count++;
+  }
+
+  // Remove the ID at pos by moving the last ID into its place. Returns the
+  // ID now at pos, or -1 if pos was the last position (nothing moved).
+  int removeAt(int pos) {
+    if (pos < 0 || pos >= count)
+      return -1;
+    count--;
+    if (pos == count)
+      return -1;
+    ids[pos] = ids[count];
+    return ids[pos];
+  }
+
+  int at(int pos) const { return ids[pos]; }
+
+  int size() const { return count; }
+
+  bool empty() const { return count == 0; }
+
+  void clear() { count = 0; }
+
+  template <typename Func> void forEach(Func func) const {
+    for (int i = 0; i < count; i++)
+      func(ids[i]);
+  }
+};
+
+#endif // POSTING_LIST_H
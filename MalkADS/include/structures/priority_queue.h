@@ -1,125 +1,242 @@
 #ifndef PRIORITY_QUEUE_H
 #define PRIORITY_QUEUE_H
 
+#include <cstdlib>
 #include <iostream>
+#include <new>
+#include <utility>
 using namespace std;
 
 template <typename T> struct DefaultComparator {
   bool operator()(const T &a, const T &b) const { return a < b; }
 };
 
-template <typename T, typename Comparator = DefaultComparator<T>>
+// d-ary heap. Arity 4 halves the tree height of a binary heap and keeps each
+// node's children in one or two cache lines, which pays off for larger T.
+//
+// Storage is raw memory: only the first currentSize slots hold constructed
+// elements, so an empty queue with a large capacity constructs nothing, and
+// growing or sifting moves elements instead of copying them.
+template <typename T, typename Comparator = DefaultComparator<T>,
+          int Arity = 4>
 class PriorityQueue {
+  static_assert(Arity >= 2, "PriorityQueue arity must be at least 2");
+
 private:
   T *heapArray;
   int capacity;
   int currentSize;
   Comparator comp;
 
-  void resize();
+  static T *allocate(int n) {
+    return static_cast<T *>(::operator new(sizeof(T) * n));
+  }
+
+  void destroyAll();
+
+  void resize(int newCapacity);
 
   void heapifyUp(int index);
 
   void heapifyDown(int index);
 
+  void heapifyAll();
+
 public:
   PriorityQueue(int initialCapacity = 10);
 
+  // Build from [first, last) with Floyd's bottom-up heapify, O(n)
+  template <typename InputIt> PriorityQueue(InputIt first, InputIt last);
+
   ~PriorityQueue();
 
+  PriorityQueue(const PriorityQueue &) = delete;
+  PriorityQueue &operator=(const PriorityQueue &) = delete;
+
   bool isEmpty() const;
 
   int size() const;
 
+  // Make room for at least n elements without further reallocation
+  void reserve(int n);
+
   void push(const T &value);
 
-  T top() const;
+  void push(T &&value);
+
+  // Construct the element in place from args
+  template <typename... Args> void emplace(Args &&...args);
+
+  // Replace the contents with [first, last), O(n)
+  template <typename InputIt> void assign(InputIt first, InputIt last);
+
+  const T &top() const;
 
-  void pop();
+  // Remove and return the highest-priority element (moved out)
+  T pop();
+
+  void clear();
 
   void printHeap() const;
+
+  // Visit every element in internal heap order (not priority order)
+  template <typename Func> void forEach(Func func) {
+    for (int i = 0; i < currentSize; i++)
+      func(heapArray[i]);
+  }
+
+  template <typename Func> void forEach(Func func) const {
+    for (int i = 0; i < currentSize; i++)
+      func(static_cast<const T &>(heapArray[i]));
+  }
 };
 
-template <typename T, typename Comparator>
-PriorityQueue<T, Comparator>::PriorityQueue(int initialCapacity) {
-  capacity = initialCapacity;
-  heapArray = new T[capacity];
+template <typename T, typename Comparator, int Arity>
+PriorityQueue<T, Comparator, Arity>::PriorityQueue(int initialCapacity) {
+  capacity = initialCapacity < 1 ? 1 : initialCapacity;
+  heapArray = allocate(capacity);
   currentSize = 0;
 }
 
-template <typename T, typename Comparator>
-PriorityQueue<T, Comparator>::~PriorityQueue() {
-  delete[] heapArray;
+template <typename T, typename Comparator, int Arity>
+template <typename InputIt>
+PriorityQueue<T, Comparator, Arity>::PriorityQueue(InputIt first,
+                                                   InputIt last) {
+  capacity = 10;
+  heapArray = allocate(capacity);
+  currentSize = 0;
+  assign(first, last);
 }
 
-template <typename T, typename Comparator>
-void PriorityQueue<T, Comparator>::resize() {
-  int newCapacity = capacity * 2;
-  T *newArray = new T[newCapacity];
+template <typename T, typename Comparator, int Arity>
+PriorityQueue<T, Comparator, Arity>::~PriorityQueue() {
+  destroyAll();
+  ::operator delete(heapArray);
+}
+
+template <typename T, typename Comparator, int Arity>
+void PriorityQueue<T, Comparator, Arity>::destroyAll() {
   for (int i = 0; i < currentSize; i++)
-    newArray[i] = heapArray[i];
-  delete[] heapArray;
+    heapArray[i].~T();
+  currentSize = 0;
+}
+
+template <typename T, typename Comparator, int Arity>
+void PriorityQueue<T, Comparator, Arity>::resize(int newCapacity) {
+  T *newArray = allocate(newCapacity);
+  for (int i = 0; i < currentSize; i++) {
+    new (&newArray[i]) T(std::move(heapArray[i]));
+    heapArray[i].~T();
+  }
+  ::operator delete(heapArray);
   heapArray = newArray;
   capacity = newCapacity;
 }
 
-template <typename T, typename Comparator>
-void PriorityQueue<T, Comparator>::heapifyUp(int index) {
+// Sift with a "hole": the moving element is held aside and each parent is
+// moved down once, instead of swapping at every level.
+template <typename T, typename Comparator, int Arity>
+void PriorityQueue<T, Comparator, Arity>::heapifyUp(int index) {
+  if (index == 0)
+    return;
+  T value(std::move(heapArray[index]));
   while (index > 0) {
-    int parent = (index - 1) / 2;
-    if (comp(heapArray[index], heapArray[parent])) {
-      swap(heapArray[index], heapArray[parent]);
-      index = parent;
-    } else
+    int parent = (index - 1) / Arity;
+    if (!comp(value, heapArray[parent]))
       break;
+    heapArray[index] = std::move(heapArray[parent]);
+    index = parent;
   }
+  heapArray[index] = std::move(value);
 }
 
-template <typename T, typename Comparator>
-void PriorityQueue<T, Comparator>::heapifyDown(int index) {
-  while (true) {
-    int left = 2 * index + 1;
-    int right = 2 * index + 2;
-    int target = index;
-
-    if (left < currentSize && comp(heapArray[left], heapArray[target]))
-      target = left;
-    if (right < currentSize && comp(heapArray[right], heapArray[target]))
-      target = right;
-
-    if (target == index)
+template <typename T, typename Comparator, int Arity>
+void PriorityQueue<T, Comparator, Arity>::heapifyDown(int index) {
+  int firstChild = Arity * index + 1;
+  if (firstChild >= currentSize)
+    return;
+  T value(std::move(heapArray[index]));
+  while (firstChild < currentSize) {
+    int lastChild = firstChild + Arity;
+    if (lastChild > currentSize)
+      lastChild = currentSize;
+    int best = firstChild;
+    for (int c = firstChild + 1; c < lastChild; c++)
+      if (comp(heapArray[c], heapArray[best]))
+        best = c;
+    if (!comp(heapArray[best], value))
       break;
-
-    swap(heapArray[index], heapArray[target]);
-    index = target;
+    heapArray[index] = std::move(heapArray[best]);
+    index = best;
+    firstChild = Arity * index + 1;
   }
+  heapArray[index] = std::move(value);
+}
+
+template <typename T, typename Comparator, int Arity>
+void PriorityQueue<T, Comparator, Arity>::heapifyAll() {
+  for (int i = (currentSize - 2) / Arity; i >= 0; i--)
+    heapifyDown(i);
 }
 
 // Check empty
-template <typename T, typename Comparator>
-bool PriorityQueue<T, Comparator>::isEmpty() const {
+template <typename T, typename Comparator, int Arity>
+bool PriorityQueue<T, Comparator, Arity>::isEmpty() const {
   return currentSize == 0;
 }
 
 // Size
-template <typename T, typename Comparator>
-int PriorityQueue<T, Comparator>::size() const {
+template <typename T, typename Comparator, int Arity>
+int PriorityQueue<T, Comparator, Arity>::size() const {
   return currentSize;
 }
 
+// Reserve
+template <typename T, typename Comparator, int Arity>
+void PriorityQueue<T, Comparator, Arity>::reserve(int n) {
+  if (n > capacity)
+    resize(n);
+}
+
 // Push
-template <typename T, typename Comparator>
-void PriorityQueue<T, Comparator>::push(const T &value) {
+template <typename T, typename Comparator, int Arity>
+void PriorityQueue<T, Comparator, Arity>::push(const T &value) {
+  emplace(value);
+}
+
+template <typename T, typename Comparator, int Arity>
+void PriorityQueue<T, Comparator, Arity>::push(T &&value) {
+  emplace(std::move(value));
+}
+
+// Emplace
+template <typename T, typename Comparator, int Arity>
+template <typename... Args>
+void PriorityQueue<T, Comparator, Arity>::emplace(Args &&...args) {
   if (currentSize == capacity)
-    resize();
-  heapArray[currentSize] = value;
-  heapifyUp(currentSize);
+    resize(capacity * 2);
+  new (&heapArray[currentSize]) T(std::forward<Args>(args)...);
   currentSize++;
+  heapifyUp(currentSize - 1);
+}
+
+// Assign from range
+template <typename T, typename Comparator, int Arity>
+template <typename InputIt>
+void PriorityQueue<T, Comparator, Arity>::assign(InputIt first, InputIt last) {
+  destroyAll();
+  for (; first != last; ++first) {
+    if (currentSize == capacity)
+      resize(capacity * 2);
+    new (&heapArray[currentSize]) T(*first);
+    currentSize++;
+  }
+  heapifyAll();
 }
 
 // Top
-template <typename T, typename Comparator>
-T PriorityQueue<T, Comparator>::top() const {
+template <typename T, typename Comparator, int Arity>
+const T &PriorityQueue<T, Comparator, Arity>::top() const {
   if (isEmpty()) {
     cerr << "PriorityQueue is empty!\n";
     exit(EXIT_FAILURE);
@@ -128,20 +245,33 @@ T PriorityQueue<T, Comparator>::top() const {
 }
 
 // Pop
-template <typename T, typename Comparator>
-void PriorityQueue<T, Comparator>::pop() {
+template <typename T, typename Comparator, int Arity>
+T PriorityQueue<T, Comparator, Arity>::pop() {
   if (isEmpty()) {
     cerr << "PriorityQueue is empty!\n";
-    return;
+    exit(EXIT_FAILURE); // no element to return, same as top()
   }
-  heapArray[0] = heapArray[currentSize - 1];
+  T result(std::move(heapArray[0]));
   currentSize--;
-  heapifyDown(0);
+  if (currentSize > 0) {
+    heapArray[0] = std::move(heapArray[currentSize]);
+    heapArray[currentSize].~T();
+    heapifyDown(0);
+  } else {
+    heapArray[0].~T();
+  }
+  return result;
+}
+
+// Clear
+template <typename T, typename Comparator, int Arity>
+void PriorityQueue<T, Comparator, Arity>::clear() {
+  destroyAll();
 }
 
 // Print
-template <typename T, typename Comparator>
-void PriorityQueue<T, Comparator>::printHeap() const {
+template <typename T, typename Comparator, int Arity>
+void PriorityQueue<T, Comparator, Arity>::printHeap() const {
   cout << "Heap elements: ";
   for (int i = 0; i < currentSize; i++)
     cout << heapArray[i] << " ";
@@ -0,0 +1,284 @@
+#ifndef RADIX_TRIE_H
+#define RADIX_TRIE_H
+
+#include <string>
+
+using namespace std;
+
+// Compressed (radix) trie of string keys for prefix completion.
+//
+// Each key has a weight: the number of times it was inserted minus the
+// number of times it was removed, and it disappears at zero. Every node
+// caches the best topN keys below it (higher weight first, then
+// alphabetical), so completing a prefix is O(|prefix| + n) no matter how
+// many keys share the prefix. insert() and remove() walk one root-to-key
+// path. An insert only raises one key, so it just moves that key up each
+// list on the path, in O(|key| + depth * topN). A removal rebuilds the
+// lists from the children's lists, in O(|key| + depth * fanout * topN).
+class RadixTrie {
+private:
+  struct Node {
+    string edge; // label on the edge from the parent
+    Node **children;
+    int childCount;
+    int childCap;
+
+    // Terminal data, meaningful when weight > 0
+    string key;     // the full key
+    string display; // what to show for it (first inserted form)
+    int weight;
+
+    Node **top; // best keys in this subtree, best first
+    int topCount;
+
+    Node(const string &label, int topN)
+        : edge(label), children(nullptr), childCount(0), childCap(0),
+          weight(0), top(new Node *[topN]), topCount(0) {}
+
+    ~Node() {
+      for (int i = 0; i < childCount; i++)
+        delete children[i];
+      delete[] children;
+      delete[] top;
+    }
+  };
+
+  Node *root;
+  int topN;
+  int keyCount;
+
+  // a ranks above b
+  static bool better(const Node *a, const Node *b) {
+    if (a->weight != b->weight)
+      return a->weight > b->weight;
+    return a->key < b->key;
+  }
+
+  static Node *findChild(Node *node, char c) {
+    for (int i = 0; i < node->childCount; i++)
+      if (node->children[i]->edge[0] == c)
+        return node->children[i];
+    return nullptr;
+  }
+
+  // Children stay sorted by first character
+  static void addChild(Node *node, Node *child) {
+    if (node->childCount == node->childCap) {
+      int newCap = node->childCap ? node->childCap * 2 : 2;
+      Node **grown = new Node *[newCap];
+      for (int i = 0; i < node->childCount; i++)
+        grown[i] = node->children[i];
+      delete[] node->children;
+      node->children = grown;
+      node->childCap = newCap;
+    }
+    int pos = node->childCount;
+    while (pos > 0 && node->children[pos - 1]->edge[0] > child->edge[0]) {
+      node->children[pos] = node->children[pos - 1];
+      pos--;
+    }
+    node->children[pos] = child;
+    node->childCount++;
+  }
+
+  static void replaceChild(Node *node, Node *oldChild, Node *newChild) {
+    for (int i = 0; i < node->childCount; i++)
+      if (node->children[i] == oldChild)
+        node->children[i] = newChild;
+  }
+
+  static void removeChild(Node *node, Node *child) {
+    int i = 0;
+    while (i < node->childCount && node->children[i] != child)
+      i++;
+    for (; i + 1 < node->childCount; i++)
+      node->children[i] = node->children[i + 1];
+    node->childCount--;
+  }
+
+  void offer(Node *node, Node *candidate) {
+    if (node->topCount == topN && !better(candidate, node->top[topN - 1]))
+      return;
+    int pos = node->topCount < topN ? node->topCount++ : topN - 1;
+    while (pos > 0 && better(candidate, node->top[pos - 1])) {
+      node->top[pos] = node->top[pos - 1];
+      pos--;
+    }
+    node->top[pos] = candidate;
+  }
+
+  // Rebuild node's cached list from its own key and its children's lists
+  void refresh(Node *node) {
+    node->topCount = 0;
+    if (node->weight > 0)
+      offer(node, node);
+    for (int c = 0; c < node->childCount; c++) {
+      Node *child = node->children[c];
+      for (int i = 0; i < child->topCount; i++)
+        offer(node, child->top[i]);
+    }
+  }
+
+  // key's weight went up, so it can only rise in node's list: move it up,
+  // or offer it if it was not listed
+  void promote(Node *node, Node *key) {
+    int pos = 0;
+    while (pos < node->topCount && node->top[pos] != key)
+      pos++;
+    if (pos == node->topCount) {
+      offer(node, key);
+      return;
+    }
+    while (pos > 0 && better(key, node->top[pos - 1])) {
+      node->top[pos] = node->top[pos - 1];
+      pos--;
+    }
+    node->top[pos] = key;
+  }
+
+  // Returns the node that holds key
+  Node *insertAt(Node *node, const string &key, size_t i,
+                 const string &display) {
+    if (i == key.size()) {
+      if (node->weight == 0) {
+        node->key = key;
+        node->display = display;
+        keyCount++;
+      }
+      node->weight++;
+      promote(node, node);
+      return node;
+    }
+
+    Node *child = findChild(node, key[i]);
+    if (!child) {
+      child = new Node(key.substr(i), topN);
+      addChild(node, child);
+      Node *terminal = insertAt(child, key, key.size(), display);
+      promote(node, terminal);
+      return terminal;
+    }
+
+    size_t common = 0;
+    while (common < child->edge.size() && i + common < key.size() &&
+           child->edge[common] == key[i + common])
+      common++;
+
+    if (common < child->edge.size()) {
+      // Split the edge; the old child keeps its identity below the split
+      Node *mid = new Node(child->edge.substr(0, common), topN);
+      child->edge = child->edge.substr(common);
+      replaceChild(node, child, mid);
+      addChild(mid, child);
+      refresh(mid);
+      child = mid;
+    }
+
+    Node *terminal = insertAt(child, key, i + common, display);
+    promote(node, terminal);
+    return terminal;
+  }
+
+  bool removeAt(Node *node, const string &key, size_t i) {
+    if (i == key.size()) {
+      if (node->weight == 0)
+        return false;
+      if (--node->weight == 0) {
+        node->key.clear();
+        node->display.clear();
+        keyCount--;
+      }
+      refresh(node);
+      return true;
+    }
+
+    Node *child = findChild(node, key[i]);
+    if (!child || key.compare(i, child->edge.size(), child->edge) != 0)
+      return false;
+    if (!removeAt(child, key, i + child->edge.size()))
+      return false;
+
+    // Keep the trie compressed: drop empty leaves, fold pass-through nodes
+    if (child->weight == 0 && child->childCount == 0) {
+      removeChild(node, child);
+      delete child;
+    } else if (child->weight == 0 && child->childCount == 1) {
+      Node *grandchild = child->children[0];
+      grandchild->edge = child->edge + grandchild->edge;
+      replaceChild(node, child, grandchild);
+      child->childCount = 0;
+      delete child;
+    }
+    refresh(node);
+    return true;
+  }
+
+public:
+  explicit RadixTrie(int topN = 10)
+      : topN(topN > 0 ? topN : 1), keyCount(0) {
+    root = new Node("", this->topN);
+  }
+
+  ~RadixTrie() { delete root; }
+
+  RadixTrie(const RadixTrie &) = delete;
+  RadixTrie &operator=(const RadixTrie &) = delete;
+
+  // Add one occurrence of key. display is what completions report for it
+  // (kept from the first insertion).
+  void insert(const string &key, const string &display) {
+    if (!key.empty())
+      insertAt(root, key, 0, display);
+  }
+
+  // Remove one occurrence of key. Returns false if it was not present.
+  bool remove(const string &key) {
+    return !key.empty() && removeAt(root, key, 0);
+  }
+
+  // Weight of key, 0 if absent
+  int weight(const string &key) const {
+    Node *node = root;
+    size_t i = 0;
+    while (i < key.size()) {
+      node = findChild(node, key[i]);
+      if (!node || key.compare(i, node->edge.size(), node->edge) != 0)
+        return 0;
+      i += node->edge.size();
+    }
+    return node->weight;
+  }
+
+  // Best min(n, topN) keys starting with prefix, best first, as
+  // func(display, weight). Returns the number reported.
+  template <typename Func>
+  int complete(const string &prefix, int n, Func func) const {
+    Node *node = root;
+    size_t i = 0;
+    while (i < prefix.size()) {
+      node = findChild(node, prefix[i]);
+      if (!node)
+        return 0;
+      // The prefix may end part way along this edge
+      size_t m = node->edge.size();
+      if (prefix.size() - i < m)
+        m = prefix.size() - i;
+      if (prefix.compare(i, m, node->edge, 0, m) != 0)
+        return 0;
+      i += m;
+    }
+
+    int count = n < node->topCount ? n : node->topCount;
+    for (int k = 0; k < count; k++)
+      func(static_cast<const string &>(node->top[k]->display),
+           node->top[k]->weight);
+    return count < 0 ? 0 : count;
+  }
+
+  // Number of distinct keys
+  int size() const { return keyCount; }
+
+  int capacity() const { return topN; }
+};
+
+#endif // RADIX_TRIE_H
@@ -0,0 +1,300 @@
+#ifndef RING_BUFFER_H
+#define RING_BUFFER_H
+
+#include <atomic>
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+using namespace std;
+
+// Bounded lock-free FIFO queues for handing requests from front ends to a
+// single consumer thread.
+//
+// Both queues have a fixed power-of-two capacity chosen at construction and
+// never allocate afterwards; a push into a full queue fails instead of
+// growing. Elements live in raw storage, so T needs no default constructor.
+// The producer-side and consumer-side indices sit on separate cache lines so
+// the two ends do not invalidate each other's line on every operation.
+
+namespace ring_buffer_detail {
+inline int roundUpPow2(int n) {
+  int cap = 2;
+  while (cap < n)
+    cap *= 2;
+  return cap;
+}
+} // namespace ring_buffer_detail
+
+// One producer thread, one consumer thread.
+template <typename T> class SpscRingBuffer {
+public:
+  explicit SpscRingBuffer(int minCapacity = 1024)
+      : cap(ring_buffer_detail::roundUpPow2(minCapacity)),
+        mask(static_cast<size_t>(cap) - 1), head(0), cachedTail(0), tail(0),
+        cachedHead(0) {
+    slots = static_cast<T *>(::operator new(sizeof(T) * cap));
+  }
+
+  ~SpscRingBuffer() {
+    size_t t = tail.load(memory_order_acquire);
+    for (size_t h = head.load(memory_order_relaxed); h != t; h++)
+      slots[h & mask].~T();
+    ::operator delete(slots);
+  }
+
+  SpscRingBuffer(const SpscRingBuffer &) = delete;
+  SpscRingBuffer &operator=(const SpscRingBuffer &) = delete;
+
+  // Producer side. Returns false if the queue is full.
+  template <typename... Args> bool tryEmplace(Args &&...args) {
+    const size_t t = tail.load(memory_order_relaxed);
+    if (t - cachedHead == static_cast<size_t>(cap)) {
+      cachedHead = head.load(memory_order_acquire);
+      if (t - cachedHead == static_cast<size_t>(cap))
+        return false;
+    }
+    new (&slots[t & mask]) T(std::forward<Args>(args)...);
+    tail.store(t + 1, memory_order_release);
+    return true;
+  }
+
+  bool tryPush(const T &value) { return tryEmplace(value); }
+
+  bool tryPush(T &&value) { return tryEmplace(std::move(value)); }
+
+  // Producer side. Pushes as many of items[0..count) as fit and publishes
+  // them together. Returns the number pushed.
+  int tryPushBatch(const T *items, int count) {
+    const size_t t = tail.load(memory_order_relaxed);
+    size_t room = cap - (t - cachedHead);
+    if (room < static_cast<size_t>(count)) {
+      cachedHead = head.load(memory_order_acquire);
+      room = cap - (t - cachedHead);
+    }
+    int n = room < static_cast<size_t>(count) ? static_cast<int>(room) : count;
+    for (int i = 0; i < n; i++)
+      new (&slots[(t + i) & mask]) T(items[i]);
+    if (n > 0)
+      tail.store(t + n, memory_order_release);
+    return n;
+  }
+
+  // Consumer side. Returns false if the queue is empty.
+  bool tryPop(T &out) {
+    const size_t h = head.load(memory_order_relaxed);
+    if (h == cachedTail) {
+      cachedTail = tail.load(memory_order_acquire);
+      if (h == cachedTail)
+        return false;
+    }
+    T &slot = slots[h & mask];
+    out = std::move(slot);
+    slot.~T();
+    head.store(h + 1, memory_order_release);
+    return true;
+  }
+
+  // Consumer side. Moves up to maxCount elements into out, frees their
+  // slots together, and returns how many were taken.
+  int tryPopBatch(T *out, int maxCount) {
+    const size_t h = head.load(memory_order_relaxed);
+    size_t available = cachedTail - h;
+    if (available < static_cast<size_t>(maxCount)) {
+      cachedTail = tail.load(memory_order_acquire);
+      available = cachedTail - h;
+    }
+    int n = available < static_cast<size_t>(maxCount)
+                ? static_cast<int>(available)
+                : maxCount;
+    for (int i = 0; i < n; i++) {
+      T &slot = slots[(h + i) & mask];
+      out[i] = std::move(slot);
+      slot.~T();
+    }
+    if (n > 0)
+      head.store(h + n, memory_order_release);
+    return n;
+  }
+
+  // Exact when called from either end while the other is idle
+  int sizeApprox() const {
+    return static_cast<int>(tail.load(memory_order_acquire) -
+                            head.load(memory_order_acquire));
+  }
+
+  bool isEmpty() const { return sizeApprox() == 0; }
+
+  int capacity() const { return cap; }
+
+private:
+  T *slots;
+  const int cap;
+  const size_t mask;
+
+  char pad0[64];
+  atomic<size_t> head; // next slot to read, written by the consumer
+  size_t cachedTail;   // consumer's last view of tail
+  char pad1[64];
+  atomic<size_t> tail; // next slot to write, written by the producer
+  size_t cachedHead;   // producer's last view of head
+  char pad2[64];
+};
+
+// Any number of producer threads, one consumer thread.
+//
+// Every cell carries a sequence number saying whose turn it is: a producer
+// may fill cell i once its sequence equals the position being claimed, the
+// consumer may read it once it equals position + 1. Producers claim
+// positions with a CAS on tail; the consumer alone advances head.
+template <typename T> class MpscRingBuffer {
+public:
+  explicit MpscRingBuffer(int minCapacity = 1024)
+      : cap(ring_buffer_detail::roundUpPow2(minCapacity)),
+        mask(static_cast<size_t>(cap) - 1), tail(0), head(0) {
+    cells = new Cell[cap];
+    for (int i = 0; i < cap; i++)
+      cells[i].seq.store(static_cast<size_t>(i), memory_order_relaxed);
+  }
+
+  ~MpscRingBuffer() {
+    size_t h = head.load(memory_order_relaxed);
+    while (cells[h & mask].seq.load(memory_order_acquire) == h + 1) {
+      cells[h & mask].value()->~T();
+      h++;
+    }
+    delete[] cells;
+  }
+
+  MpscRingBuffer(const MpscRingBuffer &) = delete;
+  MpscRingBuffer &operator=(const MpscRingBuffer &) = delete;
+
+  // Producer side, thread-safe. Returns false if the queue is full.
+  template <typename... Args> bool tryEmplace(Args &&...args) {
+    size_t pos;
+    if (!claim(1, pos))
+      return false;
+    Cell &cell = cells[pos & mask];
+    new (cell.value()) T(std::forward<Args>(args)...);
+    cell.seq.store(pos + 1, memory_order_release);
+    return true;
+  }
+
+  bool tryPush(const T &value) { return tryEmplace(value); }
+
+  bool tryPush(T &&value) { return tryEmplace(std::move(value)); }
+
+  // Producer side, thread-safe. Claims a contiguous run of positions with
+  // one CAS, so a batch from one producer is never interleaved with other
+  // producers' items. Pushes as many of items[0..count) as fit and returns
+  // the number pushed.
+  int tryPushBatch(const T *items, int count) {
+    if (count <= 0)
+      return 0;
+    size_t pos;
+    int n = count < cap ? count : cap;
+    while (n > 0 && !claim(n, pos)) {
+      // Shrink the batch to the room the consumer has left
+      size_t used = tail.load(memory_order_relaxed) -
+                    head.load(memory_order_acquire);
+      int room = used >= static_cast<size_t>(cap)
+                     ? 0
+                     : cap - static_cast<int>(used);
+      if (room == 0)
+        return 0;
+      n = room < n ? room : n - 1;
+    }
+    for (int i = 0; i < n; i++) {
+      Cell &cell = cells[(pos + i) & mask];
+      new (cell.value()) T(items[i]);
+      cell.seq.store(pos + i + 1, memory_order_release);
+    }
+    return n;
+  }
+
+  // Consumer side. Returns false if the queue is empty or the next element
+  // is still being written.
+  bool tryPop(T &out) {
+    const size_t h = head.load(memory_order_relaxed);
+    Cell &cell = cells[h & mask];
+    if (cell.seq.load(memory_order_acquire) != h + 1)
+      return false;
+    T *slot = cell.value();
+    out = std::move(*slot);
+    slot->~T();
+    cell.seq.store(h + cap, memory_order_release);
+    head.store(h + 1, memory_order_release);
+    return true;
+  }
+
+  // Consumer side. Moves up to maxCount ready elements into out, in order.
+  int tryPopBatch(T *out, int maxCount) {
+    size_t h = head.load(memory_order_relaxed);
+    int n = 0;
+    while (n < maxCount) {
+      Cell &cell = cells[h & mask];
+      if (cell.seq.load(memory_order_acquire) != h + 1)
+        break;
+      T *slot = cell.value();
+      out[n++] = std::move(*slot);
+      slot->~T();
+      cell.seq.store(h + cap, memory_order_release);
+      h++;
+    }
+    if (n > 0)
+      head.store(h, memory_order_release);
+    return n;
+  }
+
+  int sizeApprox() const {
+    size_t t = tail.load(memory_order_acquire);
+    size_t h = head.load(memory_order_acquire);
+    return t > h ? static_cast<int>(t - h) : 0;
+  }
+
+  bool isEmpty() const { return sizeApprox() == 0; }
+
+  int capacity() const { return cap; }
+
+private:
+  struct Cell {
+    atomic<size_t> seq;
+    typename aligned_storage<sizeof(T), alignof(T)>::type storage;
+
+    T *value() { return reinterpret_cast<T *>(&storage); }
+  };
+
+  // Reserve positions [pos, pos + n) if all n cells are free
+  bool claim(int n, size_t &pos) {
+    pos = tail.load(memory_order_relaxed);
+    while (true) {
+      // The consumer frees cells in order, so if the last cell of the run is
+      // free for this round, so are the ones before it
+      const size_t last = pos + n - 1;
+      const size_t seq = cells[last & mask].seq.load(memory_order_acquire);
+      const ptrdiff_t diff =
+          static_cast<ptrdiff_t>(seq) - static_cast<ptrdiff_t>(last);
+      if (diff == 0) {
+        if (tail.compare_exchange_weak(pos, pos + n, memory_order_relaxed))
+          return true;
+      } else if (diff < 0) {
+        return false; // full
+      } else {
+        pos = tail.load(memory_order_relaxed);
+      }
+    }
+  }
+
+  Cell *cells;
+  const int cap;
+  const size_t mask;
+
+  char pad0[64];
+  atomic<size_t> tail; // next position to claim, shared by producers
+  char pad1[64];
+  atomic<size_t> head; // next position to read, written by the consumer
+  char pad2[64];
+};
+
+#endif // RING_BUFFER_H
@@ -0,0 +1,90 @@
+#ifndef ADS_PROJECT_RW_SPIN_LOCK_H
+#define ADS_PROJECT_RW_SPIN_LOCK_H
+
+#include <atomic>
+#include <cstdint>
+#include <thread>
+
+/**
+ * @file rw_spin_lock.h
+ * @brief Small writer-preferring reader/writer lock
+ *
+ * The project is built as C++11, which has no std::shared_mutex. The
+ * critical sections this lock protects (a hash bucket walk) are a few
+ * hundred nanoseconds, so a single atomic word with yield-backoff is
+ * cheaper than a mutex + condition variable pair.
+ *
+ * Satisfies the Lockable requirements, so std::lock_guard / std::unique_lock
+ * work for exclusive access. Use SharedLockGuard for shared access.
+ */
+class RWSpinLock {
+public:
+  RWSpinLock() : state_(0) {}
+
+  RWSpinLock(const RWSpinLock &) = delete;
+  RWSpinLock &operator=(const RWSpinLock &) = delete;
+
+  /**
+   * @brief Acquire exclusive ownership
+   *
+   * Sets the writer bit first so that no new readers can enter, then waits
+   * for the readers already inside to leave.
+   */
+  void lock() {
+    uint32_t s = state_.load(std::memory_order_relaxed);
+    while (true) {
+      if (!(s & kWriter) &&
+          state_.compare_exchange_weak(s, s | kWriter,
+                                       std::memory_order_acquire))
+        break;
+      std::this_thread::yield();
+      s = state_.load(std::memory_order_relaxed);
+    }
+    while (state_.load(std::memory_order_acquire) != kWriter)
+      std::this_thread::yield();
+  }
+
+  void unlock() { state_.store(0, std::memory_order_release); }
+
+  /**
+   * @brief Acquire shared ownership
+   *
+   * Readers only enter while no writer holds or waits for the lock.
+   */
+  void lock_shared() {
+    uint32_t s = state_.load(std::memory_order_relaxed);
+    while (true) {
+      if (!(s & kWriter) &&
+          state_.compare_exchange_weak(s, s + 1, std::memory_order_acquire))
+        return;
+      std::this_thread::yield();
+      s = state_.load(std::memory_order_relaxed);
+    }
+  }
+
+  void unlock_shared() { state_.fetch_sub(1, std::memory_order_release); }
+
+private:
+  static const uint32_t kWriter = 0x80000000u; ///< Writer held or pending
+  std::atomic<uint32_t> state_; ///< Writer bit + number of active readers
+};
+
+/**
+ * @class SharedLockGuard
+ * @brief RAII shared (reader) ownership of a RWSpinLock
+ */
+class SharedLockGuard {
+public:
+  explicit SharedLockGuard(RWSpinLock &lock) : lock_(lock) {
+    lock_.lock_shared();
+  }
+  ~SharedLockGuard() { lock_.unlock_shared(); }
+
+  SharedLockGuard(const SharedLockGuard &) = delete;
+  SharedLockGuard &operator=(const SharedLockGuard &) = delete;
+
+private:
+  RWSpinLock &lock_;
+};
+
+#endif // ADS_PROJECT_RW_SPIN_LOCK_H
@@ -0,0 +1,195 @@
+#ifndef STRING_ARENA_H
+#define STRING_ARENA_H
+
+#include <cctype>
+#include <cstring>
+#include <ostream>
+#include <string>
+
+#include "hash_map.h"
+#include "string_hash.h"
+using namespace std;
+
+// Non-owning view of a run of characters (std::string_view is C++17).
+// Converts implicitly from strings, so a std::string can be used to look
+// up a map keyed by StringRef without copying it.
+class StringRef {
+private:
+  const char *ptr;
+  int len;
+
+public:
+  StringRef() : ptr(""), len(0) {}
+  StringRef(const char *s, int n) : ptr(s), len(n) {}
+  StringRef(const char *s) : ptr(s), len(static_cast<int>(strlen(s))) {}
+  StringRef(const string &s)
+      : ptr(s.data()), len(static_cast<int>(s.size())) {}
+
+  const char *data() const { return ptr; }
+  int size() const { return len; }
+  bool empty() const { return len == 0; }
+  char operator[](int i) const { return ptr[i]; }
+  const char *begin() const { return ptr; }
+  const char *end() const { return ptr + len; }
+
+  string str() const { return string(ptr, len); }
+
+  int compare(const StringRef &other) const {
+    int n = len < other.len ? len : other.len;
+    int c = n ? memcmp(ptr, other.ptr, n) : 0;
+    return c ? c : (len < other.len ? -1 : len > other.len ? 1 : 0);
+  }
+
+  // Equal ignoring ASCII case
+  bool equalsIgnoreCase(const StringRef &other) const {
+    if (len != other.len)
+      return false;
+    for (int i = 0; i < len; i++)
+      if (tolower(static_cast<unsigned char>(ptr[i])) !=
+          tolower(static_cast<unsigned char>(other.ptr[i])))
+        return false;
+    return true;
+  }
+};
+
+inline bool operator==(const StringRef &a, const StringRef &b) {
+  return a.size() == b.size() &&
+         (a.size() == 0 || memcmp(a.data(), b.data(), a.size()) == 0);
+}
+inline bool operator!=(const StringRef &a, const StringRef &b) {
+  return !(a == b);
+}
+inline bool operator<(const StringRef &a, const StringRef &b) {
+  return a.compare(b) < 0;
+}
+inline ostream &operator<<(ostream &out, const StringRef &s) {
+  return out.write(s.data(), s.size());
+}
+
+template <> struct DefaultHasher<StringRef> {
+  size_t operator()(const StringRef &key) const {
+    return static_cast<size_t>(fastHashBytes(key.data(), key.size()));
+  }
+};
+
+// Hash and equality that ignore ASCII case, for keys such as titles that
+// are stored as displayed but looked up case-insensitively
+struct CaseInsensitiveHash {
+  size_t operator()(const StringRef &key) const {
+    // Lower-case a block at a time and chain the blocks' hashes
+    char block[64];
+    uint64_t h = 0;
+    int i = 0;
+    do {
+      int n = key.size() - i < 64 ? key.size() - i : 64;
+      for (int k = 0; k < n; k++)
+        block[k] = static_cast<char>(
+            tolower(static_cast<unsigned char>(key[i + k])));
+      h = fastHashBytes(block, n, h);
+      i += n;
+    } while (i < key.size());
+    return static_cast<size_t>(h);
+  }
+};
+
+struct CaseInsensitiveEqual {
+  bool operator()(const StringRef &a, const StringRef &b) const {
+    return a.equalsIgnoreCase(b);
+  }
+};
+
+// Append-only storage for many small strings. Characters are copied into
+// large blocks that are never moved or freed until the arena is, so a
+// StringRef into the arena stays valid for the arena's whole life - even
+// after whatever used it is gone. Space is not reclaimed on removal.
+class StringArena {
+private:
+  static const int BLOCK_SIZE = 64 * 1024;
+
+  char **blocks;
+  int blockCount;
+  int blockCap;
+  int used;        // bytes used in the last block
+  int lastSize;    // size of the last block
+  size_t stored;   // bytes handed out
+  size_t reserved; // bytes in all blocks
+
+  void addBlock(int size) {
+    if (blockCount == blockCap) {
+      int newCap = blockCap ? blockCap * 2 : 16;
+      char **grown = new char *[newCap];
+      for (int i = 0; i < blockCount; i++)
+        grown[i] = blocks[i];
+      delete[] blocks;
+      blocks = grown;
+      blockCap = newCap;
+    }
+    blocks[blockCount++] = new char[size];
+    used = 0;
+    lastSize = size;
+    reserved += size;
+  }
+
+public:
+  StringArena()
+      : blocks(nullptr), blockCount(0), blockCap(0), used(0), lastSize(0),
+        stored(0), reserved(0) {}
+
+  ~StringArena() {
+    for (int i = 0; i < blockCount; i++)
+      delete[] blocks[i];
+    delete[] blocks;
+  }
+
+  StringArena(const StringArena &) = delete;
+  StringArena &operator=(const StringArena &) = delete;
+
+  // n writable bytes that stay put for the arena's life
+  char *allocate(int n) {
+    if (blockCount == 0 || lastSize - used < n)
+      addBlock(n > BLOCK_SIZE / 4 ? n : BLOCK_SIZE);
+    char *p = blocks[blockCount - 1] + used;
+    used += n;
+    stored += n;
+    return p;
+  }
+
+  // Copy s into the arena
+  StringRef store(const StringRef &s) {
+    char *p = allocate(s.size());
+    if (s.size())
+      memcpy(p, s.data(), s.size());
+    return StringRef(p, s.size());
+  }
+
+  // Bytes of strings stored
+  size_t bytesStored() const { return stored; }
+
+  // Bytes of blocks allocated
+  size_t bytesReserved() const { return reserved; }
+};
+
+// Stores each distinct string once in an arena: interning a string that
+// was seen before returns the earlier copy.
+class StringInterner {
+private:
+  StringArena &arena;
+  HashMap<StringRef, StringRef> seen; // both sides are the stored copy
+
+public:
+  explicit StringInterner(StringArena &arena) : arena(arena) {}
+
+  StringRef intern(const StringRef &s) {
+    StringRef *found = seen.get(s);
+    if (found)
+      return *found;
+    StringRef stored = arena.store(s);
+    seen.putNew(stored, stored);
+    return stored;
+  }
+
+  // Number of distinct strings
+  int size() const { return seen.size(); }
+};
+
+#endif // STRING_ARENA_H
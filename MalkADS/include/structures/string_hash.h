@@ -0,0 +1,145 @@
+#ifndef ADS_PROJECT_STRING_HASH_H
+#define ADS_PROJECT_STRING_HASH_H
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <functional>
+#include <string>
+
+/**
+ * @file string_hash.h
+ * @brief Hash functors that can be plugged into HashMap
+ *
+ * FastStringHash is a wyhash-style byte hash tuned for the short keys the
+ * library stores (usernames, resource IDs such as "R150B" or "L004", and
+ * lower-cased book titles). Keys of up to 16 bytes are hashed with a single
+ * 64x64->128 bit multiply-and-fold, longer keys are consumed 16 or 48 bytes
+ * per round.
+ */
+
+namespace string_hash_detail {
+
+static const uint64_t kSecret[4] = {0x2d358dccaa6c78a5ull, 0x8bb84b93962eacc9ull,
+                                    0x4b33a62ed433d4a3ull, 0x4d5a2da51de1aa47ull};
+
+/// Multiply two 64-bit values and fold the 128-bit product into (a, b).
+inline void mum(uint64_t &a, uint64_t &b) {
+#if defined(__SIZEOF_INT128__)
+  const unsigned __int128 r = static_cast<unsigned __int128>(a) * b;
+  a = static_cast<uint64_t>(r);
+  b = static_cast<uint64_t>(r >> 64);
+#else
+  const uint64_t ha = a >> 32, hb = b >> 32;
+  const uint64_t la = static_cast<uint32_t>(a), lb = static_cast<uint32_t>(b);
+  const uint64_t rh = ha * hb, rm0 = ha * lb, rm1 = hb * la, rl = la * lb;
+  const uint64_t t = rl + (rm0 << 32);
+  uint64_t c = t < rl;
+  const uint64_t lo = t + (rm1 << 32);
+  c += lo < t;
+  a = lo;
+  b = rh + (rm0 >> 32) + (rm1 >> 32) + c;
+#endif
+}
+
+inline uint64_t mix(uint64_t a, uint64_t b) {
+  mum(a, b);
+  return a ^ b;
+}
+
+inline uint64_t read8(const unsigned char *p) {
+  uint64_t v;
+  std::memcpy(&v, p, 8);
+  return v;
+}
+
+inline uint64_t read4(const unsigned char *p) {
+  uint32_t v;
+  std::memcpy(&v, p, 4);
+  return v;
+}
+
+/// Read 1..3 bytes without branching on the exact length.
+inline uint64_t read3(const unsigned char *p, size_t k) {
+  return (static_cast<uint64_t>(p[0]) << 16) |
+         (static_cast<uint64_t>(p[k >> 1]) << 8) | p[k - 1];
+}
+
+} // namespace string_hash_detail
+
+/**
+ * @brief Hash an arbitrary byte range
+ *
+ * @param data Pointer to the first byte
+ * @param len Number of bytes
+ * @param seed Optional seed, lets callers derive independent hash families
+ * @return 64-bit hash value
+ *
+ * Time Complexity: O(len)
+ */
+inline uint64_t fastHashBytes(const void *data, size_t len, uint64_t seed = 0) {
+  using namespace string_hash_detail;
+  const unsigned char *p = static_cast<const unsigned char *>(data);
+  seed ^= mix(seed ^ kSecret[0], kSecret[1]);
+  uint64_t a, b;
+  if (len <= 16) {
+    if (len >= 4) {
+      a = (read4(p) << 32) | read4(p + ((len >> 3) << 2));
+      b = (read4(p + len - 4) << 32) | read4(p + len - 4 - ((len >> 3) << 2));
+    } else if (len > 0) {
+      a = read3(p, len);
+      b = 0;
+    } else {
+      a = b = 0;
+    }
+  } else {
+    size_t i = len;
+    if (i > 48) {
+      uint64_t see1 = seed, see2 = seed;
+      do {
+        seed = mix(read8(p) ^ kSecret[1], read8(p + 8) ^ seed);
+        see1 = mix(read8(p + 16) ^ kSecret[2], read8(p + 24) ^ see1);
+        see2 = mix(read8(p + 32) ^ kSecret[3], read8(p + 40) ^ see2);
+        p += 48;
+        i -= 48;
+      } while (i > 48);
+      seed ^= see1 ^ see2;
+    }
+    while (i > 16) {
+      seed = mix(read8(p) ^ kSecret[1], read8(p + 8) ^ seed);
+      i -= 16;
+      p += 16;
+    }
+    a = read8(p + i - 16);
+    b = read8(p + i - 8);
+  }
+  a ^= kSecret[1];
+  b ^= seed;
+  mum(a, b);
+  return mix(a ^ kSecret[0] ^ len, b ^ kSecret[1]);
+}
+
+/**
+ * @struct FastStringHash
+ * @brief High-throughput std::string hasher for HashMap
+ */
+struct FastStringHash {
+  size_t operator()(const std::string &key) const {
+    return static_cast<size_t>(fastHashBytes(key.data(), key.size()));
+  }
+};
+
+/**
+ * @struct DefaultHasher
+ * @brief Hash used by HashMap when none is given
+ *
+ * Falls back to std::hash for every key type except std::string, which uses
+ * FastStringHash.
+ */
+template <typename K> struct DefaultHasher {
+  size_t operator()(const K &key) const { return std::hash<K>{}(key); }
+};
+
+template <> struct DefaultHasher<std::string> : FastStringHash {};
+
+#endif // ADS_PROJECT_STRING_HASH_H
@@ -0,0 +1,345 @@
+#ifndef TEXT_INDEX_H
+#define TEXT_INDEX_H
+
+#include <cctype>
+#include <string>
+#include <vector>
+
+#include "hash_map.h"
+using namespace std;
+
+// Sorted array of document IDs, one per index key. Inserts and removals
+// shift the tail (a memmove of ints), and lookups are binary searches, so
+// posting lists stay contiguous and can be intersected by merging.
+class SortedIdList {
+private:
+  int *ids;
+  int count;
+  int cap;
+
+public:
+  SortedIdList() : ids(new int[4]), count(0), cap(4) {}
+
+  ~SortedIdList() { delete[] ids; }
+
+  SortedIdList(const SortedIdList &) = delete;
+  SortedIdList &operator=(const SortedIdList &) = delete;
+
+  // First position whose ID is >= id, searching from position from.
+  // Gallops forward before the binary search, so advancing a cursor by a
+  // short distance costs O(log distance) and stays within nearby memory.
+  int lowerBound(int id, int from = 0) const {
+    if (from >= count || ids[from] >= id)
+      return from;
+    int step = 1;
+    while (from + step < count && ids[from + step] < id)
+      step *= 2;
+    int lo = from + step / 2 + 1;
+    int hi = from + step < count ? from + step : count;
+    while (lo < hi) {
+      int mid = lo + (hi - lo) / 2;
+      if (ids[mid] < id)
+        lo = mid + 1;
+      else
+        hi = mid;
+    }
+    return lo;
+  }
+
+  bool insert(int id) {
+    int pos = lowerBound(id);
+    if (pos < count && ids[pos] == id)
+      return false;
+    if (count == cap) {
+      int *grown = new int[cap * 2];
+      for (int i = 0; i < count; i++)
+        grown[i] = ids[i];
+      delete[] ids;
+      ids = grown;
+      cap *= 2;
+    }
+    for (int i = count; i > pos; i--)
+      ids[i] = ids[i - 1];
+    ids[pos] = id;
+    count++;
+    return true;
+  }
+
+  bool erase(int id) {
+    int pos = lowerBound(id);
+    if (pos == count || ids[pos] != id)
+      return false;
+    for (int i = pos; i + 1 < count; i++)
+      ids[i] = ids[i + 1];
+    count--;
+    return true;
+  }
+
+  int at(int pos) const { return ids[pos]; }
+
+  int size() const { return count; }
+
+  bool empty() const { return count == 0; }
+};
+
+// Inverted index for partial-match search over short texts (titles,
+// authors), keyed by caller-chosen non-negative document IDs.
+//
+// Text is normalized to lower-case words separated by single spaces. Every
+// character trigram of the normalized text is indexed, and so is the
+// 1- and 2-character prefix of every word. A query is split into terms
+// that must all match: a term of 3+ characters matches anywhere in the
+// text (substring), a shorter term matches the start of a word (prefix).
+// Candidates come from intersecting the terms' posting lists, shortest
+// first, and are then checked against the stored text, so there are no
+// false positives.
+class TextIndex {
+private:
+  // Trigrams and word prefixes are packed into ints: up to three bytes of
+  // characters, plus a tag bit for prefixes so "ab" the prefix and "ab"
+  // inside a trigram never collide.
+  static const int PREFIX_TAG = 1 << 24;
+
+  HashMap<int, SortedIdList *> postings;
+  string *texts; // normalized text by document ID ("" if absent)
+  int textCapacity;
+  int docCount;
+
+  static int packTrigram(const string &s, size_t i) {
+    return (static_cast<unsigned char>(s[i]) << 16) |
+           (static_cast<unsigned char>(s[i + 1]) << 8) |
+           static_cast<unsigned char>(s[i + 2]);
+  }
+
+  static int packPrefix(const string &s, size_t i, size_t len) {
+    int key = PREFIX_TAG;
+    for (size_t k = 0; k < len; k++)
+      key |= static_cast<unsigned char>(s[i + k]) << (8 * (2 - k));
+    return key;
+  }
+
+  // Calls func(key) for every key of normalized text (with repeats)
+  template <typename Func>
+  static void forEachKey(const string &text, Func func) {
+    for (size_t i = 0; i + 3 <= text.size(); i++)
+      func(packTrigram(text, i));
+    for (size_t i = 0; i < text.size(); i++) {
+      if (text[i] == ' ' || (i > 0 && text[i - 1] != ' '))
+        continue;
+      func(packPrefix(text, i, 1));
+      if (i + 1 < text.size() && text[i + 1] != ' ')
+        func(packPrefix(text, i, 2));
+    }
+  }
+
+  // True if every term (already normalized, space separated) matches text
+  static bool matches(const string &text, const string &terms) {
+    // Leading space lets " term" find a term at the start of a word
+    const string padded = " " + text;
+    size_t start = 0;
+    while (start < terms.size()) {
+      size_t end = terms.find(' ', start);
+      if (end == string::npos)
+        end = terms.size();
+      const string term = terms.substr(start, end - start);
+      if (term.size() >= 3 ? text.find(term) == string::npos
+                           : padded.find(" " + term) == string::npos)
+        return false;
+      start = end + 1;
+    }
+    return true;
+  }
+
+  void ensureCapacity(int docId) {
+    if (docId < textCapacity)
+      return;
+    int newCapacity = textCapacity ? textCapacity : 64;
+    while (newCapacity <= docId)
+      newCapacity *= 2;
+    string *grown = new string[newCapacity];
+    for (int i = 0; i < textCapacity; i++)
+      grown[i].swap(texts[i]);
+    delete[] texts;
+    texts = grown;
+    textCapacity = newCapacity;
+  }
+
+public:
+  TextIndex() : texts(nullptr), textCapacity(0), docCount(0) {}
+
+  ~TextIndex() {
+    clear();
+    delete[] texts;
+  }
+
+  TextIndex(const TextIndex &) = delete;
+  TextIndex &operator=(const TextIndex &) = delete;
+
+  // Lower-case alphanumerics; any run of other characters becomes one space
+  static string normalize(const string &s) {
+    string out;
+    out.reserve(s.size());
+    for (char ch : s) {
+      unsigned char c = static_cast<unsigned char>(ch);
+      if (isalnum(c) || c >= 0x80) {
+        out += static_cast<char>(tolower(c));
+      } else if (!out.empty() && out[out.size() - 1] != ' ') {
+        out += ' ';
+      }
+    }
+    if (!out.empty() && out[out.size() - 1] == ' ')
+      out.erase(out.size() - 1);
+    return out;
+  }
+
+  // Occurrences of one normalized term in normalized text, by the rules
+  // search() matches with: anywhere for 3+ characters, at the start of a
+  // word for shorter terms. Stores in wordStarts (if given) how many of
+  // them start a word.
+  static int countOccurrences(const string &text, const string &term,
+                              int *wordStarts = nullptr) {
+    int count = 0;
+    int starts = 0;
+    if (!term.empty()) {
+      for (size_t pos = text.find(term); pos != string::npos;
+           pos = text.find(term, pos + 1)) {
+        const bool atStart = pos == 0 || text[pos - 1] == ' ';
+        if (term.size() < 3 && !atStart)
+          continue;
+        count++;
+        if (atStart)
+          starts++;
+      }
+    }
+    if (wordStarts)
+      *wordStarts = starts;
+    return count;
+  }
+
+  // Index text under docId, replacing whatever docId had before
+  void add(int docId, const string &text) {
+    if (docId < 0)
+      return;
+    remove(docId);
+    ensureCapacity(docId);
+    texts[docId] = normalize(text);
+    if (texts[docId].empty())
+      return;
+    docCount++;
+    forEachKey(texts[docId], [&](int key) {
+      SortedIdList **listPtr = postings.get(key);
+      SortedIdList *list = listPtr ? *listPtr : nullptr;
+      if (!list) {
+        list = new SortedIdList();
+        postings.putNew(key, list);
+      }
+      list->insert(docId);
+    });
+  }
+
+  void remove(int docId) {
+    if (docId < 0 || docId >= textCapacity || texts[docId].empty())
+      return;
+    forEachKey(texts[docId], [&](int key) {
+      SortedIdList **listPtr = postings.get(key);
+      if (!listPtr || !(*listPtr))
+        return;
+      (*listPtr)->erase(docId);
+      if ((*listPtr)->empty()) {
+        delete *listPtr;
+        postings.erase(key);
+      }
+    });
+    texts[docId].clear();
+    docCount--;
+  }
+
+  // Documents matching every term of query, in ascending ID order, as
+  // func(docId). Stops after limit matches (limit <= 0: no limit). Returns
+  // the number reported. An empty query matches nothing.
+  template <typename Func>
+  int search(const string &query, int limit, Func func) const {
+    const string terms = normalize(query);
+    if (terms.empty())
+      return 0;
+
+    // Posting lists of every key of every term. func may throw, so the
+    // buffers are vectors rather than new[] arrays.
+    vector<const SortedIdList *> lists;
+    bool missing = false;
+    size_t start = 0;
+    while (start < terms.size() && !missing) {
+      size_t end = terms.find(' ', start);
+      if (end == string::npos)
+        end = terms.size();
+      const string term = terms.substr(start, end - start);
+      auto addKey = [&](int key) {
+        SortedIdList **listPtr = postings.get(key);
+        if (!listPtr || !(*listPtr)) {
+          missing = true;
+          return;
+        }
+        lists.push_back(*listPtr);
+      };
+      if (term.size() >= 3) {
+        for (size_t i = 0; i + 3 <= term.size(); i++)
+          addKey(packTrigram(term, i));
+      } else {
+        addKey(packPrefix(term, 0, term.size()));
+      }
+      start = end + 1;
+    }
+
+    const int listCount = static_cast<int>(lists.size());
+    int reported = 0;
+    if (!missing && listCount > 0) {
+      // Shortest list drives the intersection
+      for (int i = 1; i < listCount; i++) {
+        const SortedIdList *l = lists[i];
+        int j = i - 1;
+        while (j >= 0 && lists[j]->size() > l->size()) {
+          lists[j + 1] = lists[j];
+          j--;
+        }
+        lists[j + 1] = l;
+      }
+
+      vector<int> cursor(listCount, 0);
+      const SortedIdList *driver = lists[0];
+      for (int d = 0; d < driver->size(); d++) {
+        const int id = driver->at(d);
+        bool inAll = true;
+        for (int i = 1; i < listCount && inAll; i++) {
+          cursor[i] = lists[i]->lowerBound(id, cursor[i]);
+          inAll = cursor[i] < lists[i]->size() &&
+                  lists[i]->at(cursor[i]) == id;
+        }
+        // Trigrams can all be present without being adjacent
+        if (!inAll || !matches(texts[id], terms))
+          continue;
+        func(id);
+        if (++reported == limit)
+          break;
+      }
+    }
+    return reported;
+  }
+
+  int size() const { return docCount; }
+
+  // Number of distinct keys (trigrams and word prefixes) indexed
+  int keyCount() const { return postings.size(); }
+
+  void clear() {
+    postings.forEach([](const int &, SortedIdList *&list) {
+      delete list;
+      list = nullptr;
+    });
+    postings.clear();
+    for (int i = 0; i < textCapacity; i++)
+      texts[i].clear();
+    docCount = 0;
+  }
+};
+
+#endif // TEXT_INDEX_H
@@ -0,0 +1,376 @@
+#ifndef TIMING_WHEEL_H
+#define TIMING_WHEEL_H
+
+#include <utility>
+
+#include "priority_queue.h"
+using namespace std;
+
+// Hierarchical timing wheel: schedules payloads to fire at a future tick.
+//
+// Four levels of 64 slots each. Level k holds timers due between 64^k and
+// 64^(k+1) ticks from now, in the slot picked by bits 6k..6k+5 of the expiry.
+// Whenever the clock crosses a level-k boundary, that level's current slot
+// is redistributed into the levels below. A timer therefore moves at most
+// three times before it fires, and schedule/cancel are O(1): a timer is a
+// node in a doubly linked slot list, addressed by its TimerId.
+//
+// Timers due more than 64^4 ticks (about 194 days of seconds) ahead wait in
+// a PriorityQueue and are pulled into the wheel once they come in range.
+//
+// The wheel only moves when advance(now) is called; the owner decides what
+// a tick is and who drives it. Not thread-safe.
+template <typename T> class TimingWheel {
+public:
+  typedef long long TimerId;
+
+  static const TimerId INVALID_TIMER = -1;
+
+  explicit TimingWheel(long long startTick = 0);
+
+  ~TimingWheel();
+
+  TimingWheel(const TimingWheel &) = delete;
+  TimingWheel &operator=(const TimingWheel &) = delete;
+
+  // Fire payload once the clock reaches expiry. An expiry that is not in
+  // the future fires on the next tick. O(1), O(log n) for far-future ones
+  TimerId schedule(long long expiry, const T &payload);
+
+  // Drop a pending timer. Returns false if it already fired or was
+  // cancelled. O(1)
+  bool cancel(TimerId id);
+
+  bool isPending(TimerId id) const;
+
+  // Move the clock to now, calling func(expiry, T&) for every timer that
+  // comes due, tick by tick. func may schedule and cancel timers but must
+  // not call advance(). Returns the number of timers fired.
+  template <typename Func> int advance(long long now, Func func);
+
+  long long now() const { return current; }
+
+  int size() const { return pending; }
+
+  bool isEmpty() const { return pending == 0; }
+
+private:
+  static const int SLOT_BITS = 6;
+  static const int SLOTS = 1 << SLOT_BITS;
+  static const int LEVELS = 4;
+  static const long long SPAN = 1LL << (SLOT_BITS * LEVELS);
+
+  // Lists 0..LEVELS*SLOTS-1 are wheel slots, then two special lists
+  static const int FIRING = LEVELS * SLOTS; // detached slot being fired
+  static const int OVERFLOW_LIST = FIRING + 1;
+  static const int FREE_NODE = -1;
+
+  struct Node {
+    long long expiry;
+    int prev;
+    int next;
+    int list;            // which list the node is on, FREE_NODE if unused
+    unsigned generation; // bumped on release so stale TimerIds miss
+    T payload;
+
+    Node() : expiry(0), prev(-1), next(-1), list(FREE_NODE), generation(1) {}
+  };
+
+  struct OverflowEntry {
+    long long expiry;
+    int index;
+    unsigned generation;
+
+    bool operator<(const OverflowEntry &o) const { return expiry < o.expiry; }
+  };
+
+  Node *nodes;
+  int capacity;
+  int usedNodes; // nodes handed out at least once
+  int freeHead;  // recycled nodes, chained through next
+  int heads[FIRING + 1];
+  int levelCount[LEVELS];
+  int inWheel;
+  int pending;
+  long long current;
+
+  // Lazily deleted: cancelling a far-future timer leaves its entry behind
+  PriorityQueue<OverflowEntry> overflow;
+  int overflowStale;
+
+  static TimerId makeId(int index, unsigned generation) {
+    return (static_cast<TimerId>(generation) << 32) | index;
+  }
+
+  int allocNode();
+
+  void releaseNode(int index);
+
+  void link(int index, int list);
+
+  void unlink(int index);
+
+  void place(int index, long long minTick);
+
+  void cascade(int level, long long tick);
+
+  void migrateOverflow(long long minTick);
+
+  void compactOverflow();
+
+  int lowestBusyLevel() const;
+
+  template <typename Func> int step(Func &func);
+};
+
+template <typename T> const typename TimingWheel<T>::TimerId
+    TimingWheel<T>::INVALID_TIMER;
+
+template <typename T>
+TimingWheel<T>::TimingWheel(long long startTick)
+    : capacity(64), usedNodes(0), freeHead(-1), inWheel(0), pending(0),
+      current(startTick), overflowStale(0) {
+  nodes = new Node[capacity];
+  for (int i = 0; i <= FIRING; i++)
+    heads[i] = -1;
+  for (int i = 0; i < LEVELS; i++)
+    levelCount[i] = 0;
+}
+
+template <typename T> TimingWheel<T>::~TimingWheel() { delete[] nodes; }
+
+template <typename T> int TimingWheel<T>::allocNode() {
+  if (freeHead != -1) {
+    int index = freeHead;
+    freeHead = nodes[index].next;
+    return index;
+  }
+  if (usedNodes == capacity) {
+    int newCapacity = capacity * 2;
+    Node *newNodes = new Node[newCapacity];
+    for (int i = 0; i < usedNodes; i++)
+      newNodes[i] = std::move(nodes[i]);
+    delete[] nodes;
+    nodes = newNodes;
+    capacity = newCapacity;
+  }
+  return usedNodes++;
+}
+
+template <typename T> void TimingWheel<T>::releaseNode(int index) {
+  Node &n = nodes[index];
+  n.list = FREE_NODE;
+  n.generation = (n.generation + 1) & 0x7fffffffu;
+  if (n.generation == 0)
+    n.generation = 1;
+  n.payload = T(); // release resources held by the payload
+  n.next = freeHead;
+  freeHead = index;
+}
+
+template <typename T> void TimingWheel<T>::link(int index, int list) {
+  Node &n = nodes[index];
+  n.list = list;
+  n.prev = -1;
+  n.next = heads[list];
+  if (n.next != -1)
+    nodes[n.next].prev = index;
+  heads[list] = index;
+  if (list < FIRING) {
+    levelCount[list / SLOTS]++;
+    inWheel++;
+  }
+}
+
+template <typename T> void TimingWheel<T>::unlink(int index) {
+  Node &n = nodes[index];
+  if (n.prev != -1)
+    nodes[n.prev].next = n.next;
+  else
+    heads[n.list] = n.next;
+  if (n.next != -1)
+    nodes[n.next].prev = n.prev;
+  if (n.list < FIRING) {
+    levelCount[n.list / SLOTS]--;
+    inWheel--;
+  }
+}
+
+// Put a node into the level whose range covers its distance from now.
+// minTick is the earliest tick it may fire on: current while cascading
+// (that tick's slot is fired next), current + 1 for new timers.
+template <typename T>
+void TimingWheel<T>::place(int index, long long minTick) {
+  long long due = nodes[index].expiry < minTick ? minTick : nodes[index].expiry;
+  long long delta = due - current;
+  if (delta >= SPAN) {
+    OverflowEntry e;
+    e.expiry = due;
+    e.index = index;
+    e.generation = nodes[index].generation;
+    overflow.push(e);
+    nodes[index].list = OVERFLOW_LIST;
+    return;
+  }
+  int level = 0;
+  while (delta >= (1LL << (SLOT_BITS * (level + 1))))
+    level++;
+  int slot = static_cast<int>((due >> (SLOT_BITS * level)) & (SLOTS - 1));
+  link(index, level * SLOTS + slot);
+}
+
+template <typename T> void TimingWheel<T>::cascade(int level, long long tick) {
+  int list = level * SLOTS +
+             static_cast<int>((tick >> (SLOT_BITS * level)) & (SLOTS - 1));
+  int index = heads[list];
+  while (index != -1) {
+    int next = nodes[index].next;
+    unlink(index);
+    place(index, tick);
+    index = next;
+  }
+}
+
+template <typename T> void TimingWheel<T>::migrateOverflow(long long minTick) {
+  while (!overflow.isEmpty()) {
+    const OverflowEntry &top = overflow.top();
+    const Node &n = nodes[top.index];
+    if (n.list != OVERFLOW_LIST || n.generation != top.generation) {
+      overflow.pop();
+      overflowStale--;
+      continue;
+    }
+    if (top.expiry - current >= SPAN)
+      break;
+    int index = top.index;
+    overflow.pop();
+    place(index, minTick);
+  }
+}
+
+// Rebuild the overflow heap without cancelled entries, O(n)
+template <typename T> void TimingWheel<T>::compactOverflow() {
+  OverflowEntry *live = new OverflowEntry[overflow.size()];
+  int count = 0;
+  overflow.forEach([&](const OverflowEntry &e) {
+    const Node &n = nodes[e.index];
+    if (n.list == OVERFLOW_LIST && n.generation == e.generation)
+      live[count++] = e;
+  });
+  overflow.assign(live, live + count);
+  overflowStale = 0;
+  delete[] live;
+}
+
+template <typename T> int TimingWheel<T>::lowestBusyLevel() const {
+  for (int level = 0; level < LEVELS; level++)
+    if (levelCount[level] > 0)
+      return level;
+  return LEVELS;
+}
+
+template <typename T>
+typename TimingWheel<T>::TimerId
+TimingWheel<T>::schedule(long long expiry, const T &payload) {
+  int index = allocNode();
+  nodes[index].expiry = expiry;
+  nodes[index].payload = payload;
+  place(index, current + 1);
+  pending++;
+  return makeId(index, nodes[index].generation);
+}
+
+template <typename T> bool TimingWheel<T>::isPending(TimerId id) const {
+  if (id < 0)
+    return false;
+  int index = static_cast<int>(id & 0xffffffffLL);
+  unsigned generation = static_cast<unsigned>(id >> 32);
+  return index < usedNodes && nodes[index].list != FREE_NODE &&
+         nodes[index].generation == generation;
+}
+
+template <typename T> bool TimingWheel<T>::cancel(TimerId id) {
+  if (!isPending(id))
+    return false;
+  int index = static_cast<int>(id & 0xffffffffLL);
+  if (nodes[index].list == OVERFLOW_LIST) {
+    overflowStale++;
+  } else {
+    unlink(index);
+  }
+  releaseNode(index);
+  pending--;
+  if (overflowStale > 64 && overflowStale > overflow.size() / 2)
+    compactOverflow();
+  return true;
+}
+
+// Process tick current + 1
+template <typename T>
+template <typename Func>
+int TimingWheel<T>::step(Func &func) {
+  long long tick = ++current;
+
+  if ((tick & ((1LL << (SLOT_BITS * (LEVELS - 1))) - 1)) == 0)
+    migrateOverflow(tick);
+  for (int level = LEVELS - 1; level > 0; level--)
+    if ((tick & ((1LL << (SLOT_BITS * level)) - 1)) == 0)
+      cascade(level, tick);
+
+  // Detach the due slot first so callbacks can schedule into the wheel
+  int slot = static_cast<int>(tick & (SLOTS - 1));
+  while (heads[slot] != -1) {
+    int index = heads[slot];
+    unlink(index);
+    link(index, FIRING);
+  }
+
+  int fired = 0;
+  while (heads[FIRING] != -1) {
+    int index = heads[FIRING];
+    unlink(index);
+    long long expiry = nodes[index].expiry;
+    T payload(std::move(nodes[index].payload));
+    releaseNode(index);
+    pending--;
+    fired++;
+    func(expiry, payload);
+  }
+  return fired;
+}
+
+template <typename T>
+template <typename Func>
+int TimingWheel<T>::advance(long long now, Func func) {
+  int fired = 0;
+  while (current < now) {
+    int level = lowestBusyLevel();
+    if (level == LEVELS) {
+      // Wheel is empty: jump straight to the next far-future timer
+      migrateOverflow(current + 1);
+      if (inWheel == 0) {
+        long long target = now;
+        if (!overflow.isEmpty() && overflow.top().expiry - 1 < target)
+          target = overflow.top().expiry - 1;
+        if (target > current)
+          current = target;
+        migrateOverflow(current + 1);
+        if (current >= now)
+          break;
+      }
+    } else if (level > 0) {
+      // Nothing can fire before the next level boundary
+      long long boundary =
+          ((current >> (SLOT_BITS * level)) + 1) << (SLOT_BITS * level);
+      long long target = boundary - 1 < now ? boundary - 1 : now;
+      if (target > current)
+        current = target;
+      if (current >= now)
+        break;
+    }
+    fired += step(func);
+  }
+  return fired;
+}
+
+#endif // TIMING_WHEEL_H
@@ -0,0 +1,63 @@
+#ifndef TOP_K_H
+#define TOP_K_H
+
+#include <utility>
+
+#include "priority_queue.h"
+using namespace std;
+
+// Streaming top-k: keeps the k best items offered so far in a bounded
+// PriorityQueue whose top is the worst of them, so each offer is O(log k)
+// and n offers cost O(n log k) regardless of n.
+//
+// Better(a, b) returns true when a ranks above b.
+template <typename T, typename Better = DefaultComparator<T>> class TopK {
+private:
+  // The heap keeps the worst kept item on top
+  struct Worse {
+    Better better;
+    bool operator()(const T &a, const T &b) const { return better(b, a); }
+  };
+
+  PriorityQueue<T, Worse> heap;
+  int k;
+  Better better;
+
+public:
+  explicit TopK(int k) : heap(k > 0 ? k : 1), k(k) {}
+
+  int size() const { return heap.size(); }
+
+  // Returns true if the item is (for now) among the top k
+  bool offer(const T &item) {
+    if (k <= 0)
+      return false;
+    if (heap.size() < k) {
+      heap.push(item);
+      return true;
+    }
+    if (!better(item, heap.top()))
+      return false;
+    heap.pop();
+    heap.push(item);
+    return true;
+  }
+
+  // Empty the collector, calling func(T&) from best to worst
+  template <typename Func> void drain(Func func) {
+    int n = heap.size();
+    if (n == 0)
+      return;
+    // Pops come out worst first; fill a buffer back to front
+    T *ordered = static_cast<T *>(::operator new(sizeof(T) * n));
+    for (int i = n - 1; i >= 0; i--)
+      new (&ordered[i]) T(heap.pop());
+    for (int i = 0; i < n; i++)
+      func(ordered[i]);
+    for (int i = 0; i < n; i++)
+      ordered[i].~T();
+    ::operator delete(ordered);
+  }
+};
+
+#endif // TOP_K_H
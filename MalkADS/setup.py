@@ -23,10 +23,10 @@ cpp_sources = [
     'src/managers/RoomsManager.cpp',
     'src/managers/LaptopsManager.cpp',
     'src/managers/BooksManager.cpp',
+    'src/managers/BookingEngine.cpp',
     'src/models/user.cpp',
     'src/models/book.cpp',
     'src/structures/IntervalTreeComplete.cpp',
-    'src/structures/queue.cpp',
 ]
 
 # Include directories
@@ -46,7 +46,8 @@ ext_modules = [
         sources=cpp_sources,
         include_dirs=include_dirs,
         language='c++',
-        extra_compile_args=['/std:c++11'] if sys.platform == 'win32' else ['-std=c++11'],
+        extra_compile_args=['/std:c++11'] if sys.platform == 'win32' else ['-std=c++11', '-pthread'],
+        extra_link_args=[] if sys.platform == 'win32' else ['-pthread'],
     ),
 ]
 
@@ -61,7 +62,8 @@ class BuildExt(build_ext):
                 ext.extra_compile_args = ['/std:c++11', '/EHsc']
         else:
             for ext in self.extensions:
-                ext.extra_compile_args = ['-std=c++11']
+                ext.extra_compile_args = ['-std=c++11', '-pthread']
+                ext.extra_link_args = ['-pthread']
         
         build_ext.build_extensions(self)
 
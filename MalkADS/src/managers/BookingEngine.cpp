@@ -0,0 +1,310 @@
+#include "../../include/managers/BookingEngine.h"
+
+#include <exception>
+#include <utility>
+
+BookingEngine::BookingEngine(UsersManager &users, RoomsManager &rooms,
+                             LaptopsManager &laptops, BooksManager &books,
+                             int queueCapacity)
+    : users(users), rooms(rooms), laptops(laptops), books(books),
+      queue(queueCapacity), sleeping(false), stopping(false), running(false),
+      requestCount(0), batchCount(0), flushCount(0) {}
+
+BookingEngine::~BookingEngine() { stop(); }
+
+bool BookingEngine::start() {
+  if (running.load())
+    return false;
+  stopping.store(false);
+  running.store(true);
+  worker = thread([this]() { workerLoop(); });
+  return true;
+}
+
+void BookingEngine::stop() {
+  if (!running.load())
+    return;
+  stopping.store(true);
+  {
+    lock_guard<mutex> lock(wakeMutex);
+    wakeCv.notify_one();
+  }
+  worker.join();
+  running.store(false);
+}
+
+future<BookingResult> BookingEngine::submit(const BookingRequest &request) {
+  Job job;
+  job.request = request;
+  future<BookingResult> result = job.result.get_future();
+
+  if (!running.load()) {
+    runBatch(&job, 1);
+    return result;
+  }
+
+  // Backpressure: wait for the engine to make room
+  while (!queue.tryPush(std::move(job))) {
+    wake();
+    this_thread::yield();
+  }
+  wake();
+  return result;
+}
+
+void BookingEngine::wake() {
+  // Pairs with the fence in workerLoop: either the engine sees the new
+  // item before it sleeps, or we see that it is sleeping
+  atomic_thread_fence(memory_order_seq_cst);
+  if (!sleeping.load(memory_order_relaxed))
+    return;
+  lock_guard<mutex> lock(wakeMutex);
+  wakeCv.notify_one();
+}
+
+void BookingEngine::workerLoop() {
+  Job *batch = new Job[MAX_BATCH];
+
+  while (true) {
+    int n = queue.tryPopBatch(batch, MAX_BATCH);
+    if (n > 0) {
+      runBatch(batch, n);
+      continue;
+    }
+
+    if (stopping.load()) {
+      // Requests submitted before stop() may only now be visible
+      while ((n = queue.tryPopBatch(batch, MAX_BATCH)) > 0)
+        runBatch(batch, n);
+      break;
+    }
+
+    unique_lock<mutex> lock(wakeMutex);
+    sleeping.store(true, memory_order_relaxed);
+    atomic_thread_fence(memory_order_seq_cst);
+    wakeCv.wait(lock, [this]() { return !queue.isEmpty() || stopping.load(); });
+    sleeping.store(false, memory_order_relaxed);
+  }
+
+  delete[] batch;
+}
+
+void BookingEngine::runBatch(Job *jobs, int n) {
+  BookingResult results[MAX_BATCH];
+  exception_ptr errors[MAX_BATCH];
+  exception_ptr flushError;
+  unsigned dirty = 0;
+
+  {
+    lock_guard<mutex> lock(applyMutex);
+    for (int i = 0; i < n; i++) {
+      try {
+        results[i] = apply(jobs[i].request, dirty);
+      } catch (...) {
+        errors[i] = current_exception();
+      }
+    }
+    if (dirty) {
+      // A failed save is every caller's error: their changes are not on
+      // disk, and they must hear back rather than wait forever
+      try {
+        flush(dirty);
+      } catch (...) {
+        flushError = current_exception();
+      }
+      flushCount++;
+    }
+  }
+
+  requestCount += n;
+  batchCount++;
+
+  // Callers hear back only once their change is on disk
+  for (int i = 0; i < n; i++) {
+    if (errors[i] || flushError)
+      jobs[i].result.set_exception(errors[i] ? errors[i] : flushError);
+    else
+      jobs[i].result.set_value(results[i]);
+  }
+}
+
+BookingResult BookingEngine::apply(const BookingRequest &req,
+                                   unsigned &dirty) {
+  BookingResult result;
+
+  User *user = nullptr;
+  switch (req.kind) {
+  case BookingRequest::BOOK_ROOM:
+  case BookingRequest::BOOK_ANY_ROOM:
+  case BookingRequest::CANCEL_ROOM_BOOKING:
+  case BookingRequest::BORROW_LAPTOP:
+  case BookingRequest::BORROW_ANY_LAPTOP:
+  case BookingRequest::BORROW_BOOK:
+  case BookingRequest::CANCEL_BOOK_LOAN:
+  case BookingRequest::LEAVE_WAITLIST:
+    user = users.getUser(req.username);
+    if (!user) {
+      result.status = BookingResult::UNKNOWN_USER;
+      return result;
+    }
+    break;
+  default:
+    break;
+  }
+
+  bool ok = false;
+  switch (req.kind) {
+  case BookingRequest::BOOK_ROOM:
+    ok = rooms.bookRoomDirect(user, req.resourceId, req.start, req.end);
+    if (ok)
+      dirty |= ROOMS_DIRTY;
+    break;
+
+  case BookingRequest::BOOK_ANY_ROOM:
+    if (!user->canBookRoom(req.start, req.end)) {
+      result.status = BookingResult::LIMIT_REACHED;
+      return result;
+    }
+    ok = rooms.bookAnyRoom(user, req.start, req.end, &result.resourceId,
+                           req.room);
+    if (ok)
+      dirty |= ROOMS_DIRTY;
+    break;
+
+  case BookingRequest::CANCEL_ROOM_BOOKING:
+    ok = rooms.cancelRoomBookingDirect(user, req.resourceId, req.start,
+                                       req.end);
+    if (ok)
+      dirty |= ROOMS_DIRTY;
+    break;
+
+  case BookingRequest::BORROW_LAPTOP:
+    ok = laptops.borrowLaptopDirect(user, req.resourceId, req.start,
+                                    req.end);
+    if (ok)
+      dirty |= LAPTOPS_DIRTY;
+    break;
+
+  case BookingRequest::BORROW_ANY_LAPTOP:
+    if (!user->canBookLaptop(req.start, req.end)) {
+      result.status = BookingResult::LIMIT_REACHED;
+      return result;
+    }
+    laptops.forEachLaptop([&](const string &id) {
+      if (!ok && laptops.borrowLaptopDirect(user, id, req.start, req.end)) {
+        ok = true;
+        result.resourceId = id;
+      }
+    });
+    if (ok)
+      dirty |= LAPTOPS_DIRTY;
+    break;
+
+  case BookingRequest::BORROW_BOOK:
+    ok = books.borrowBookDirect(user, req.resourceId, req.start, req.end,
+                                &result.copy);
+    if (ok) {
+      dirty |= BOOKS_DIRTY;
+    } else if (books.joinWaitlist(user, req.resourceId, req.start, req.end)) {
+      dirty |= BOOKS_DIRTY;
+      result.status = BookingResult::WAITLISTED;
+      result.position = books.waitlistPosition(req.resourceId, req.username);
+      return result;
+    }
+    break;
+
+  case BookingRequest::CANCEL_BOOK_LOAN:
+    ok = books.cancelBookLoanDirect(user, req.resourceId, req.start, req.end);
+    if (ok)
+      dirty |= BOOKS_DIRTY;
+    break;
+
+  case BookingRequest::LEAVE_WAITLIST:
+    ok = books.leaveWaitlist(user, req.resourceId);
+    if (ok)
+      dirty |= BOOKS_DIRTY;
+    break;
+
+  case BookingRequest::ADVANCE_CLOCK:
+    result.count = books.advanceClock(req.now);
+    if (result.count > 0)
+      dirty |= BOOKS_DIRTY;
+    ok = true;
+    break;
+
+  case BookingRequest::ADD_ROOM:
+    ok = rooms.addRoomDirect(req.resourceId, req.room);
+    if (ok)
+      dirty |= ROOMS_DIRTY;
+    break;
+
+  case BookingRequest::SET_ROOM_ATTRIBUTES:
+    ok = rooms.setRoomAttributes(req.resourceId, req.room);
+    if (ok)
+      dirty |= ROOMS_DIRTY;
+    break;
+
+  case BookingRequest::REMOVE_ROOM:
+    ok = rooms.removeRoomDirect(req.resourceId);
+    if (ok)
+      dirty |= ROOMS_DIRTY;
+    break;
+
+  case BookingRequest::ADD_LAPTOP:
+    ok = laptops.addLaptopDirect(req.resourceId);
+    if (ok)
+      dirty |= LAPTOPS_DIRTY;
+    break;
+
+  case BookingRequest::REMOVE_LAPTOP:
+    ok = laptops.removeLaptopDirect(req.resourceId);
+    if (ok)
+      dirty |= LAPTOPS_DIRTY;
+    break;
+
+  case BookingRequest::ADD_BOOK:
+    ok = books.addBookDirect(req.resourceId, req.title, req.author,
+                             req.copies);
+    if (ok)
+      dirty |= BOOKS_DIRTY;
+    break;
+
+  case BookingRequest::REMOVE_BOOK:
+    ok = books.removeBookDirect(req.resourceId);
+    if (ok)
+      dirty |= BOOKS_DIRTY;
+    break;
+
+  case BookingRequest::SET_BOOK_COPIES:
+    ok = books.setBookCopies(req.resourceId, req.copies);
+    if (ok)
+      dirty |= BOOKS_DIRTY;
+    break;
+
+  case BookingRequest::IMPORT_BOOKS:
+    result.count = books.importBooksFromFile(req.resourceId);
+    ok = result.count >= 0;
+    if (result.count > 0)
+      dirty |= BOOKS_DIRTY;
+    break;
+  }
+
+  result.status = ok ? BookingResult::OK : BookingResult::REJECTED;
+  return result;
+}
+
+void BookingEngine::flush(unsigned dirty) {
+  if (dirty & ROOMS_DIRTY) {
+    rooms.saveRoomsToFile();
+    rooms.saveRoomBookingsToFile();
+  }
+  if (dirty & LAPTOPS_DIRTY) {
+    laptops.saveLaptopsToFile();
+    laptops.saveLaptopBookingsToFile();
+  }
+  if (dirty & BOOKS_DIRTY) {
+    books.saveBooksToFile();
+    books.saveBookBookingsToFile();
+    books.saveWaitlistsToFile();
+  }
+}
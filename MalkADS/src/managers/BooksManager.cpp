@@ -1,92 +1,289 @@
 #include "../../include/managers/BooksManager.h"
 #include "../../include/helpers/UIHelpers.h"
+#include "../../include/structures/linked_list.h"
 // #include "book.h"
+#include <atomic>
 #include <cctype>
+#include <cerrno>
+#include <climits>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
 #include <fstream>
 #include <iomanip>
 #include <iostream>
 #include <sstream>
+#include <thread>
+#include <vector>
 
 using namespace std;
 
 BooksManager::BooksManager() {
   loadBooksFromFile();
   loadBookBookingsFromFile();
+  loadWaitlistsFromFile();
 }
 
 BooksManager::~BooksManager() {
   saveBooksToFile();
   saveBookBookingsToFile();
-  // Data Structure Change
-  BookTable.forEach([](const string &id, RedBlackIntervalTree *&tree) {
-    delete tree;
-    tree = nullptr;
+  saveWaitlistsToFile();
+  BookTable.forEach([](const StringRef &id, CopyPool *&pool) {
+    delete pool;
+    pool = nullptr;
   });
   BookTable.clear();
 
   // Clear Author Table
   Author_To_BooksTable.forEach(
-      [](const string &author, LinkedList<string> *&list) {
+      [](const StringRef &author, PostingList *&list) {
         delete list;
         list = nullptr;
       });
   Author_To_BooksTable.clear();
+  delete[] catalog;
+  delete[] catalogIds;
+  delete[] catalogTitles;
+  delete[] catalogAuthors;
+  delete[] catalogLoans;
+
+  waitlistTable.forEach([](const string &id, BookWaitlist *&queue) {
+    delete queue;
+    queue = nullptr;
+  });
+  waitlistTable.clear();
 }
 
-void BooksManager::loadBooksFromFile() {
-  ifstream file("data\\books.txt");
-  if (!file) {
-    cout << "Error opening books.txt\n";
-    return;
-  }
+namespace {
 
-  string line;
-  string bookID;
-  string bookTitle;
-  string bookAuthor;
+// A whole field of a data file as a number; false if it is empty, holds
+// anything else or is out of range
+bool parseField(const string &text, long long &value) {
+  if (text.empty())
+    return false;
+  char *end = nullptr;
+  errno = 0;
+  long long parsed = strtoll(text.c_str(), &end, 10);
+  if (*end != '\0' || errno == ERANGE)
+    return false;
+  value = parsed;
+  return true;
+}
 
-  int commaPos1;
-  int commaPos2;
+bool parseField(const string &text, int &value) {
+  long long parsed;
+  if (!parseField(text, parsed) || parsed < INT_MIN || parsed > INT_MAX)
+    return false;
+  value = static_cast<int>(parsed);
+  return true;
+}
 
-  while (getline(file, line)) {
-    commaPos1 = line.find(',');
-    if (commaPos1 != string::npos) {
-      commaPos2 = line.find(',', commaPos1 + 1);
-
-      if (commaPos2 != string::npos) {
-        bookID = line.substr(0, commaPos1);
-        bookTitle = line.substr(commaPos1 + 1, commaPos2 - (commaPos1 + 1));
-        bookAuthor = line.substr(commaPos2 + 1);
+// One line of a catalog file (views into the file's buffer), and the book
+// the import made of it
+struct CatalogRow {
+  StringRef id;
+  StringRef title;
+  StringRef author;
+  int copies;
+  Book *book; // nullptr if the row was skipped
+};
+
+// A chunk's rows. Appending never moves the rows already parsed, as
+// growing a vector would, and the later passes just walk them in order.
+typedef LinkedList<CatalogRow, 32> CatalogRows;
+
+// Parse the whole lines in [begin, end) of a catalog file
+void parseCatalogLines(const char *begin, const char *end,
+                       CatalogRows &rows) {
+  const char *line = begin;
+  while (line < end) {
+    const char *eol =
+        static_cast<const char *>(memchr(line, '\n', end - line));
+    if (!eol)
+      eol = end;
+    const char *stop = eol > line && eol[-1] == '\r' ? eol - 1 : eol;
+
+    const char *comma1 =
+        static_cast<const char *>(memchr(line, ',', stop - line));
+    const char *comma2 =
+        comma1 ? static_cast<const char *>(
+                     memchr(comma1 + 1, ',', stop - comma1 - 1))
+               : nullptr;
+    if (comma2) {
+      CatalogRow row;
+      row.id = StringRef(line, static_cast<int>(comma1 - line));
+      row.title =
+          StringRef(comma1 + 1, static_cast<int>(comma2 - comma1 - 1));
+
+      // Optional trailing copy count; an author may contain commas, so
+      // only an all-digit last field counts
+      row.copies = 1;
+      const char *digits = stop;
+      while (digits > comma2 + 1 &&
+             isdigit(static_cast<unsigned char>(digits[-1])))
+        digits--;
+      const char *authorEnd = stop;
+      if (digits < stop && digits - 1 > comma2 && digits[-1] == ',') {
+        long long copies = 0;
+        for (const char *d = digits; d < stop && copies <= INT_MAX; d++)
+          copies = copies * 10 + (*d - '0');
+        row.copies = copies > INT_MAX ? INT_MAX : static_cast<int>(copies);
+        authorEnd = digits - 1;
       }
+      if (row.copies < 1)
+        row.copies = 1;
+      row.author =
+          StringRef(comma2 + 1, static_cast<int>(authorEnd - comma2 - 1));
+      row.book = nullptr;
+      rows.push_back(row);
     }
+    line = eol + 1;
+  }
+}
 
-    for (char &c : bookTitle)
-      c = tolower(c);
+// Run task(0) .. task(count - 1) on up to threads threads, the calling
+// thread included
+template <typename Task> void runTasks(int count, int threads, Task task) {
+  atomic<int> next(0);
+  auto work = [&]() {
+    for (int i = next++; i < count; i = next++)
+      task(i);
+  };
+  vector<thread> helpers;
+  for (int t = 1; t < threads && t < count; t++)
+    helpers.emplace_back(work);
+  work();
+  for (thread &helper : helpers)
+    helper.join();
+}
 
-    auto newBook = Book(bookID, bookTitle, bookAuthor);
-    // Data Structure Change: Key by Title
-    ID_To_BookTable.putNew(bookTitle, newBook);
+// func(row) for every row, in file order
+template <typename Func>
+void forEachRow(vector<CatalogRows> &chunks, Func func) {
+  for (CatalogRows &rows : chunks)
+    for (CatalogRow &row : rows)
+      func(row);
+}
 
-    auto *tree = new RedBlackIntervalTree();
-    // Revert: Key BookTable by ID for ISBN lookup
-    BookTable.putNew(bookID, tree);
+} // namespace
 
-    // Update Secondary Index
-    string authorLower = bookAuthor;
-    for (char &c : authorLower)
-      c = tolower(c);
+void BooksManager::loadBooksFromFile() {
+  if (importBooksFromFile("data\\books.txt") < 0)
+    cout << "Error opening books.txt\n";
+}
 
-    LinkedList<string> **listPtr = Author_To_BooksTable.get(authorLower);
-    if (listPtr && *listPtr) {
-      (*listPtr)->push_back(bookTitle);
-    } else {
-      auto *newList = new LinkedList<string>();
-      newList->push_back(bookTitle);
-      Author_To_BooksTable.putNew(authorLower, newList);
-    }
+int BooksManager::importBooksFromFile(const string &path, int threads) {
+  ifstream file(path, ios::in | ios::binary);
+  if (!file)
+    return -1;
+  file.seekg(0, ios::end);
+  const streamoff size = file.tellg();
+  if (size < 0)
+    return -1;
+  vector<char> buffer(static_cast<size_t>(size));
+  file.seekg(0, ios::beg);
+  if (size > 0 && !file.read(&buffer[0], size))
+    return -1;
+  file.close();
+
+  if (threads <= 0) {
+    threads = static_cast<int>(thread::hardware_concurrency());
+    if (threads <= 0)
+      threads = 1;
   }
 
-  file.close();
+  // Cut the buffer into one chunk per thread, each ending at a line end,
+  // but keep chunks big enough to be worth a thread
+  const streamoff MIN_CHUNK = 1 << 16;
+  int chunkCount = static_cast<int>(size / MIN_CHUNK) + 1;
+  if (chunkCount > threads)
+    chunkCount = threads;
+  const char *data = buffer.empty() ? nullptr : &buffer[0];
+  const char *dataEnd = data + size;
+  vector<const char *> cuts(chunkCount + 1, dataEnd);
+  cuts[0] = data;
+  for (int c = 1; c < chunkCount; c++) {
+    const char *cut = data + size * c / chunkCount;
+    if (cut < cuts[c - 1])
+      cut = cuts[c - 1];
+    while (cut < dataEnd && cut > data && cut[-1] != '\n')
+      cut++;
+    cuts[c] = cut;
+  }
+  vector<CatalogRows> chunks(chunkCount);
+  runTasks(chunkCount, threads, [&](int c) {
+    parseCatalogLines(cuts[c], cuts[c + 1], chunks[c]);
+  });
+
+  int rowCount = 0;
+  for (const CatalogRows &rows : chunks)
+    rowCount += rows.size();
+
+  // Claim IDs and titles in file order, as insertBook would, copying the
+  // strings of the books that make it into the arena. The arena and the
+  // two tables are shared, so this pass runs on one thread. Numbering the
+  // books here lets every later index be built independently.
+  ID_To_BookTable.reserve(ID_To_BookTable.size() + rowCount);
+  Title_To_IDTable.reserve(Title_To_IDTable.size() + rowCount);
+  int added = 0;
+  forEachRow(chunks, [&](CatalogRow &row) {
+    if (ID_To_BookTable.contains(row.id) ||
+        Title_To_IDTable.contains(row.title))
+      return;
+    row.id = strings.store(row.id);
+    row.title = storeTitle(row.title);
+    row.author = authors.intern(row.author);
+    ID_To_BookTable.putNew(row.id,
+                           Book(row.id, row.title, row.author, row.copies));
+    Title_To_IDTable.putNew(row.title, row.id);
+    row.book = ID_To_BookTable.get(row.id);
+    assignCatalogId(row.book);
+    added++;
+  });
+
+  // Each task writes only its own index (the same steps as indexBook)
+  runTasks(5, threads, [&](int task) {
+    switch (task) {
+    case 0:
+      BookTable.reserve(BookTable.size() + added);
+      forEachRow(chunks, [&](CatalogRow &row) {
+        if (row.book)
+          BookTable.putNew(row.id, new CopyPool(row.copies));
+      });
+      break;
+    case 1:
+      forEachRow(chunks, [&](CatalogRow &row) {
+        if (row.book)
+          indexAuthor(row.book);
+      });
+      break;
+    case 2:
+      forEachRow(chunks, [&](CatalogRow &row) {
+        if (row.book)
+          searchIndex.add(row.book->getCatalogId(),
+                          row.book->getTitle() + " " + row.book->getAuthor());
+      });
+      break;
+    case 3:
+      forEachRow(chunks, [&](CatalogRow &row) {
+        if (row.book)
+          titleMatcher.add(row.book->getCatalogId(), row.book->getTitle());
+      });
+      break;
+    case 4:
+      forEachRow(chunks, [&](CatalogRow &row) {
+        if (!row.book)
+          return;
+        completions.insert(TextIndex::normalize(row.book->getTitle()),
+                           row.book->getTitle());
+        completions.insert(TextIndex::normalize(row.book->getAuthor()),
+                           row.book->getAuthor());
+      });
+      break;
+    }
+  });
+
+  return added;
 }
 
 void BooksManager::saveBooksToFile() {
@@ -96,10 +293,16 @@ void BooksManager::saveBooksToFile() {
     return;
   }
 
-  const_cast<HashMap<string, Book> &>(ID_To_BookTable)
-      .forEach([&](const string &id, Book &book) {
-        file << id << "," << book.getTitle() << "," << book.getAuthor() << "\n";
-      });
+  // Catalog order, which is the order the books were added in
+  for (int i = 0; i < catalogEnd; i++) {
+    if (!catalog[i])
+      continue;
+    file << catalogIds[i] << "," << catalogTitles[i] << ","
+         << catalogAuthors[i];
+    if (catalog[i]->getCopies() > 1)
+      file << "," << catalog[i]->getCopies();
+    file << "\n";
+  }
 
   file.close();
 }
@@ -138,16 +341,10 @@ void BooksManager::BorrowBook(User *user) {
       cin.ignore();
       getline(cin, titlesearch);
 
-      string titlesearchLower = titlesearch;
-      for (char &c : titlesearchLower)
-        c = tolower(c);
-
-      Book *foundBook = ID_To_BookTable.get(titlesearchLower);
+      Book *foundBook = findBookByTitleInteractive(titlesearch);
 
-      if (!foundBook) {
-        printError("Sorry, the library does not have this book.");
+      if (!foundBook)
         continue;
-      }
 
       foundbookID = foundBook->getID();
       foundBookTitle = foundBook->getTitle();
@@ -162,20 +359,16 @@ void BooksManager::BorrowBook(User *user) {
       cin.ignore();
       getline(cin, searchAuthor);
 
-      string searchAuthorLower = searchAuthor;
-      for (char &c : searchAuthorLower)
-        c = tolower(c);
-
       bool authorfound = false;
       cout << COLOR_MENU << "\nHere are the books we have by this author:\n\n"
            << COLOR_RESET;
 
-      LinkedList<string> **listPtr =
-          Author_To_BooksTable.get(searchAuthorLower);
+      PostingList **listPtr = Author_To_BooksTable.get(searchAuthor);
       if (listPtr && *listPtr) {
         authorfound = true;
-        (*listPtr)->forEach(
-            [&](const string &title) { cout << "  - " << title << "\n"; });
+        (*listPtr)->forEach([&](int catalogId) {
+          cout << "  - " << catalogTitles[catalogId] << "\n";
+        });
       }
 
       if (!authorfound) {
@@ -189,16 +382,10 @@ void BooksManager::BorrowBook(User *user) {
            << COLOR_RESET;
       getline(cin, titlesearch);
 
-      string titlesearchLower = titlesearch;
-      for (char &c : titlesearchLower)
-        c = tolower(c);
-
-      Book *foundBook = ID_To_BookTable.get(titlesearchLower);
+      Book *foundBook = findBookByTitleInteractive(titlesearch);
 
-      if (!foundBook) {
-        printError("Sorry, the library does not have this book.");
+      if (!foundBook)
         continue;
-      }
 
       foundbookID = foundBook->getID();
       foundBookTitle = foundBook->getTitle();
@@ -206,11 +393,7 @@ void BooksManager::BorrowBook(User *user) {
       bookfound = true;
 
       // Check if author matches
-      string bookAuthorLower = foundBookAuthor;
-      for (char &c : bookAuthorLower)
-        c = tolower(c);
-
-      if (bookAuthorLower != searchAuthorLower) {
+      if (!StringRef(foundBookAuthor).equalsIgnoreCase(searchAuthor)) {
         cout << COLOR_ERROR << "\nNote: the author of \"" << foundBookTitle
              << "\" is " << foundBookAuthor << "."
              << "\nThis does not match the author you initially searched for."
@@ -261,20 +444,24 @@ void BooksManager::BorrowBook(User *user) {
         continue;
       }
 
-      RedBlackIntervalTree **treePtr = BookTable.get(foundbookID);
-      if (!treePtr || !(*treePtr)) {
-        printError("Internal Error: No tree for this book ID.");
+      CopyPool **poolPtr = BookTable.get(foundbookID);
+      if (!poolPtr || !(*poolPtr)) {
+        printError("Internal Error: No copies for this book ID.");
         continue;
       }
 
-      RedBlackIntervalTree *tree = *treePtr;
-      if (!tree->searchOverlap(startperiod, endperiod, true)) {
-        tree->insert(startperiod, endperiod, user->getUsername());
+      CopyPool *pool = *poolPtr;
+      int copy = pool->findFree(startperiod, endperiod);
+      if (copy >= 0) {
+        pool->insert(copy, startperiod, endperiod, user->getUsername());
+        recordLoan(foundbookID, startperiod);
         user->addBookBooking(startperiod, endperiod);
 
         stringstream ss;
-        ss << "Book \"" << foundBookTitle
-           << "\" booked successfully from: " << setw(2) << setfill('0') << sDay
+        ss << "Book \"" << foundBookTitle << "\"";
+        if (pool->copies() > 1)
+          ss << " (copy " << copy + 1 << " of " << pool->copies() << ")";
+        ss << " booked successfully from: " << setw(2) << setfill('0') << sDay
            << "/" << setw(2) << setfill('0') << sMonth << "/" << sYear << " "
            << setw(2) << setfill('0') << sHour << ":" << setw(2) << setfill('0')
            << sMinute << " to " << setw(2) << setfill('0') << eDay << "/"
@@ -288,6 +475,23 @@ void BooksManager::BorrowBook(User *user) {
         return; // Exit after successful booking
       } else {
         printError("Unable to borrow this book during the desired period.");
+        cout << COLOR_PROMPT
+             << "Join the waitlist? You will get the book automatically "
+                "if it is returned in time. (y/n): "
+             << COLOR_RESET;
+        char choice;
+        cin >> choice;
+        if (tolower(choice) == 'y') {
+          if (joinWaitlist(user, foundbookID, startperiod, endperiod)) {
+            stringstream ss;
+            ss << "You are number "
+               << waitlistPosition(foundbookID, user->getUsername())
+               << " on the waitlist for \"" << foundBookTitle << "\".";
+            printSuccess(ss.str());
+            return;
+          }
+          printError("You are already on the waitlist for this book.");
+        }
       }
     }
   }
@@ -295,7 +499,8 @@ void BooksManager::BorrowBook(User *user) {
 
 // Non-interactive version for Python API
 bool BooksManager::borrowBookDirect(User *user, const string &bookId,
-                                    int startTime, int endTime) {
+                                    int startTime, int endTime,
+                                    int *assignedCopy) {
   if (!user)
     return false;
 
@@ -310,21 +515,24 @@ bool BooksManager::borrowBookDirect(User *user, const string &bookId,
   }
 
   // Check if book exists
-  RedBlackIntervalTree **treePtr = BookTable.get(bookId);
-  if (!treePtr || !(*treePtr)) {
+  CopyPool **poolPtr = BookTable.get(bookId);
+  if (!poolPtr || !(*poolPtr)) {
     return false; // Book doesn't exist
   }
 
-  RedBlackIntervalTree *tree = *treePtr;
-
-  // Check if book is available
-  if (tree->searchOverlap(startTime, endTime, false)) {
-    return false; // Book conflict
+  // Check if any copy is available
+  CopyPool *pool = *poolPtr;
+  int copy = pool->findFree(startTime, endTime);
+  if (copy < 0) {
+    return false; // Every copy is on loan
   }
 
-  // Borrow the book
-  tree->insert(startTime, endTime, user->getUsername());
+  // Borrow that copy
+  pool->insert(copy, startTime, endTime, user->getUsername());
+  recordLoan(bookId, startTime);
   user->addBookBooking(startTime, endTime);
+  if (assignedCopy)
+    *assignedCopy = copy;
 
   return true;
 }
@@ -341,228 +549,629 @@ void BooksManager::addBookInteractive() {
   cout << COLOR_PROMPT << "Enter author: " << COLOR_RESET;
   getline(cin, author);
 
-  string titleLower = title;
-  for (char &c : titleLower)
-    c = tolower(c);
-
-  if (ID_To_BookTable.contains(titleLower)) {
-    printError("A book with this Title already exists.");
+  if (!insertBook(id, title, author)) {
+    printError("A book with this ID or Title already exists.");
     return;
   }
 
-  Book b(id, title, author);
-  ID_To_BookTable.putNew(titleLower, b);
+  printSuccess("Book added successfully.");
+}
 
-  auto *tree = new RedBlackIntervalTree();
-  // Key BookTable by ID
-  BookTable.putNew(id, tree);
+// Non-interactive version for Python API
+bool BooksManager::addBookDirect(const string &bookId, const string &title,
+                                 const string &author, int copies) {
+  return copies >= 1 && insertBook(bookId, title, author, copies);
+}
 
-  // Update Secondary Index
-  string authorLower = author;
-  for (char &c : authorLower)
-    c = tolower(c);
+bool BooksManager::setBookCopies(const string &bookId, int copies) {
+  Book *book = ID_To_BookTable.get(bookId);
+  CopyPool **poolPtr = BookTable.get(bookId);
+  if (!book || !poolPtr || !(*poolPtr) || !(*poolPtr)->resize(copies))
+    return false;
+  book->setCopies(copies);
+  // New copies may serve requests that were waiting
+  promoteWaitlist(bookId);
+  return true;
+}
 
-  LinkedList<string> **listPtr = Author_To_BooksTable.get(authorLower);
-  if (listPtr && *listPtr) {
-    (*listPtr)->push_back(title);
-  } else {
-    auto *newList = new LinkedList<string>();
-    newList->push_back(title);
-    Author_To_BooksTable.putNew(authorLower, newList);
+int BooksManager::availableCopies(StringRef bookId, int startTime,
+                                  int endTime) const {
+  CopyPool **poolPtr = BookTable.get(bookId);
+  if (!poolPtr || !(*poolPtr))
+    return 0;
+  return (*poolPtr)->freeCount(startTime, endTime);
+}
+
+void BooksManager::removeBookInteractive() {
+  printSectionHeader("Remove Book");
+
+  string id;
+  cout << COLOR_PROMPT << "Enter book ID to remove: " << COLOR_RESET;
+  cin >> id;
+
+  if (!removeBookDirect(id)) {
+    printError("No book with this ID.");
+    return;
   }
 
-  printSuccess("Book added successfully.");
+  printSuccess("Book removed.");
 }
 
 // Non-interactive version for Python API
-bool BooksManager::addBookDirect(const string &bookId, const string &title,
-                                 const string &author) {
-  string titleLower = title;
-  for (char &c : titleLower)
-    c = tolower(c);
-
-  if (ID_To_BookTable.contains(titleLower)) {
-    return false; // Book already exists (by title)
+bool BooksManager::removeBookDirect(const string &bookId) {
+  Book *book = ID_To_BookTable.get(bookId);
+  if (!book) {
+    return false; // Book doesn't exist
   }
 
-  // Create book with provided details
-  Book b(bookId, title, author);
-  ID_To_BookTable.putNew(titleLower, b);
+  CopyPool **poolPtr = BookTable.get(bookId);
+  if (poolPtr && *poolPtr) {
+    delete *poolPtr;
+    *poolPtr = nullptr;
+  }
 
-  auto *tree = new RedBlackIntervalTree();
-  // Key BookTable by ID
-  BookTable.putNew(bookId, tree);
+  // Remove data from secondary indexes
+  unindexBook(book);
+  Title_To_IDTable.erase(book->titleRef());
 
-  // Update Secondary Index
-  string authorLower = author;
-  for (char &c : authorLower)
-    c = tolower(c);
+  dropWaitlist(bookId);
 
-  LinkedList<string> **listPtr = Author_To_BooksTable.get(authorLower);
-  if (listPtr && *listPtr) {
-    (*listPtr)->push_back(title);
-  } else {
-    auto *newList = new LinkedList<string>();
-    newList->push_back(title);
-    Author_To_BooksTable.putNew(authorLower, newList);
-  }
+  BookTable.erase(bookId);
+  demand.removeResource(bookId);
+  ID_To_BookTable.erase(bookId);
 
   return true;
 }
 
-void BooksManager::removeBookInteractive() {
-  printSectionHeader("Remove Book");
+bool BooksManager::insertBook(const string &bookId, const string &title,
+                              const string &author, int copies) {
+  if (ID_To_BookTable.contains(bookId) || Title_To_IDTable.contains(title))
+    return false; // Book already exists (by ID or title)
 
-  string id;
-  cout << COLOR_PROMPT << "Enter book ID to remove: " << COLOR_RESET;
-  cin >> id;
+  if (copies < 1)
+    copies = 1;
+  // The tables are keyed by the stored copies, never by the arguments
+  const StringRef id = strings.store(bookId);
+  const StringRef storedTitle = storeTitle(title);
+  ID_To_BookTable.putNew(
+      id, Book(id, storedTitle, authors.intern(author), copies));
+  Title_To_IDTable.putNew(storedTitle, id);
 
-  bool found = false;
-  string titleToRemove = "";
-  string authorToRemove = "";
+  // Key BookTable by ID
+  BookTable.putNew(id, new CopyPool(copies));
 
-  ID_To_BookTable.forEach([&](const string &keyTitle, Book &book) {
-    if (book.getID() == id) {
-      found = true;
-      titleToRemove = keyTitle;
-      authorToRemove = book.getAuthor();
+  // Update Secondary Index
+  indexBook(ID_To_BookTable.get(id));
+  return true;
+}
+
+StringRef BooksManager::storeTitle(StringRef title) {
+  char *stored = strings.allocate(title.size());
+  if (title.size())
+    memcpy(stored, title.data(), title.size());
+  Book::formatTitle(stored, title.size());
+  return StringRef(stored, title.size());
+}
+
+Book *BooksManager::findBookByTitle(const string &title) {
+  StringRef *idPtr = Title_To_IDTable.get(title);
+  return idPtr ? ID_To_BookTable.get(*idPtr) : nullptr;
+}
+
+void BooksManager::rankMatches(const string &query, bool byPopularity,
+                               TopK<RankedMatch, MatchRanking> &best) const {
+  vector<string> terms;
+  istringstream words(TextIndex::normalize(query));
+  for (string word; words >> word;)
+    terms.push_back(word);
+
+  searchIndex.search(query, 0, [&](int catalogId) {
+    const string title = TextIndex::normalize(catalogTitles[catalogId].str());
+    const string author =
+        TextIndex::normalize(catalogAuthors[catalogId].str());
+    double score = 0;
+    for (const string &term : terms) {
+      int starts;
+      int n = TextIndex::countOccurrences(title, term, &starts);
+      score += TITLE_TERM_WEIGHT * (n + WORD_START_BONUS * starts);
+      n = TextIndex::countOccurrences(author, term, &starts);
+      score += AUTHOR_TERM_WEIGHT * (n + WORD_START_BONUS * starts);
     }
+    if (byPopularity)
+      score += log2(1.0 + catalogLoans[catalogId]);
+    best.offer(RankedMatch(score, catalogId, catalogTitles[catalogId]));
   });
+}
 
-  if (!found) {
-    printError("No book with this ID.");
-    return;
+Book *BooksManager::findBookByTitleInteractive(const string &title) {
+  Book *book = findBookByTitle(title);
+  if (book)
+    return book;
+
+  const int MAX_SUGGESTIONS = 5;
+  Book *suggestions[MAX_SUGGESTIONS];
+  int count = 0;
+  findSimilarTitles(title, TITLE_TYPO_DISTANCE, MAX_SUGGESTIONS,
+                    [&](Book &match, int) { suggestions[count++] = &match; });
+  if (count == 0) {
+    printError("Sorry, the library does not have this book.");
+    return nullptr;
   }
 
-  RedBlackIntervalTree **treePtr = BookTable.get(id); // Use ID
-  if (treePtr && *treePtr) {
-    delete *treePtr;
-    *treePtr = nullptr;
+  cout << COLOR_MENU << "\nWe could not find \"" << title
+       << "\". Did you mean:\n";
+  for (int i = 0; i < count; i++)
+    cout << "  " << i + 1 << ". " << suggestions[i]->getTitle() << " by "
+         << suggestions[i]->getAuthor() << "\n";
+  cout << "  0. None of these\n\n" << COLOR_RESET;
+  cout << COLOR_PROMPT << "Choose a book: " << COLOR_RESET;
+
+  int choice;
+  if (!(cin >> choice)) {
+    cin.clear();
+    cin.ignore(10000, '\n');
+    return nullptr;
   }
+  if (choice < 1 || choice > count)
+    return nullptr;
+  return suggestions[choice - 1];
+}
+
+void BooksManager::indexBook(Book *book) {
+  const int catalogId = assignCatalogId(book);
+  searchIndex.add(catalogId, book->getTitle() + " " + book->getAuthor());
+  completions.insert(TextIndex::normalize(book->getTitle()), book->getTitle());
+  titleMatcher.add(catalogId, book->getTitle());
+  completions.insert(TextIndex::normalize(book->getAuthor()),
+                     book->getAuthor());
+  indexAuthor(book);
+}
 
-  // Remove data from secondary index
-  Book *b = ID_To_BookTable.get(titleToRemove);
-  if (b) {
-    string originalTitle = b->getTitle();
-    string authorLower = b->getAuthor();
-    for (char &c : authorLower)
-      c = tolower(c);
-
-    LinkedList<string> **listPtr = Author_To_BooksTable.get(authorLower);
-    if (listPtr && *listPtr) {
-      (*listPtr)->remove(originalTitle);
-      if ((*listPtr)->empty()) {
-        delete *listPtr;
-        Author_To_BooksTable.erase(authorLower);
+int BooksManager::assignCatalogId(Book *book) {
+  int catalogId;
+  if (!freeCatalogIds.empty()) {
+    int last = freeCatalogIds.size() - 1;
+    catalogId = freeCatalogIds.at(last);
+    freeCatalogIds.removeAt(last);
+  } else {
+    if (catalogEnd == catalogCapacity) {
+      int newCapacity = catalogCapacity ? catalogCapacity * 2 : 64;
+      Book **grown = new Book *[newCapacity];
+      StringRef *grownIds = new StringRef[newCapacity];
+      StringRef *grownTitles = new StringRef[newCapacity];
+      StringRef *grownAuthors = new StringRef[newCapacity];
+      long long *grownLoans = new long long[newCapacity];
+      for (int i = 0; i < catalogEnd; i++) {
+        grown[i] = catalog[i];
+        grownIds[i] = catalogIds[i];
+        grownTitles[i] = catalogTitles[i];
+        grownAuthors[i] = catalogAuthors[i];
+        grownLoans[i] = catalogLoans[i];
       }
+      delete[] catalog;
+      delete[] catalogIds;
+      delete[] catalogTitles;
+      delete[] catalogAuthors;
+      delete[] catalogLoans;
+      catalog = grown;
+      catalogIds = grownIds;
+      catalogTitles = grownTitles;
+      catalogAuthors = grownAuthors;
+      catalogLoans = grownLoans;
+      catalogCapacity = newCapacity;
     }
+    catalogId = catalogEnd++;
   }
+  catalog[catalogId] = book;
+  catalogIds[catalogId] = book->idRef();
+  catalogTitles[catalogId] = book->titleRef();
+  catalogAuthors[catalogId] = book->authorRef();
+  // Loans are only recorded for books in the catalog, and removing a book
+  // forgets its demand, so a newly numbered book has none
+  catalogLoans[catalogId] = 0;
+  book->setCatalogId(catalogId);
+  return catalogId;
+}
 
-  BookTable.erase(id); // Use ID
-  ID_To_BookTable.erase(titleToRemove);
+void BooksManager::recordLoan(const string &bookId, long long start,
+                              int delta) {
+  demand.record(bookId, start, delta);
+  Book *book = ID_To_BookTable.get(bookId);
+  if (book && book->getCatalogId() >= 0)
+    catalogLoans[book->getCatalogId()] += delta;
+}
 
-  printSuccess("Book removed.");
+void BooksManager::indexAuthor(Book *book) {
+  PostingList **listPtr = Author_To_BooksTable.get(book->authorRef());
+  PostingList *list = listPtr ? *listPtr : nullptr;
+  if (!list) {
+    list = new PostingList();
+    Author_To_BooksTable.putNew(book->authorRef(), list);
+  }
+  book->setAuthorPos(list->append(book->getCatalogId()));
 }
 
-// Non-interactive version for Python API
-bool BooksManager::removeBookDirect(const string &bookId) {
-  bool found = false;
-  string titleToRemove = "";
-  string authorToRemove = "";
+void BooksManager::unindexBook(Book *book) {
+  const int catalogId = book->getCatalogId();
+  if (catalogId < 0)
+    return;
 
-  ID_To_BookTable.forEach([&](const string &keyTitle, Book &book) {
-    if (book.getID() == bookId) {
-      found = true;
-      titleToRemove = keyTitle;
-      authorToRemove = book.getAuthor();
+  PostingList **listPtr = Author_To_BooksTable.get(book->authorRef());
+  if (listPtr && *listPtr) {
+    // The author's last book moves into the hole; fix its back-pointer
+    int moved = (*listPtr)->removeAt(book->getAuthorPos());
+    if (moved >= 0)
+      catalog[moved]->setAuthorPos(book->getAuthorPos());
+    if ((*listPtr)->empty()) {
+      delete *listPtr;
+      Author_To_BooksTable.erase(book->authorRef());
     }
+  }
+
+  searchIndex.remove(catalogId);
+  titleMatcher.remove(catalogId);
+  completions.remove(TextIndex::normalize(book->getTitle()));
+  completions.remove(TextIndex::normalize(book->getAuthor()));
+  catalog[catalogId] = nullptr;
+  catalogIds[catalogId] = catalogTitles[catalogId] =
+      catalogAuthors[catalogId] = StringRef();
+  catalogLoans[catalogId] = 0;
+  freeCatalogIds.append(catalogId);
+  book->setCatalogId(-1);
+  book->setAuthorPos(-1);
+}
+
+Book *BooksManager::getBook(const string &bookId) {
+  return ID_To_BookTable.get(bookId);
+}
+
+void BooksManager::loadBookBookingsFromFile() {
+  ifstream file("data/book_bookings.txt");
+  if (!file)
+    return;
+
+  // id,start,end,username[,copy]; files written before books had copies
+  // have no copy field, and those loans go to whichever copy is free
+  string line;
+  while (getline(file, line)) {
+    if (line.empty())
+      continue;
+
+    size_t c1 = line.find(',');
+    if (c1 == string::npos)
+      continue;
+    size_t c2 = line.find(',', c1 + 1);
+    if (c2 == string::npos)
+      continue;
+    size_t c3 = line.find(',', c2 + 1);
+    if (c3 == string::npos)
+      continue;
+    size_t c4 = line.find(',', c3 + 1);
+
+    string id = line.substr(0, c1);
+    string username = line.substr(
+        c3 + 1, c4 == string::npos ? string::npos : c4 - (c3 + 1));
+    int start, end;
+    int copy = -1;
+    if (!parseField(line.substr(c1 + 1, c2 - (c1 + 1)), start) ||
+        !parseField(line.substr(c2 + 1, c3 - (c2 + 1)), end) ||
+        (c4 != string::npos && !parseField(line.substr(c4 + 1), copy)) ||
+        username.empty() || end < start) {
+      cout << "Ignoring bad book booking: " << line << "\n";
+      continue;
+    }
+
+    CopyPool **poolPtr = BookTable.get(id);
+    if (!poolPtr || !(*poolPtr))
+      continue;
+
+    CopyPool *pool = *poolPtr;
+    if (!pool->isFree(copy, start, end))
+      copy = pool->findFree(start, end);
+    if (copy < 0)
+      copy = 0; // Overbooked on disk; keep the loan rather than drop it
+    pool->insert(copy, start, end, username);
+    recordLoan(id, start);
+  }
+}
+
+void BooksManager::saveBookBookingsToFile() const {
+  ofstream file("data/book_bookings.txt", ios::out | ios::trunc);
+  if (!file) {
+    cout << "Error opening book_bookings.txt for writing\n";
+    return;
+  }
+
+  const_cast<HashMap<StringRef, CopyPool *> &>(BookTable)
+      .forEach([&](const StringRef &bookId, CopyPool *&pool) {
+        if (!pool)
+          return;
+        pool->forEachLoan(
+            [&](int copy, int low, int high, const string &username) {
+              file << bookId << "," << low << "," << high << "," << username
+                   << "," << copy << "\n";
+            });
+      });
+}
+
+bool BooksManager::hasBorrowedBefore(const CopyPool *pool,
+                                     const string &username) {
+  bool found = false;
+  pool->forEachLoan([&](int, int low, int high, const string &who) {
+    if (who == username)
+      found = true;
   });
+  return found;
+}
+
+bool BooksManager::joinWaitlist(User *user, const string &bookId,
+                                int startTime, int endTime) {
+  if (!user || startTime >= endTime)
+    return false;
+
+  if ((endTime - startTime) > 30 * 24 * 3600)
+    return false;
 
-  if (!found) {
+  if (!user->canBookBook(startTime, endTime))
+    return false; // Would exceed the 3-book limit anyway
+
+  CopyPool **poolPtr = BookTable.get(bookId);
+  if (!poolPtr || !(*poolPtr))
     return false; // Book doesn't exist
+
+  CopyPool *pool = *poolPtr;
+  if (pool->findFree(startTime, endTime) >= 0)
+    return false; // A copy is free, borrow it directly
+
+  WaitlistRequest req;
+  req.username = user->getUsername();
+  req.user = user;
+  req.start = startTime;
+  req.end = endTime;
+  req.requestTime = getCurrentSeconds();
+  req.repeatBorrower = hasBorrowedBefore(pool, req.username);
+  req.priorityKey =
+      req.requestTime + (req.repeatBorrower ? REPEAT_BORROWER_PENALTY : 0);
+  req.seq = nextWaitlistSeq++;
+
+  return enqueueWaitlistRequest(bookId, req); // false if already waiting
+}
+
+bool BooksManager::enqueueWaitlistRequest(const string &bookId,
+                                          WaitlistRequest &req) {
+  BookWaitlist **queuePtr = waitlistTable.get(bookId);
+  BookWaitlist *queue = queuePtr ? *queuePtr : nullptr;
+  if (!queue) {
+    queue = new BookWaitlist();
+    waitlistTable.putNew(bookId, queue);
   }
 
-  RedBlackIntervalTree **treePtr = BookTable.get(bookId);
-  if (treePtr && *treePtr) {
-    delete *treePtr;
-    *treePtr = nullptr;
+  req.lapseTimer = waitlistTimers.schedule(
+      req.start, WaitlistLapse(bookId, req.username, req.seq));
+  if (!queue->push(req)) {
+    waitlistTimers.cancel(req.lapseTimer);
+    return false;
   }
+  return true;
+}
 
-  // Remove data from secondary index
-  Book *b = ID_To_BookTable.get(titleToRemove);
-  if (b) {
-    string originalTitle = b->getTitle();
-    string authorLower = b->getAuthor();
-    for (char &c : authorLower)
-      c = tolower(c);
-
-    LinkedList<string> **listPtr = Author_To_BooksTable.get(authorLower);
-    if (listPtr && *listPtr) {
-      (*listPtr)->remove(originalTitle);
-      if ((*listPtr)->empty()) {
-        delete *listPtr;
-        Author_To_BooksTable.erase(authorLower);
-      }
-    }
+void BooksManager::dropWaitlist(const string &bookId) {
+  BookWaitlist **queuePtr = waitlistTable.get(bookId);
+  if (!queuePtr)
+    return;
+  if (*queuePtr) {
+    (*queuePtr)->queue.forEach([&](int, const WaitlistRequest &req) {
+      waitlistTimers.cancel(req.lapseTimer);
+    });
+    delete *queuePtr;
   }
+  waitlistTable.erase(bookId);
+}
 
-  BookTable.erase(bookId);
-  ID_To_BookTable.erase(titleToRemove);
+bool BooksManager::leaveWaitlist(User *user, const string &bookId) {
+  if (!user)
+    return false;
+  BookWaitlist **queuePtr = waitlistTable.get(bookId);
+  if (!queuePtr || !(*queuePtr))
+    return false;
 
+  BookWaitlist *waitlist = *queuePtr;
+  int *handle = waitlist->handleByUser.get(user->getUsername());
+  if (!handle)
+    return false;
+  waitlistTimers.cancel(waitlist->queue.get(*handle).lapseTimer);
+  return waitlist->erase(user->getUsername());
+}
+
+int BooksManager::waitlistPosition(const string &bookId,
+                                   const string &username) const {
+  BookWaitlist **queuePtr = waitlistTable.get(bookId);
+  if (!queuePtr || !(*queuePtr))
+    return 0;
+
+  const BookWaitlist *waitlist = *queuePtr;
+  int *handle = waitlist->handleByUser.get(username);
+  if (!handle)
+    return 0;
+
+  // Position = 1 + number of requests ordered ahead of this user's
+  const WaitlistRequest &mine = waitlist->queue.get(*handle);
+  WaitlistComparator ahead;
+  int position = 1;
+  waitlist->queue.forEach([&](int, const WaitlistRequest &req) {
+    if (ahead(req, mine))
+      position++;
+  });
+  return position;
+}
+
+int BooksManager::waitlistSize(const string &bookId) const {
+  BookWaitlist **queuePtr = waitlistTable.get(bookId);
+  return (queuePtr && *queuePtr) ? (*queuePtr)->queue.size() : 0;
+}
+
+int BooksManager::promoteWaitlist(const string &bookId) {
+  BookWaitlist **queuePtr = waitlistTable.get(bookId);
+  CopyPool **poolPtr = BookTable.get(bookId);
+  if (!queuePtr || !(*queuePtr) || !poolPtr || !(*poolPtr))
+    return 0;
+
+  BookWaitlist *queue = *queuePtr;
+  CopyPool *pool = *poolPtr;
+  int allocated = 0;
+
+  while (!queue->queue.isEmpty()) {
+    WaitlistRequest head = queue->queue.top();
+
+    // The head keeps its place until a copy frees up for its window, so
+    // later requests cannot jump the queue.
+    const int copy = pool->findFree(head.start, head.end);
+    if (copy < 0)
+      break;
+
+    queue->pop();
+    waitlistTimers.cancel(head.lapseTimer);
+
+    // Drop requests from users who meanwhile reached the 3-book limit
+    if (head.user && !head.user->canBookBook(head.start, head.end))
+      continue;
+
+    pool->insert(copy, head.start, head.end, head.username);
+    recordLoan(bookId, head.start);
+    if (head.user)
+      head.user->addBookBooking(head.start, head.end);
+    allocated++;
+  }
+
+  return allocated;
+}
+
+bool BooksManager::cancelBookLoanDirect(User *user, const string &bookId,
+                                        int startTime, int endTime) {
+  if (!user)
+    return false;
+
+  CopyPool **poolPtr = BookTable.get(bookId);
+  if (!poolPtr || !(*poolPtr))
+    return false;
+
+  CopyPool *pool = *poolPtr;
+  const int copy = pool->findLoan(startTime, endTime, user->getUsername());
+  if (copy < 0)
+    return false; // No such loan for this user
+
+  pool->remove(copy, startTime, endTime);
+  recordLoan(bookId, startTime, -1);
+  user->removeBookBooking(startTime, endTime);
+
+  promoteWaitlist(bookId);
   return true;
 }
 
-Book *BooksManager::getBook(const string &bookId) {
-  // We need to return the Book by ID.
-  // ID_To_BookTable is keyed by Title.
-  // We must iterate to find the ID.
-  // This helper is used by Python bindings
-  // Or usually valid since bookId is unique.
-  // Searching Title map by ID is O(N).
-
-  // Will try to solve that when we have time
-
-  Book *foundBook = nullptr;
-  ID_To_BookTable.forEach([&](const string &keyTitle, Book &book) {
-    if (book.getID() == bookId) {
-      foundBook = &book;
-    }
+int BooksManager::advanceClock(long long now) {
+  int lapsed = 0;
+  waitlistTimers.advance(now, [&](long long, WaitlistLapse &lapse) {
+    BookWaitlist **queuePtr = waitlistTable.get(lapse.bookId);
+    if (!queuePtr || !(*queuePtr))
+      return;
+
+    BookWaitlist *waitlist = *queuePtr;
+    int *handle = waitlist->handleByUser.get(lapse.username);
+    if (!handle || waitlist->queue.get(*handle).seq != lapse.seq)
+      return; // Request was allocated or withdrawn in the meantime
+
+    waitlist->erase(lapse.username);
+    lapsed++;
+
+    // The lapsed request may have been holding back the ones behind it
+    promoteWaitlist(lapse.bookId);
   });
-  return foundBook;
+  return lapsed;
 }
 
-void BooksManager::loadBookBookingsFromFile() {
-  loadBookingsFromFile("data/book_bookings.txt", BookTable);
+void BooksManager::loadWaitlistsFromFile() {
+  ifstream file("data/book_waitlist.txt");
+  if (!file)
+    return;
+
+  // id,start,end,username,requestTime,repeat,seq
+  string line;
+  while (getline(file, line)) {
+    if (line.empty())
+      continue;
+
+    string fields[7];
+    size_t pos = 0;
+    int n = 0;
+    for (; n < 7; n++) {
+      size_t comma = line.find(',', pos);
+      fields[n] = line.substr(pos, comma == string::npos ? string::npos
+                                                         : comma - pos);
+      if (comma == string::npos) {
+        n++;
+        break;
+      }
+      pos = comma + 1;
+    }
+    if (n != 7)
+      continue;
+
+    if (!BookTable.contains(fields[0]))
+      continue;
+
+    WaitlistRequest req;
+    if (!parseField(fields[1], req.start) || !parseField(fields[2], req.end) ||
+        !parseField(fields[4], req.requestTime) ||
+        !parseField(fields[6], req.seq) || fields[3].empty()) {
+      cout << "Ignoring bad waitlist entry: " << line << "\n";
+      continue;
+    }
+    req.username = fields[3];
+    req.repeatBorrower = fields[5] == "1";
+    req.priorityKey =
+        req.requestTime + (req.repeatBorrower ? REPEAT_BORROWER_PENALTY : 0);
+    if (req.seq >= nextWaitlistSeq)
+      nextWaitlistSeq = req.seq + 1;
+
+    enqueueWaitlistRequest(fields[0], req);
+  }
 }
 
-void BooksManager::saveBookBookingsToFile() const {
-  saveBookingsToFile("data/book_bookings.txt", BookTable);
+void BooksManager::saveWaitlistsToFile() const {
+  ofstream file("data/book_waitlist.txt", ios::out | ios::trunc);
+  if (!file) {
+    cout << "Error opening book_waitlist.txt for writing\n";
+    return;
+  }
+
+  const_cast<HashMap<string, BookWaitlist *> &>(waitlistTable)
+      .forEach([&](const string &bookId, BookWaitlist *&queue) {
+        if (!queue)
+          return;
+        queue->queue.forEach([&](int, const WaitlistRequest &req) {
+          file << bookId << "," << req.start << "," << req.end << ","
+               << req.username << "," << req.requestTime << ","
+               << (req.repeatBorrower ? 1 : 0) << "," << req.seq << "\n";
+        });
+      });
 }
 
 void BooksManager::showUserBookings(const std::string &username) const {
   cout << COLOR_MENU << "\nYour book bookings:\n\n" << COLOR_RESET;
 
   bool any = false;
-  const_cast<HashMap<string, RedBlackIntervalTree *> &>(BookTable).forEach(
-      [&](const string &bookId, RedBlackIntervalTree *&tree) {
-        if (!tree)
+  const_cast<HashMap<StringRef, CopyPool *> &>(BookTable).forEach(
+      [&](const StringRef &bookId, CopyPool *&pool) {
+        if (!pool)
           return;
 
-        tree->forEachInterval(
-            [&](const int low, const int high, const std::string &user) {
+        pool->forEachLoan(
+            [&](int, const int low, const int high, const std::string &user) {
               if (user == username) {
-                // BookTable is keyed by ID. So bookId is ID.
-                // ID_To_BookTable is keyed by Title.
-                // We need to find Book by ID.
-                Book *b = nullptr;
-                const_cast<HashMap<string, Book> &>(ID_To_BookTable)
-                    .forEach([&](const string &key, Book &book) {
-                      if (book.getID() == bookId)
-                        b = &book;
-                    });
-
-                const string title = b ? b->getTitle() : "(unknown)";
-                const string author = b ? b->getAuthor() : "(unknown)";
+                Book *b = ID_To_BookTable.get(bookId);
+
+                const StringRef title = b ? b->titleRef() : "(unknown)";
+                const StringRef author = b ? b->authorRef() : "(unknown)";
 
                 cout << "  - Book ID: " << bookId << " | Title: " << title
                      << " | Author: " << author << " | Period: ["
@@ -578,14 +1187,23 @@ void BooksManager::showUserBookings(const std::string &username) const {
 }
 
 void BooksManager::syncUserBookings(UsersManager &usersManager) {
-  BookTable.forEach([&](const string &bookId, RedBlackIntervalTree *&tree) {
-    if (!tree)
+  BookTable.forEach([&](const StringRef &bookId, CopyPool *&pool) {
+    if (!pool)
       return;
-    tree->forEachInterval(
-        [&](const int low, const int high, const string &username) {
+    pool->forEachLoan(
+        [&](int, const int low, const int high, const string &username) {
           User *u = usersManager.getUser(username);
           if (u)
             u->addBookBooking(low, high);
         });
   });
+
+  // Reattach waitlisted requests loaded from file to their users
+  waitlistTable.forEach([&](const string &bookId, BookWaitlist *&queue) {
+    if (!queue)
+      return;
+    queue->queue.forEach([&](int, WaitlistRequest &req) {
+      req.user = usersManager.getUser(req.username);
+    });
+  });
 }
@@ -61,6 +61,7 @@ bool LaptopsManager::BorrowLaptop(User *user) {
       return;
     if (!tree->searchOverlap(startSec, endSec, false)) {
       tree->insert(startSec, endSec, user->getUsername());
+      demand.record(id, startSec);
       user->addLaptopBooking(startSec, endSec);
 
       cout << COLOR_PROMPT << "Laptop " << id
@@ -115,6 +116,7 @@ bool LaptopsManager::borrowLaptopDirect(User *user, const string &laptopId,
 
   // Book the laptop
   tree->insert(startTime, endTime, user->getUsername());
+  demand.record(laptopId, startTime);
   user->addLaptopBooking(startTime, endTime);
 
   return true;
@@ -173,6 +175,7 @@ void LaptopsManager::removeLaptopInteractive() {
   delete *treePtr;
   *treePtr = nullptr;
   laptopTable.erase(id);
+  demand.removeResource(id);
 
   printSuccess("Laptop " + id + " removed.");
 }
@@ -187,6 +190,7 @@ bool LaptopsManager::removeLaptopDirect(const string &laptopId) {
   delete *treePtr;
   *treePtr = nullptr;
   laptopTable.erase(laptopId);
+  demand.removeResource(laptopId);
 
   return true;
 }
@@ -195,10 +199,11 @@ void LaptopsManager::saveLaptopsToFile() const {
   saveResourceIDsToFile("data/laptops.txt", laptopTable);
 }
 
-void LaptopsManager::loadLaptopBookingsFromFile() const {
-  loadBookingsFromFile(
-      "data/laptop_bookings.txt",
-      const_cast<HashMap<string, RedBlackIntervalTree *> &>(laptopTable));
+void LaptopsManager::loadLaptopBookingsFromFile() {
+  loadBookingsFromFile("data/laptop_bookings.txt", laptopTable,
+                       [&](const string &id, int start, int, const string &) {
+                         demand.record(id, start);
+                       });
 }
 
 void LaptopsManager::saveLaptopBookingsToFile() const {
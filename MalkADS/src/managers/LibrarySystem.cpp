@@ -18,6 +18,7 @@ void LibrarySystem::loadData() {
     rooms.syncUserBookings(users);
     laptops.syncUserBookings(users);
     books.syncUserBookings(users);
+    books.advanceClock(getCurrentSeconds());
 }
 
 void LibrarySystem::showUserMenu() {
@@ -114,6 +115,9 @@ void LibrarySystem::userSession() {
     while (inSession) {
         int choice;
 
+        // Expire whatever came due while the terminal sat idle
+        books.advanceClock(getCurrentSeconds());
+
         if (isCurrentUserAdmin()) {
             showAdminMenu();
         } else {
@@ -4,6 +4,11 @@
 #include <iostream>
 #include <sstream>
 
+// Floors are the attribute index's categories, so "no floor" has to mean
+// the same to both
+static_assert(RoomAttributes::UNKNOWN_FLOOR == AttributeIndex::NO_CATEGORY,
+              "an unknown floor must be the index's missing category");
+
 RoomsManager::RoomsManager() {
   loadRoomsFromFile();
   loadRoomBookingsFromFile();
@@ -18,10 +23,35 @@ RoomsManager::~RoomsManager() {
     tree = nullptr;
   });
   roomTable.clear();
+  delete[] numberedRooms;
 }
 
 void RoomsManager::loadRoomsFromFile() {
-  loadResourceIDsFromFile("data/rooms.txt", roomTable);
+  ifstream file("data/rooms.txt");
+  if (!file) {
+    cout << "Error opeing data/rooms.txt\n";
+    return;
+  }
+
+  // id[,capacity[,floor[,equipment|...]]]; rooms are numbered in file order
+  string line;
+  while (getline(file, line)) {
+    if (!line.empty() && line.back() == '\r')
+      line.pop_back();
+    if (line.empty())
+      continue;
+    size_t comma = line.find(',');
+    string id = line.substr(0, comma);
+    RoomAttributes attributes;
+    if (comma != string::npos &&
+        !RoomAttributes::parse(line.substr(comma + 1), attributes))
+      cout << "Ignoring bad attributes of room " << id << "\n";
+    auto *tree = new RedBlackIntervalTree();
+    if (roomTable.putNew(id, tree))
+      numberRoom(id, tree, attributes);
+    else
+      delete tree;
+  }
 }
 
 bool RoomsManager::bookRoom(User *user) {
@@ -193,6 +223,8 @@ bool RoomsManager::bookRoom(User *user) {
   }
 
   tree->insert(startperiod, endperiod, user->getUsername());
+  indexBooking(roomchoice, startperiod, endperiod);
+  demand.record(roomchoice, startperiod);
   user->addRoomBooking(startperiod, endperiod);
 
   stringstream ss;
@@ -224,6 +256,29 @@ bool RoomsManager::bookRoomDirect(User *user, const string &roomId,
   RedBlackIntervalTree *tree = *treePtr;
 
   // Validation Checks matching interactive mode
+  if (!isBookableWindow(startTime, endTime))
+    return false;
+
+  // Check if user already has a conflicting booking
+  if (!user->canBookRoom(startTime, endTime)) {
+    return false; // User conflict
+  }
+
+  // Check if room is available
+  if (tree->searchOverlap(startTime, endTime, false)) {
+    return false; // Room conflict
+  }
+
+  // Book the room
+  tree->insert(startTime, endTime, user->getUsername());
+  indexBooking(roomId, startTime, endTime);
+  demand.record(roomId, startTime);
+  user->addRoomBooking(startTime, endTime);
+
+  return true;
+}
+
+bool RoomsManager::isBookableWindow(int startTime, int endTime) {
   time_t refStamp = getStartOfYearTimestamp();
   time_t actualNow = time(nullptr);
   double diffNow = difftime(actualNow, refStamp);
@@ -247,28 +302,179 @@ bool RoomsManager::bookRoomDirect(User *user, const string &roomId,
   if (startTime >= endTime)
     return false;
 
-  if ((endTime - startTime) > 3 * 3600)
+  return (endTime - startTime) <= 3 * 3600;
+}
+
+bool RoomsManager::bookAnyRoom(User *user, int startTime, int endTime,
+                               string *bookedRoom,
+                               const RoomAttributes &need) {
+  if (!user || !isBookableWindow(startTime, endTime) ||
+      !user->canBookRoom(startTime, endTime))
+    return false;
+
+  // One free room is enough; bookRoomDirect checks it again
+  PostingList found(1);
+  if (freeRoomNumbersFor(startTime, endTime, need, 1, found) == 0)
     return false;
+  const string roomId = numberedRooms[found.at(0)].id;
+  if (!bookRoomDirect(user, roomId, startTime, endTime))
+    return false;
+  if (bookedRoom)
+    *bookedRoom = roomId;
+  return true;
+}
 
-  // Check if user already has a conflicting booking
-  if (!user->canBookRoom(startTime, endTime)) {
-    return false; // User conflict
+bool RoomsManager::cancelRoomBookingDirect(User *user, const string &roomId,
+                                           int startTime, int endTime) {
+  if (!user)
+    return false;
+
+  RedBlackIntervalTree **treePtr = roomTable.get(roomId);
+  if (!treePtr || !(*treePtr) ||
+      !(*treePtr)->hasInterval(startTime, endTime, user->getUsername()))
+    return false;
+
+  (*treePtr)->remove(startTime, endTime);
+  unindexBooking(roomId, startTime, endTime);
+  demand.record(roomId, startTime, -1);
+  user->removeRoomBooking(startTime, endTime);
+  return true;
+}
+
+void RoomsManager::numberRoom(const string &roomId,
+                              RedBlackIntervalTree *tree,
+                              const RoomAttributes &attributes) {
+  int number;
+  if (!freeRoomNumbers.empty()) {
+    int last = freeRoomNumbers.size() - 1;
+    number = freeRoomNumbers.at(last);
+    freeRoomNumbers.removeAt(last);
+  } else {
+    if (numberedEnd == numberedCapacity) {
+      int newCapacity = numberedCapacity ? numberedCapacity * 2 : 16;
+      NumberedRoom *grown = new NumberedRoom[newCapacity];
+      for (int i = 0; i < numberedEnd; i++)
+        grown[i] = numberedRooms[i];
+      delete[] numberedRooms;
+      numberedRooms = grown;
+      numberedCapacity = newCapacity;
+    }
+    number = numberedEnd++;
   }
+  // Indexed first: if that throws, the room is not half registered
+  roomAttributes.set(number, attributes.equipment, attributes.floor,
+                     attributes.capacity);
+  numberedRooms[number].id = roomId;
+  numberedRooms[number].tree = tree;
+  numberedRooms[number].attributes = attributes;
+  roomNumbers.putNew(roomId, number);
+  // A new room has no bookings yet
+  freeRooms.addMember(number);
+}
 
-  // Check if room is available
-  if (tree->searchOverlap(startTime, endTime, false)) {
-    return false; // Room conflict
+void RoomsManager::unnumberRoom(const string &roomId) {
+  int *numberPtr = roomNumbers.get(roomId);
+  if (!numberPtr)
+    return;
+  int number = *numberPtr;
+  freeRooms.removeMember(number);
+  roomAttributes.remove(number);
+  numberedRooms[number].id.clear();
+  numberedRooms[number].tree = nullptr;
+  numberedRooms[number].attributes = RoomAttributes();
+  freeRoomNumbers.append(number);
+  roomNumbers.erase(roomId);
+}
+
+void RoomsManager::refreshFreeRooms() {
+  long long today = getStartOfTodaySeconds();
+  if (freeRooms.start() == today)
+    return;
+  freeRooms.reset(today);
+  for (int r = 0; r < numberedEnd; r++) {
+    RedBlackIntervalTree *tree = numberedRooms[r].tree;
+    if (!tree)
+      continue;
+    tree->forEachOverlap(static_cast<int>(today),
+                         static_cast<int>(freeRooms.end()),
+                         [&](int low, int high, const string &) {
+                           freeRooms.markBusy(r, low, high);
+                         });
   }
+}
 
-  // Book the room
-  tree->insert(startTime, endTime, user->getUsername());
-  user->addRoomBooking(startTime, endTime);
+void RoomsManager::indexBooking(const string &roomId, int startTime,
+                                int endTime) {
+  int *numberPtr = roomNumbers.get(roomId);
+  if (numberPtr)
+    freeRooms.markBusy(*numberPtr, startTime, endTime);
+}
 
-  return true;
+void RoomsManager::unindexBooking(const string &roomId, int startTime,
+                                  int endTime) {
+  int *numberPtr = roomNumbers.get(roomId);
+  if (!numberPtr)
+    return;
+  RedBlackIntervalTree *tree = numberedRooms[*numberPtr].tree;
+  // A quarter hour stays busy while another booking overlaps it
+  freeRooms.markFree(*numberPtr, startTime, endTime,
+                     [&](long long slotStart, long long slotEnd) {
+                       return tree->searchOverlap(
+                           static_cast<int>(slotStart),
+                           static_cast<int>(slotEnd), false);
+                     });
+}
+
+int RoomsManager::freeRoomNumbersFor(int startTime, int endTime,
+                                     const RoomAttributes &need, int limit,
+                                     PostingList &found) {
+  if (startTime >= endTime)
+    return 0;
+
+  // Candidates: every room that may be free, narrowed to those offering
+  // need before any tree is asked
+  refreshFreeRooms();
+  const bool indexed = freeRooms.covers(startTime, endTime);
+  BitSet sure, maybe, candidates;
+  if (indexed) {
+    freeRooms.query(startTime, endTime, sure, maybe);
+    candidates.assign(sure);
+    candidates.orWith(maybe);
+  } else {
+    // Outside today and tomorrow: every room's tree has to be asked
+    candidates.resize(numberedEnd);
+    for (int r = 0; r < numberedEnd; r++)
+      if (numberedRooms[r].tree)
+        candidates.set(r);
+  }
+  roomAttributes.filter(candidates, need.equipment, need.floor,
+                        need.capacity);
+
+  for (int r = candidates.next(0);
+       r >= 0 && (limit <= 0 || found.size() < limit);
+       r = candidates.next(r + 1))
+    if ((indexed && sure.test(r)) ||
+        !numberedRooms[r].tree->searchOverlap(startTime, endTime, false))
+      found.append(r);
+  return found.size();
 }
 
 void RoomsManager::saveRoomsToFile() const {
-  saveResourceIDsToFile("data/rooms.txt", roomTable);
+  ofstream file("data/rooms.txt", ios::out | ios::trunc);
+  if (!file) {
+    cout << "Error opening data/rooms.txt for writing\n";
+    return;
+  }
+
+  for (int r = 0; r < numberedEnd; r++) {
+    const NumberedRoom &room = numberedRooms[r];
+    if (!room.tree)
+      continue;
+    file << room.id;
+    if (room.attributes.isKnown())
+      file << "," << room.attributes.format();
+    file << "\n";
+  }
 }
 
 void RoomsManager::addRoomInteractive() {
@@ -283,18 +489,32 @@ void RoomsManager::addRoomInteractive() {
     return;
   }
 
+  string fields;
+  cout << COLOR_PROMPT
+       << "Enter capacity,floor,equipment (e.g. 8,2,projector|whiteboard) "
+          "or '-' to skip: "
+       << COLOR_RESET;
+  cin >> fields;
+  RoomAttributes attributes;
+  if (fields != "-" && !RoomAttributes::parse(fields, attributes)) {
+    printError("Invalid room attributes.");
+    return;
+  }
+
   auto *tree = new RedBlackIntervalTree();
   if (!roomTable.putNew(id, tree)) {
     delete tree;
     printError("Failed to add room.");
     return;
   }
+  numberRoom(id, tree, attributes);
 
   printSuccess("Room " + id + " added successfully.");
 }
 
 // Non-interactive version for Python API
-bool RoomsManager::addRoomDirect(const string &roomId) {
+bool RoomsManager::addRoomDirect(const string &roomId,
+                                 const RoomAttributes &attributes) {
   if (roomTable.contains(roomId)) {
     return false; // Room already exists
   }
@@ -304,7 +524,29 @@ bool RoomsManager::addRoomDirect(const string &roomId) {
     delete tree;
     return false;
   }
+  numberRoom(roomId, tree, attributes);
+
+  return true;
+}
 
+bool RoomsManager::setRoomAttributes(const string &roomId,
+                                     const RoomAttributes &attributes) {
+  int *numberPtr = roomNumbers.get(roomId);
+  if (!numberPtr)
+    return false;
+  // Indexed first, so a throw leaves the old attributes in both places
+  roomAttributes.set(*numberPtr, attributes.equipment, attributes.floor,
+                     attributes.capacity);
+  numberedRooms[*numberPtr].attributes = attributes;
+  return true;
+}
+
+bool RoomsManager::getRoomAttributes(const string &roomId,
+                                     RoomAttributes &attributes) const {
+  int *numberPtr = roomNumbers.get(roomId);
+  if (!numberPtr)
+    return false;
+  attributes = numberedRooms[*numberPtr].attributes;
   return true;
 }
 
@@ -321,9 +563,11 @@ void RoomsManager::removeRoomInteractive() {
     return;
   }
 
+  unnumberRoom(id);
   delete *treePtr;
   *treePtr = nullptr;
   roomTable.erase(id);
+  demand.removeResource(id);
 
   printSuccess("Room " + id + " removed.");
 }
@@ -335,17 +579,20 @@ bool RoomsManager::removeRoomDirect(const string &roomId) {
     return false; // Room doesn't exist
   }
 
+  unnumberRoom(roomId);
   delete *treePtr;
   *treePtr = nullptr;
   roomTable.erase(roomId);
+  demand.removeResource(roomId);
 
   return true;
 }
 
-void RoomsManager::loadRoomBookingsFromFile() const {
-  loadBookingsFromFile(
-      "data/room_bookings.txt",
-      const_cast<HashMap<string, RedBlackIntervalTree *> &>(roomTable));
+void RoomsManager::loadRoomBookingsFromFile() {
+  loadBookingsFromFile("data/room_bookings.txt", roomTable,
+                       [&](const string &id, int start, int, const string &) {
+                         demand.record(id, start);
+                       });
 }
 
 void RoomsManager::saveRoomBookingsToFile() const {
@@ -375,82 +622,18 @@ void RoomsManager::showUserBookings(const std::string &username) const {
     printHint("You have no room bookings.");
 }
 
-int RoomsManager::collectBookedIntervals(RedBlackIntervalTree *tree,
-                                         SimpleInterval *arr, int maxCount) {
-  int count = 0;
-  tree->forEachInterval([&](int low, int high, const string &) {
-    if (count < maxCount) {
-      arr[count].start = low;
-      arr[count].end = high;
-      count++;
-    }
-  });
-  return count;
-}
-
-void RoomsManager::sortIntervals(SimpleInterval *arr, int n) {
-  for (int i = 1; i < n; i++) {
-    const SimpleInterval key = arr[i];
-    int j = i - 1;
-    while (j >= 0 && arr[j].start > key.start) {
-      arr[j + 1] = arr[j];
-      j--;
-    }
-    arr[j + 1] = key;
-  }
-}
-
-int RoomsManager::mergeIntervals(SimpleInterval *arr, int n) {
-  if (n == 0)
-    return 0;
-  int idx = 0;
-  for (int i = 1; i < n; i++) {
-    if (arr[idx].end >= arr[i].start) {
-      if (arr[idx].end < arr[i].end)
-        arr[idx].end = arr[i].end;
-    } else {
-      idx++;
-      arr[idx] = arr[i];
-    }
-  }
-
-  return (idx + 1);
-}
-
 void RoomsManager::showRoomsWithAvailableTimes(int openStart, int openEnd) {
   roomTable.forEach([&](const string &roomId, RedBlackIntervalTree *&tree) {
-    SimpleInterval intervals[MAX_INTERVALS];
-
-    int count = collectBookedIntervals(tree, intervals, MAX_INTERVALS);
-    if (count > 1)
-      sortIntervals(intervals, count);
-    count = mergeIntervals(intervals, count);
-
-    int last = openStart;
+    if (!tree)
+      return;
     cout << COLOR_PROMPT << "Room " << roomId << COLOR_RESET << ": ";
     bool any = false;
-    for (int i = 0; i < count; ++i) {
-      if (last < intervals[i].start) {
-        const int intervalStart = last;
-        const int intervalEnd = intervals[i].start - 1;
-        if (intervalStart == intervalEnd) {
-          cout << "[" << intervalStart << ", " << (intervalEnd + 1) << "]";
-        } else {
-          cout << "[" << intervalStart << ", " << intervalEnd << "] ";
-        }
+    if (openStart < openEnd)
+      sweepFreeGaps(tree, openStart, openEnd, [&](int gapStart, int gapEnd) {
+        cout << "[" << formatTimestamp(gapStart) << ", "
+             << formatTimestamp(gapEnd) << "] ";
         any = true;
-      }
-      if (last <= intervals[i].end)
-        last = intervals[i].end + 1;
-    }
-    if (last <= openEnd) {
-      if (last == openEnd) {
-        cout << "[" << last << "] ";
-      } else {
-        cout << "[" << last << ", " << openEnd << "] ";
-      }
-      any = true;
-    }
+      });
     if (!any)
       cout << COLOR_ERROR << "(No availability)" << COLOR_RESET;
     cout << "\n";
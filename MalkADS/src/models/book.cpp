@@ -3,35 +3,32 @@
 using namespace std;
 
 Book::Book() {
-  bookid = "";
-  author = "";
-  title = "";
+  catalogId = -1;
+  authorPos = -1;
+  copies = 1;
 }
 
-Book::Book(const string &ID, const string &Title, const string &Author) {
+Book::Book(StringRef ID, StringRef Title, StringRef Author, int Copies) {
   bookid = ID;
   title = Title;
   author = Author;
+  catalogId = -1;
+  authorPos = -1;
+  copies = Copies;
 }
 
-string Book::getID() { return bookid; }
-
-string Book::getAuthor() { return author; }
-
-string Book::getTitle() {
-  string result = title;
+void Book::formatTitle(char *title, int length) {
   bool newWord = true;
-  for (size_t i = 0; i < result.length(); ++i) {
-    if (isspace(result[i])) {
+  for (int i = 0; i < length; ++i) {
+    if (isspace(static_cast<unsigned char>(title[i]))) {
       newWord = true;
     } else {
       if (newWord) {
-        result[i] = toupper(result[i]);
+        title[i] = toupper(static_cast<unsigned char>(title[i]));
         newWord = false;
       } else {
-        result[i] = tolower(result[i]);
+        title[i] = tolower(static_cast<unsigned char>(title[i]));
       }
     }
   }
-  return result;
 }
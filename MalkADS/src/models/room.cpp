@@ -0,0 +1,102 @@
+#include "../../include/models/room.h"
+#include <cctype>
+#include <cerrno>
+#include <climits>
+#include <cstdlib>
+#include <sstream>
+using namespace std;
+
+const int RoomAttributes::UNKNOWN_FLOOR;
+
+static const char *EQUIPMENT_NAMES[RoomAttributes::EQUIPMENT_KINDS] = {
+    "projector", "whiteboard", "screen", "video_call", "computer"};
+
+const char *RoomAttributes::equipmentName(int kind) {
+  return kind >= 0 && kind < EQUIPMENT_KINDS ? EQUIPMENT_NAMES[kind] : "";
+}
+
+unsigned RoomAttributes::equipmentFlag(const string &name) {
+  string lower = name;
+  for (char &c : lower)
+    c = static_cast<char>(tolower(static_cast<unsigned char>(c)));
+  for (int i = 0; i < EQUIPMENT_KINDS; i++)
+    if (lower == EQUIPMENT_NAMES[i])
+      return 1u << i;
+  return 0;
+}
+
+bool RoomAttributes::parseEquipment(const string &names, unsigned &flags) {
+  unsigned parsed = 0;
+  stringstream ss(names);
+  string name;
+  while (getline(ss, name, '|')) {
+    if (name.empty())
+      continue;
+    unsigned flag = equipmentFlag(name);
+    if (!flag)
+      return false;
+    parsed |= flag;
+  }
+  flags = parsed;
+  return true;
+}
+
+string RoomAttributes::formatEquipment(unsigned flags) {
+  string names;
+  for (int i = 0; i < EQUIPMENT_KINDS; i++) {
+    if (!(flags & (1u << i)))
+      continue;
+    if (!names.empty())
+      names += '|';
+    names += EQUIPMENT_NAMES[i];
+  }
+  return names;
+}
+
+// A whole-string integer, or false; so is one that does not fit an int
+static bool parseInt(const string &text, int &value) {
+  if (text.empty())
+    return false;
+  char *end = nullptr;
+  errno = 0;
+  long parsed = strtol(text.c_str(), &end, 10);
+  if (*end != '\0' || errno == ERANGE || parsed < INT_MIN ||
+      parsed > INT_MAX)
+    return false;
+  value = static_cast<int>(parsed);
+  return true;
+}
+
+bool RoomAttributes::parse(const string &fields, RoomAttributes &out) {
+  RoomAttributes parsed;
+  stringstream ss(fields);
+  string field;
+
+  if (getline(ss, field, ',') && !field.empty() &&
+      (!parseInt(field, parsed.capacity) || parsed.capacity < 0))
+    return false;
+  if (getline(ss, field, ',') && !field.empty() &&
+      (!parseInt(field, parsed.floor) || parsed.floor == UNKNOWN_FLOOR))
+    return false;
+  if (getline(ss, field, ',') && !parseEquipment(field, parsed.equipment))
+    return false;
+  if (getline(ss, field, ','))
+    return false; // too many fields
+
+  out = parsed;
+  return true;
+}
+
+string RoomAttributes::format() const {
+  if (!isKnown())
+    return "";
+  stringstream ss;
+  if (capacity > 0)
+    ss << capacity;
+  ss << ",";
+  if (floor != UNKNOWN_FLOOR)
+    ss << floor;
+  if (equipment)
+    ss << "," << formatEquipment(equipment);
+  return ss.str();
+}
@@ -118,68 +118,71 @@ void RedBlackIntervalTree::fixInsert(Node *&node) {
   root->color = BLACK;
 }
 
-void RedBlackIntervalTree::fixDelete(Node *&node) {
-  if (node == nullptr)
-    return;
-
-  while (node != root && node->color == BLACK) {
-    if (node == node->parent->left) {
-      Node *sibling = node->parent->right;
+// x may be null (a removed black leaf), so its parent is passed explicitly
+void RedBlackIntervalTree::fixDelete(Node *x, Node *xParent) {
+  while (x != root && (x == nullptr || x->color == BLACK)) {
+    if (x == xParent->left) {
+      Node *sibling = xParent->right;
       if (sibling->color == RED) {
         sibling->color = BLACK;
-        node->parent->color = RED;
-        rotateLeft(node->parent);
-        sibling = node->parent->right;
+        xParent->color = RED;
+        rotateLeft(xParent);
+        sibling = xParent->right;
       }
       if ((sibling->left == nullptr || sibling->left->color == BLACK) &&
           (sibling->right == nullptr || sibling->right->color == BLACK)) {
         sibling->color = RED;
-        node = node->parent;
+        x = xParent;
+        xParent = x->parent;
       } else {
         if (sibling->right == nullptr || sibling->right->color == BLACK) {
           if (sibling->left != nullptr)
             sibling->left->color = BLACK;
           sibling->color = RED;
           rotateRight(sibling);
-          sibling = node->parent->right;
+          sibling = xParent->right;
         }
-        sibling->color = node->parent->color;
-        node->parent->color = BLACK;
+        sibling->color = xParent->color;
+        xParent->color = BLACK;
         if (sibling->right != nullptr)
           sibling->right->color = BLACK;
-        rotateLeft(node->parent);
-        node = root;
+        rotateLeft(xParent);
+        x = root;
+        xParent = nullptr;
       }
     } else {
-      Node *sibling = node->parent->left;
+      Node *sibling = xParent->left;
       if (sibling->color == RED) {
         sibling->color = BLACK;
-        node->parent->color = RED;
-        rotateRight(node->parent);
-        sibling = node->parent->left;
+        xParent->color = RED;
+        rotateRight(xParent);
+        sibling = xParent->left;
       }
       if ((sibling->left == nullptr || sibling->left->color == BLACK) &&
           (sibling->right == nullptr || sibling->right->color == BLACK)) {
         sibling->color = RED;
-        node = node->parent;
+        x = xParent;
+        xParent = x->parent;
       } else {
         if (sibling->left == nullptr || sibling->left->color == BLACK) {
           if (sibling->right != nullptr)
             sibling->right->color = BLACK;
           sibling->color = RED;
           rotateLeft(sibling);
-          sibling = node->parent->left;
+          sibling = xParent->left;
         }
-        sibling->color = node->parent->color;
-        node->parent->color = BLACK;
+        sibling->color = xParent->color;
+        xParent->color = BLACK;
         if (sibling->left != nullptr)
           sibling->left->color = BLACK;
-        rotateRight(node->parent);
-        node = root;
+        rotateRight(xParent);
+        x = root;
+        xParent = nullptr;
       }
     }
   }
-  node->color = BLACK;
+  if (x != nullptr)
+    x->color = BLACK;
 }
 
 RedBlackIntervalTree::Node *RedBlackIntervalTree::minValueNode(Node *&node) {
@@ -236,6 +239,27 @@ bool RedBlackIntervalTree::doOverlap(int low1, int high1, int low2, int high2) {
   return (low1 < high2 && low2 < high1);
 }
 
+// Equal lows can end up on either side after rotations, so both subtrees
+// are searched when the low endpoints tie.
+RedBlackIntervalTree::Node *RedBlackIntervalTree::findNode(Node *node, int low,
+                                                           int high) {
+  while (node != nullptr) {
+    if (low < node->low) {
+      node = node->left;
+    } else if (low > node->low) {
+      node = node->right;
+    } else {
+      if (node->high == high)
+        return node;
+      Node *found = findNode(node->left, low, high);
+      if (found != nullptr)
+        return found;
+      node = node->right;
+    }
+  }
+  return nullptr;
+}
+
 RedBlackIntervalTree::Node *
 RedBlackIntervalTree::overlapSearch(Node *root, int low, int high) {
   if (root == nullptr)
@@ -244,7 +268,8 @@ RedBlackIntervalTree::overlapSearch(Node *root, int low, int high) {
   if (doOverlap(root->low, root->high, low, high))
     return root;
 
-  if (root->left != nullptr && root->left->max >= low)
+  // Intervals are half-open, so a left max equal to low cannot overlap
+  if (root->left != nullptr && root->left->max > low)
     return overlapSearch(root->left, low, high);
 
   return overlapSearch(root->right, low, high);
@@ -336,44 +361,33 @@ void RedBlackIntervalTree::insert(int low, int high, const std::string &user) {
   fixInsert(node);
 }
 
-void RedBlackIntervalTree::remove(int low, int high) {
-  Node *node = root;
-  Node *z = nullptr;
-  Node *x = nullptr;
-  Node *y = nullptr;
-
-  while (node != nullptr) {
-    if (node->low == low && node->high == high) {
-      z = node;
-      break;
-    }
-    if (node->low <= low)
-      node = node->right;
-    else
-      node = node->left;
-  }
-
-  if (z == nullptr) {
-    std::cout << "Interval not found\n";
-    return;
-  }
+bool RedBlackIntervalTree::remove(int low, int high) {
+  Node *z = findNode(root, low, high);
+  if (z == nullptr)
+    return false;
 
-  y = z;
+  Node *y = z;
+  Node *x = nullptr;
+  Node *xParent = nullptr;
   Color yOriginalColor = y->color;
   if (z->left == nullptr) {
     x = z->right;
+    xParent = z->parent;
     transplant(root, z, z->right);
   } else if (z->right == nullptr) {
     x = z->left;
+    xParent = z->parent;
     transplant(root, z, z->left);
   } else {
     y = minValueNode(z->right);
     yOriginalColor = y->color;
     x = y->right;
     if (y->parent == z) {
+      xParent = y;
       if (x != nullptr)
         x->parent = y;
     } else {
+      xParent = y->parent;
       transplant(root, y, y->right);
       y->right = z->right;
       y->right->parent = y;
@@ -385,20 +399,19 @@ void RedBlackIntervalTree::remove(int low, int high) {
   }
   delete z;
 
-  if (yOriginalColor == BLACK) {
-    if (x != nullptr)
-      fixDelete(x);
-    else if (y->parent != nullptr)
-      fixDelete(y->parent);
-  }
-
-  if (y == nullptr)
-    return;
-  Node *temp = y->parent;
-  while (temp != nullptr) {
+  // Every node whose subtree lost z lies on the path from xParent up
+  for (Node *temp = xParent; temp != nullptr; temp = temp->parent)
     updateMax(temp);
-    temp = temp->parent;
-  }
+
+  if (yOriginalColor == BLACK)
+    fixDelete(x, xParent);
+  return true;
+}
+
+bool RedBlackIntervalTree::hasInterval(int low, int high,
+                                       const std::string &user) {
+  Node *node = findNode(root, low, high);
+  return node != nullptr && node->bookedBy == user;
 }
 
 // bool RedBlackIntervalTree::searchOverlap(int low, int high) {
@@ -0,0 +1,98 @@
+#include "structures/attribute_index.h"
+#include <catch2/catch_all.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <climits>
+#include <vector>
+
+namespace {
+
+const int NONE = AttributeIndex::NO_CATEGORY;
+
+struct Member {
+  unsigned flags;
+  int category;
+  int size;
+};
+
+std::vector<int> matching(const AttributeIndex &index, int memberCount,
+                          unsigned flags, int category, int minSize) {
+  BitSet candidates(memberCount);
+  for (int m = 0; m < memberCount; m++)
+    candidates.set(m);
+  index.filter(candidates, flags, category, minSize);
+  std::vector<int> found;
+  for (int m = candidates.next(0); m >= 0; m = candidates.next(m + 1))
+    found.push_back(m);
+  return found;
+}
+
+} // namespace
+
+TEST_CASE("AttributeIndex filters by flags, category and size") {
+  AttributeIndex index;
+  index.set(0, 1 | 2, 1, 4);
+  index.set(1, 1, 2, 8);
+  index.set(2, 2, 1, 9);
+  index.set(3, 0, NONE, 0); // nothing known
+
+  REQUIRE(matching(index, 4, 0, NONE, 0) == std::vector<int>{0, 1, 2, 3});
+  REQUIRE(matching(index, 4, 1, NONE, 0) == std::vector<int>{0, 1});
+  REQUIRE(matching(index, 4, 1 | 2, NONE, 0) == std::vector<int>{0});
+  REQUIRE(matching(index, 4, 0, 1, 0) == std::vector<int>{0, 2});
+  REQUIRE(matching(index, 4, 0, 7, 0).empty()); // category never seen
+
+  // 8 is a bucket bound; 9 is not, so sizes in its bucket are compared
+  REQUIRE(matching(index, 4, 0, NONE, 8) == std::vector<int>{1, 2});
+  REQUIRE(matching(index, 4, 0, NONE, 9) == std::vector<int>{2});
+  REQUIRE(matching(index, 4, 2, 1, 5) == std::vector<int>{2});
+
+  // Replacing and removing members
+  index.set(2, 0, 3, 2);
+  REQUIRE(matching(index, 4, 2, NONE, 0) == std::vector<int>{0});
+  REQUIRE(matching(index, 4, 0, 3, 0) == std::vector<int>{2});
+  index.remove(0);
+  REQUIRE(matching(index, 4, 0, NONE, 0) == std::vector<int>{1, 2, 3});
+}
+
+TEST_CASE("AttributeIndex takes any int as a category") {
+  AttributeIndex index;
+  index.set(0, 0, 1000000000, 0); // no dense array sized by the category
+  index.set(1, 0, -2, 0);
+  index.set(2, 0, INT_MAX, 0);
+  REQUIRE(matching(index, 3, 0, 1000000000, 0) == std::vector<int>{0});
+  REQUIRE(matching(index, 3, 0, -2, 0) == std::vector<int>{1});
+  REQUIRE(matching(index, 3, 0, INT_MAX, 0) == std::vector<int>{2});
+  REQUIRE(matching(index, 3, 0, -1, 0).empty());
+
+  index.set(0, 0, -2, 0);
+  REQUIRE(matching(index, 3, 0, -2, 0) == std::vector<int>{0, 1});
+  REQUIRE(matching(index, 3, 0, 1000000000, 0).empty());
+}
+
+TEST_CASE("AttributeIndex agrees with a linear scan") {
+  srand(50);
+  const int MEMBERS = 300; // several words, added out of order
+  AttributeIndex index;
+  std::vector<Member> members(MEMBERS);
+  for (int i = MEMBERS - 1; i >= 0; i--) {
+    int category = rand() % 6 - 2; // -1 and -2 are categories too
+    members[i] = Member{static_cast<unsigned>(rand() % 32),
+                        category == -2 ? NONE : category, rand() % 60};
+    index.set(i, members[i].flags, members[i].category, members[i].size);
+  }
+
+  for (int q = 0; q < 200; q++) {
+    unsigned flags = rand() % 2 ? static_cast<unsigned>(rand() % 32) : 0;
+    int category = rand() % 7 - 2;
+    if (category == -2)
+      category = NONE;
+    int minSize = rand() % 3 ? rand() % 70 : 0;
+    std::vector<int> expected;
+    for (int m = 0; m < MEMBERS; m++)
+      if ((members[m].flags & flags) == flags &&
+          (category == NONE || members[m].category == category) &&
+          (minSize <= 0 || members[m].size >= minSize))
+        expected.push_back(m);
+    REQUIRE(matching(index, MEMBERS, flags, category, minSize) == expected);
+  }
+}
@@ -0,0 +1,72 @@
+#include "structures/bit_set.h"
+#include <catch2/catch_all.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <set>
+#include <vector>
+
+TEST_CASE("BitSet sets, tests and walks its members") {
+  BitSet bits(130);
+  REQUIRE(bits.size() == 130);
+  REQUIRE_FALSE(bits.any());
+  REQUIRE(bits.next(0) == -1);
+
+  for (int i : {0, 5, 63, 64, 127, 129})
+    bits.set(i);
+  REQUIRE(bits.count() == 6);
+  REQUIRE(bits.test(63));
+  REQUIRE_FALSE(bits.test(62));
+  REQUIRE_FALSE(bits.test(130)); // out of range
+
+  std::vector<int> members;
+  for (int i = bits.next(0); i >= 0; i = bits.next(i + 1))
+    members.push_back(i);
+  REQUIRE(members == std::vector<int>{0, 5, 63, 64, 127, 129});
+  REQUIRE(bits.next(65) == 127);
+
+  bits.reset(64);
+  REQUIRE(bits.next(64) == 127);
+
+  // Shrinking drops members past the end; growing adds clear bits
+  bits.resize(100);
+  REQUIRE(bits.count() == 3);
+  bits.resize(200);
+  REQUIRE(bits.count() == 3);
+  REQUIRE(bits.next(64) == -1);
+
+  bits.clear();
+  REQUIRE_FALSE(bits.any());
+}
+
+TEST_CASE("BitSet set operations match std::set") {
+  srand(49);
+  for (int round = 0; round < 50; round++) {
+    int n = 1 + rand() % 300;
+    BitSet a(n), b(n);
+    std::set<int> sa, sb;
+    for (int i = 0; i < n; i++) {
+      if (rand() % 3 == 0) {
+        a.set(i);
+        sa.insert(i);
+      }
+      if (rand() % 2 == 0) {
+        b.set(i);
+        sb.insert(i);
+      }
+    }
+
+    BitSet both, either, onlyA;
+    both.assign(a);
+    both.andWith(b);
+    either.assign(a);
+    either.orWith(b);
+    onlyA.assign(a);
+    onlyA.andNotWith(b);
+
+    for (int i = 0; i < n; i++) {
+      bool inA = sa.count(i) > 0, inB = sb.count(i) > 0;
+      REQUIRE(both.test(i) == (inA && inB));
+      REQUIRE(either.test(i) == (inA || inB));
+      REQUIRE(onlyA.test(i) == (inA && !inB));
+    }
+  }
+}
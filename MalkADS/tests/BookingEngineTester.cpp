@@ -0,0 +1,146 @@
+#include "managers/BookingEngine.h"
+#include "models/user.h"
+#include <catch2/catch_all.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <future>
+#include <string>
+#include <thread>
+#include <vector>
+
+namespace {
+
+class EngineUsers : public UsersManager {
+public:
+  void addUserMock(const std::string &name) {
+    userTable.putNew(name, User(name, "password"));
+  }
+};
+
+} // namespace
+
+TEST_CASE("BookingEngine applies requests and reports results") {
+  EngineUsers users;
+  RoomsManager rooms;
+  LaptopsManager laptops;
+  BooksManager books;
+  users.addUserMock("eng_a");
+  users.addUserMock("eng_b");
+
+  BookingEngine engine(users, rooms, laptops, books);
+  REQUIRE(engine.start());
+  REQUIRE_FALSE(engine.start());
+
+  BookingRequest addBook(BookingRequest::ADD_BOOK, "", "BE01");
+  addBook.title = "Engine Title";
+  addBook.author = "Engine Author";
+  REQUIRE(engine.execute(addBook).success());
+
+  BookingResult r = engine.execute(
+      BookingRequest(BookingRequest::BORROW_BOOK, "eng_a", "BE01", 100, 200));
+  REQUIRE(r.status == BookingResult::OK);
+
+  // Taken for that period, so the second borrower is queued instead
+  r = engine.execute(
+      BookingRequest(BookingRequest::BORROW_BOOK, "eng_b", "BE01", 150, 250));
+  REQUIRE(r.status == BookingResult::WAITLISTED);
+  REQUIRE(r.position == 1);
+
+  r = engine.execute(
+      BookingRequest(BookingRequest::BORROW_BOOK, "nobody", "BE01", 1, 2));
+  REQUIRE(r.status == BookingResult::UNKNOWN_USER);
+
+  REQUIRE(engine.execute(BookingRequest(BookingRequest::ADD_LAPTOP, "", "LE01"))
+              .success());
+  r = engine.execute(
+      BookingRequest(BookingRequest::BORROW_ANY_LAPTOP, "eng_a", "", 10, 20));
+  REQUIRE(r.success());
+  REQUIRE_FALSE(r.resourceId.empty());
+  r = engine.execute(
+      BookingRequest(BookingRequest::BORROW_ANY_LAPTOP, "eng_a", "", 15, 25));
+  REQUIRE(r.status == BookingResult::LIMIT_REACHED);
+
+  engine.inspect([&]() {
+    REQUIRE(books.waitlistPosition("BE01", "eng_b") == 1);
+  });
+
+  engine.execute(BookingRequest(BookingRequest::REMOVE_BOOK, "", "BE01"));
+  engine.execute(BookingRequest(BookingRequest::REMOVE_LAPTOP, "", "LE01"));
+  engine.stop();
+  REQUIRE_FALSE(engine.isRunning());
+}
+
+TEST_CASE("BookingEngine saves once per batch") {
+  EngineUsers users;
+  RoomsManager rooms;
+  LaptopsManager laptops;
+  BooksManager books;
+
+  BookingEngine engine(users, rooms, laptops, books);
+  engine.start();
+
+  const int n = 20;
+  std::vector<std::future<BookingResult>> results;
+  // Hold the engine off while the requests pile up
+  engine.inspect([&]() {
+    for (int i = 0; i < n; i++)
+      results.push_back(engine.submit(BookingRequest(
+          BookingRequest::ADD_LAPTOP, "", "LB" + std::to_string(i))));
+  });
+  for (std::future<BookingResult> &f : results)
+    REQUIRE(f.get().success());
+
+  REQUIRE(engine.requestsApplied() == n);
+  REQUIRE(engine.flushes() <= 2);
+  REQUIRE(engine.flushes() == engine.batchesApplied());
+
+  // Failed requests change nothing and skip the save
+  long long before = engine.flushes();
+  REQUIRE_FALSE(
+      engine.execute(BookingRequest(BookingRequest::ADD_LAPTOP, "", "LB0"))
+          .success());
+  REQUIRE(engine.flushes() == before);
+
+  for (int i = 0; i < n; i++)
+    engine.execute(BookingRequest(BookingRequest::REMOVE_LAPTOP, "",
+                                  "LB" + std::to_string(i)));
+}
+
+TEST_CASE("BookingEngine serializes concurrent bookings") {
+  EngineUsers users;
+  RoomsManager rooms;
+  LaptopsManager laptops;
+  BooksManager books;
+  const int threads = 8;
+  for (int i = 0; i < threads; i++)
+    users.addUserMock("eng_user" + std::to_string(i));
+  laptops.addLaptopDirect("LC01");
+
+  BookingEngine engine(users, rooms, laptops, books, 4);
+  engine.start();
+
+  // Everyone wants the same laptop for the same period
+  std::vector<int> won(threads, 0);
+  std::vector<std::thread> workers;
+  for (int i = 0; i < threads; i++) {
+    workers.push_back(std::thread([&engine, &won, i]() {
+      BookingResult r = engine.execute(
+          BookingRequest(BookingRequest::BORROW_LAPTOP,
+                         "eng_user" + std::to_string(i), "LC01", 500, 600));
+      won[i] = r.success() ? 1 : 0;
+    }));
+  }
+  for (std::thread &t : workers)
+    t.join();
+
+  int winners = 0;
+  for (int w : won)
+    winners += w;
+  REQUIRE(winners == 1);
+  REQUIRE(engine.requestsApplied() == threads);
+
+  engine.stop();
+  // Stopped: requests run on the caller's thread
+  REQUIRE(engine.execute(BookingRequest(BookingRequest::REMOVE_LAPTOP, "",
+                                        "LC01"))
+              .success());
+}
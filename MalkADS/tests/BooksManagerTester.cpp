@@ -9,8 +9,15 @@
 #include "models/user.h"
 #include "structures/IntervalTreeComplete.h"
 #include "structures/hash_map.h"
+#include "ScopedDataDir.h"
 #include <catch2/catch_all.hpp>
 #include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
 
 TEST_CASE("Add and get book") {
   BooksManager manager;
@@ -60,3 +67,518 @@ TEST_CASE("Borrow book non-interactive") {
   manager.addBookDirect("B006", "Title6", "Author6");
   REQUIRE(manager.borrowBookDirect(&user, "B006", 1, 2) == false);
 }
+
+TEST_CASE("Waitlist allocates the book when a loan is cancelled") {
+  BooksManager manager;
+  User owner("owner", "password");
+  User first("first", "password");
+  User second("second", "password");
+
+  manager.addBookDirect("B010", "Title10", "Author10");
+  REQUIRE(manager.borrowBookDirect(&owner, "B010", 100, 200) == true);
+
+  // Book is free for this window, so there is nothing to wait for
+  REQUIRE(manager.joinWaitlist(&first, "B010", 300, 400) == false);
+
+  REQUIRE(manager.borrowBookDirect(&first, "B010", 150, 250) == false);
+  REQUIRE(manager.joinWaitlist(&first, "B010", 150, 250) == true);
+  REQUIRE(manager.joinWaitlist(&first, "B010", 150, 250) == false);
+  REQUIRE(manager.joinWaitlist(&second, "B010", 120, 180) == true);
+  REQUIRE(manager.waitlistSize("B010") == 2);
+  REQUIRE(manager.waitlistPosition("B010", "first") == 1);
+  REQUIRE(manager.waitlistPosition("B010", "second") == 2);
+
+  // Only the owner of a loan may cancel it
+  REQUIRE(manager.cancelBookLoanDirect(&first, "B010", 100, 200) == false);
+  REQUIRE(manager.cancelBookLoanDirect(&owner, "B010", 100, 200) == true);
+
+  // Head of the queue got the book; second overlaps it and keeps waiting
+  REQUIRE(manager.waitlistSize("B010") == 1);
+  REQUIRE(manager.waitlistPosition("B010", "second") == 1);
+  REQUIRE(manager.borrowBookDirect(&owner, "B010", 200, 210) == false);
+  REQUIRE(first.canBookBook(150, 250) == true); // 1 of 3 books used
+}
+
+TEST_CASE("Waitlist de-prioritizes repeat borrowers") {
+  BooksManager manager;
+  User regular("regular", "password");
+  User newcomer("newcomer", "password");
+  User holder("holder", "password");
+
+  manager.addBookDirect("B011", "Title11", "Author11");
+  REQUIRE(manager.borrowBookDirect(&regular, "B011", 10, 20) == true);
+  REQUIRE(manager.borrowBookDirect(&holder, "B011", 100, 200) == true);
+
+  // regular asks first, but has borrowed this book before
+  REQUIRE(manager.joinWaitlist(&regular, "B011", 100, 200) == true);
+  REQUIRE(manager.joinWaitlist(&newcomer, "B011", 100, 200) == true);
+  REQUIRE(manager.waitlistPosition("B011", "newcomer") == 1);
+  REQUIRE(manager.waitlistPosition("B011", "regular") == 2);
+
+  REQUIRE(manager.cancelBookLoanDirect(&holder, "B011", 100, 200) == true);
+  REQUIRE(manager.waitlistPosition("B011", "regular") == 1);
+  REQUIRE(manager.borrowBookDirect(&holder, "B011", 100, 200) == false);
+}
+
+TEST_CASE("Bad waitlist lines are skipped on load") {
+  ScopedDataDir dataDir;
+  REQUIRE(dataDir.ok());
+  {
+    // The name loadBooksFromFile opens
+    std::ofstream books("data\\books.txt");
+    books << "BW01,Waited For,Some Author\n";
+    std::ofstream waitlist("data/book_waitlist.txt");
+    waitlist << "BW01,100,200,first,5,0,1\n"
+             << "BW01,abc,200,second,6,0,2\n"
+             << "BW01,100,200,third,7,0,\n"
+             << "BW01,100,200,fourth,99999999999999999999,0,3\n"
+             << "BW01,100,200,fifth,8,1,4\n";
+  }
+
+  BooksManager manager;
+  REQUIRE(manager.waitlistSize("BW01") == 2);
+  REQUIRE(manager.waitlistPosition("BW01", "first") == 1);
+  REQUIRE(manager.waitlistPosition("BW01", "second") == 0);
+}
+
+TEST_CASE("Bad book booking lines are skipped on load") {
+  ScopedDataDir dataDir;
+  REQUIRE(dataDir.ok());
+  {
+    // The name loadBooksFromFile opens
+    std::ofstream books("data\\books.txt");
+    books << "BL01,Loaned Out,Some Author,3\n";
+    std::ofstream loans("data/book_bookings.txt");
+    loans << "BL01,100,200,first,0\n"
+          << "BL01,1x0,200,second,1\n"
+          << "BL01,100,\n"
+          << "BL01,100,200,third,\n"
+          << "BL01,100,200,fourth\n"
+          << "BL01,300,200,fifth,2\n";
+  }
+
+  BooksManager manager;
+  REQUIRE(manager.availableCopies("BL01", 100, 200) == 1);
+  REQUIRE(manager.availableCopies("BL01", 300, 400) == 3);
+}
+
+TEST_CASE("Waitlist requests can be withdrawn") {
+  BooksManager manager;
+  User holder("holder2", "password");
+  User quitter("quitter", "password");
+  User patient("patient", "password");
+
+  manager.addBookDirect("B012", "Title12", "Author12");
+  REQUIRE(manager.borrowBookDirect(&holder, "B012", 100, 200) == true);
+  REQUIRE(manager.joinWaitlist(&quitter, "B012", 100, 200) == true);
+  REQUIRE(manager.joinWaitlist(&patient, "B012", 100, 200) == true);
+
+  REQUIRE(manager.leaveWaitlist(&quitter, "B012") == true);
+  REQUIRE(manager.leaveWaitlist(&quitter, "B012") == false);
+  REQUIRE(manager.waitlistPosition("B012", "quitter") == 0);
+  REQUIRE(manager.waitlistPosition("B012", "patient") == 1);
+
+  // Can rejoin after withdrawing
+  REQUIRE(manager.joinWaitlist(&quitter, "B012", 100, 200) == true);
+  REQUIRE(manager.waitlistPosition("B012", "quitter") == 2);
+
+  REQUIRE(manager.cancelBookLoanDirect(&holder, "B012", 100, 200) == true);
+  REQUIRE(manager.waitlistPosition("B012", "patient") == 0);
+  REQUIRE(manager.waitlistPosition("B012", "quitter") == 1);
+}
+
+TEST_CASE("Waitlist requests lapse when their window starts") {
+  BooksManager manager;
+  User holder("holder3", "password");
+  User late("late", "password");
+  User next("next", "password");
+
+  manager.addBookDirect("B013", "Title13", "Author13");
+  REQUIRE(manager.borrowBookDirect(&holder, "B013", 100, 200) == true);
+  REQUIRE(manager.joinWaitlist(&late, "B013", 150, 250) == true);
+  REQUIRE(manager.joinWaitlist(&next, "B013", 190, 300) == true);
+  REQUIRE(manager.pendingTimers() == 2);
+
+  REQUIRE(manager.advanceClock(149) == 0);
+  REQUIRE(manager.waitlistSize("B013") == 2);
+
+  // late's window opened while the book was still out
+  REQUIRE(manager.advanceClock(150) == 1);
+  REQUIRE(manager.waitlistPosition("B013", "late") == 0);
+  REQUIRE(manager.waitlistPosition("B013", "next") == 1);
+
+  // Allocated requests no longer lapse
+  REQUIRE(manager.cancelBookLoanDirect(&holder, "B013", 100, 200) == true);
+  REQUIRE(manager.waitlistSize("B013") == 0);
+  REQUIRE(manager.pendingTimers() == 0);
+  REQUIRE(manager.advanceClock(1000) == 0);
+  REQUIRE(manager.borrowBookDirect(&holder, "B013", 250, 260) == false);
+}
+
+TEST_CASE("Author index tracks adds and removals") {
+  BooksManager manager;
+  for (int i = 0; i < 6; i++)
+    manager.addBookDirect("BA" + std::to_string(i),
+                          "Prolific Title " + std::to_string(i),
+                          "Prolific Author");
+
+  std::vector<std::string> ids;
+  auto collect = [&](Book &book) { ids.push_back(book.getID()); };
+  REQUIRE(manager.forEachBookByAuthor("prolific author", collect) == 6);
+
+  // Remove from the front, middle and end of the author's list
+  REQUIRE(manager.removeBookDirect("BA0"));
+  REQUIRE(manager.removeBookDirect("BA3"));
+  REQUIRE(manager.removeBookDirect("BA5"));
+  ids.clear();
+  REQUIRE(manager.forEachBookByAuthor("Prolific Author", collect) == 3);
+  std::sort(ids.begin(), ids.end());
+  REQUIRE(ids == std::vector<std::string>{"BA1", "BA2", "BA4"});
+
+  // Freed catalog IDs are reused
+  REQUIRE(manager.addBookDirect("BA6", "Prolific Title 6", "Prolific Author"));
+  REQUIRE(manager.forEachBookByAuthor("Prolific Author", collect) == 4);
+
+  for (int i = 1; i <= 6; i++)
+    manager.removeBookDirect("BA" + std::to_string(i));
+  REQUIRE(manager.forEachBookByAuthor("Prolific Author", collect) == 0);
+}
+
+TEST_CASE("Books are indexed by ID and by title") {
+  BooksManager manager;
+  REQUIRE(manager.addBookDirect("BI01", "Indexed Title", "Index Author"));
+
+  // IDs and titles are both unique
+  REQUIRE_FALSE(manager.addBookDirect("BI01", "Other Title", "Index Author"));
+  REQUIRE_FALSE(manager.addBookDirect("BI02", "INDEXED title", "Someone"));
+
+  Book *book = manager.getBook("BI01");
+  REQUIRE(book != nullptr);
+  REQUIRE(book->getTitle() == "Indexed Title");
+
+  bool listed = false;
+  manager.forEachBook([&](StringRef id) {
+    if (id == "BI01")
+      listed = true;
+  });
+  REQUIRE(listed);
+
+  REQUIRE(manager.removeBookDirect("BI01"));
+  REQUIRE(manager.getBook("BI01") == nullptr);
+  // The title is free again
+  REQUIRE(manager.addBookDirect("BI02", "Indexed Title", "Index Author"));
+  REQUIRE(manager.getBook("BI02") != nullptr);
+  REQUIRE(manager.removeBookDirect("BI02"));
+}
+
+TEST_CASE("Books can be searched by partial title or author") {
+  BooksManager manager;
+  manager.addBookDirect("BS01", "Searchable Algorithms", "Quentin Zyx");
+  manager.addBookDirect("BS02", "Searchable Databases", "Quentin Zyx");
+  manager.addBookDirect("BS03", "Unrelated Cooking", "Someone Else");
+
+  std::vector<std::string> ids;
+  auto collect = [&](Book &book) { ids.push_back(book.getID()); };
+
+  REQUIRE(manager.searchBooks("searchable", 0, collect) == 2);
+  REQUIRE(manager.searchBooks("zyx datab", 0, collect) == 1);
+  REQUIRE(ids.back() == "BS02");
+  REQUIRE(manager.searchBooks("searchable", 1, collect) == 1);
+
+  manager.removeBookDirect("BS02");
+  ids.clear();
+  REQUIRE(manager.searchBooks("QUENTIN", 0, collect) == 1);
+  REQUIRE(ids[0] == "BS01");
+
+  manager.removeBookDirect("BS01");
+  manager.removeBookDirect("BS03");
+}
+
+TEST_CASE("Titles and authors can be autocompleted") {
+  BooksManager manager;
+  manager.addBookDirect("BC01", "Qwzx Alpha", "Qwzy Writer");
+  manager.addBookDirect("BC02", "Qwzx Beta", "Qwzy Writer");
+  manager.addBookDirect("BC03", "Qwzx Gamma", "Other Penname");
+
+  std::vector<std::string> texts;
+  auto collect = [&](const std::string &text, int) { texts.push_back(text); };
+
+  // The author of two books outranks titles, which are alphabetical
+  REQUIRE(manager.autocomplete("QWZ", 10, collect) == 4);
+  REQUIRE(texts == std::vector<std::string>{"Qwzy Writer", "Qwzx Alpha",
+                                            "Qwzx Beta", "Qwzx Gamma"});
+
+  manager.removeBookDirect("BC01");
+  texts.clear();
+  REQUIRE(manager.autocomplete("qwzx", 10, collect) == 2);
+  REQUIRE(texts == std::vector<std::string>{"Qwzx Beta", "Qwzx Gamma"});
+  REQUIRE(manager.autocomplete("", 10, collect) == 0);
+
+  manager.removeBookDirect("BC02");
+  manager.removeBookDirect("BC03");
+  REQUIRE(manager.autocomplete("qwz", 10, collect) == 0);
+}
+
+TEST_CASE("Misspelled titles find the intended book") {
+  BooksManager manager;
+  manager.addBookDirect("BT01", "Qwzxv Typo Handbook", "Tia Typist");
+  manager.addBookDirect("BT02", "Qwzxv Typo Handbooks", "Tia Typist");
+
+  std::vector<std::pair<std::string, int>> found;
+  auto collect = [&](Book &book, int distance) {
+    found.push_back(std::make_pair(book.getID(), distance));
+  };
+
+  REQUIRE(manager.findSimilarTitles("qwzxv typo handbok", 2, 5, collect) == 2);
+  REQUIRE(found[0] == std::make_pair(std::string("BT01"), 1));
+  REQUIRE(found[1] == std::make_pair(std::string("BT02"), 2));
+
+  manager.removeBookDirect("BT01");
+  found.clear();
+  REQUIRE(manager.findSimilarTitles("qwzxv typo handbok", 1, 5, collect) == 0);
+
+  manager.removeBookDirect("BT02");
+}
+
+TEST_CASE("Books with several copies lend each one out") {
+  BooksManager manager;
+  User a("copyA", "password");
+  User b("copyB", "password");
+  User c("copyC", "password");
+
+  REQUIRE_FALSE(manager.addBookDirect("BM01", "Multi Copy", "Author", 0));
+  REQUIRE(manager.addBookDirect("BM01", "Multi Copy", "Author", 2));
+  REQUIRE(manager.getBook("BM01")->getCopies() == 2);
+  REQUIRE(manager.availableCopies("BM01", 100, 200) == 2);
+
+  int copy = -1;
+  REQUIRE(manager.borrowBookDirect(&a, "BM01", 100, 200, &copy));
+  REQUIRE(copy == 0);
+  REQUIRE(manager.borrowBookDirect(&b, "BM01", 150, 250, &copy));
+  REQUIRE(copy == 1);
+  REQUIRE(manager.availableCopies("BM01", 150, 160) == 0);
+  REQUIRE(manager.availableCopies("BM01", 200, 300) == 1);
+
+  // Both copies are out, so the third reader waits
+  REQUIRE_FALSE(manager.borrowBookDirect(&c, "BM01", 120, 180));
+  REQUIRE(manager.joinWaitlist(&c, "BM01", 120, 180));
+
+  // A copy with a loan cannot be removed; adding one serves the waitlist
+  REQUIRE_FALSE(manager.setBookCopies("BM01", 1));
+  REQUIRE(manager.setBookCopies("BM01", 3));
+  REQUIRE(manager.waitlistSize("BM01") == 0);
+  REQUIRE(manager.availableCopies("BM01", 120, 180) == 0);
+
+  // Cancelling finds the copy the loan was on
+  REQUIRE(manager.cancelBookLoanDirect(&b, "BM01", 150, 250));
+  REQUIRE(manager.availableCopies("BM01", 200, 250) == 3);
+
+  int loans = 0;
+  manager.forEachBooking([&](const std::string &id, int, int,
+                             const std::string &) {
+    if (id == "BM01")
+      loans++;
+  });
+  REQUIRE(loans == 2);
+
+  REQUIRE(manager.removeBookDirect("BM01"));
+}
+
+TEST_CASE("Catalog files are imported in bulk") {
+  const char *path = "import_test_books.txt";
+  {
+    std::ofstream out(path, std::ios::binary);
+    out << "BQ01,Bulk First,Ivy Importer\r\n"
+        << "BQ02,Bulk Second,Ivy Importer,3\n"
+        << "not a catalog line\n"
+        << "BQ01,Bulk Duplicate Id,Someone\n"
+        << "BQ03,BULK FIRST,Someone\n"
+        << "BQ04,Bulk Comma,Last, First\n";
+    // Enough rows to be split across threads
+    for (int i = 0; i < 5000; i++)
+      out << "BQX" << i << ",Bulk Filler " << i << ",Filler Author " << i % 7
+          << "\n";
+  }
+
+  BooksManager manager;
+  manager.addBookDirect("BQ00", "Bulk Existing", "Ivy Importer");
+  REQUIRE(manager.importBooksFromFile(path, 4) == 5003);
+  REQUIRE(manager.importBooksFromFile("no_such_catalog.txt") == -1);
+
+  REQUIRE(manager.getBook("BQ01")->getTitle() == "Bulk First");
+  REQUIRE(manager.getBook("BQ02")->getCopies() == 3);
+  REQUIRE(manager.availableCopies("BQ02", 0, 10) == 3);
+  REQUIRE(manager.getBook("BQ03") == nullptr);
+  REQUIRE(manager.getBook("BQ04")->getAuthor() == "Last, First");
+  REQUIRE(manager.getBook("BQX4999") != nullptr);
+
+  // Every index sees the imported books
+  std::vector<std::string> ids;
+  REQUIRE(manager.forEachBookByAuthor("ivy importer", [&](Book &book) {
+    ids.push_back(book.getID());
+  }) == 3);
+  REQUIRE(manager.forEachBookByAuthor("Filler Author 3", [](Book &) {}) ==
+          714);
+  REQUIRE(manager.searchBooks("filler 4999", 0, [](Book &) {}) == 1);
+  REQUIRE(manager.findSimilarTitles("bulk secnd", 2, 5, [](Book &, int) {}) ==
+          1);
+  REQUIRE(manager.autocomplete("ivy imp", 10,
+                               [](const std::string &, int) {}) == 1);
+
+  // Importing again adds nothing
+  REQUIRE(manager.importBooksFromFile(path, 1) == 0);
+
+  std::vector<std::string> all;
+  manager.forEachBook([&](StringRef id) {
+    if (id.str().compare(0, 2, "BQ") == 0)
+      all.push_back(id.str());
+  });
+  for (const std::string &id : all)
+    manager.removeBookDirect(id);
+  std::remove(path);
+}
+
+TEST_CASE("Book strings are stored once in the catalog arena") {
+  BooksManager manager;
+  const size_t before = manager.stringBytesStored();
+  REQUIRE(manager.addBookDirect("BA01", "arena first", "Same Author"));
+  REQUIRE(manager.addBookDirect("BA02", "arena second", "Same Author"));
+  // Two IDs, two titles and the author once
+  REQUIRE(manager.stringBytesStored() - before ==
+          4 + 4 + 11 + 12 + std::string("Same Author").size());
+
+  Book *first = manager.getBook("BA01");
+  Book *second = manager.getBook("BA02");
+  REQUIRE(first->authorRef().data() == second->authorRef().data());
+  REQUIRE(first->getTitle() == "Arena First");
+
+  // Catalog scans hand out the stored strings themselves
+  int seen = 0;
+  manager.forEachBookWithDetails(
+      [&](StringRef id, StringRef title, StringRef author) {
+        if (id == "BA02") {
+          REQUIRE(title.data() == second->titleRef().data());
+          REQUIRE(author == "Same Author");
+          seen++;
+        }
+      });
+  REQUIRE(seen == 1);
+
+  REQUIRE(manager.removeBookDirect("BA01"));
+  REQUIRE(manager.removeBookDirect("BA02"));
+}
+
+TEST_CASE("Ranked search returns the k best matches") {
+  BooksManager manager;
+  manager.addBookDirect("BR01", "Zjava Basics", "Ann Writer");
+  manager.addBookDirect("BR02", "Learning Zjavascript", "Bob Zjava");
+  manager.addBookDirect("BR03", "Coffee", "Zjava Jones");
+  manager.addBookDirect("BR04", "Zjava And More Zjava", "Someone");
+
+  std::vector<std::string> ids;
+  std::vector<double> scores;
+  auto collect = [&](Book &book, double score) {
+    ids.push_back(book.getID());
+    scores.push_back(score);
+  };
+
+  // Title words outweigh author words; word starts earn a bonus
+  REQUIRE(manager.searchBooksRanked("zjava", 10, false, collect) == 4);
+  REQUIRE(ids == std::vector<std::string>{"BR04", "BR02", "BR01", "BR03"});
+  REQUIRE(scores == std::vector<double>{18, 12, 9, 3});
+
+  // Only the best k come back
+  ids.clear();
+  REQUIRE(manager.searchBooksRanked("zjava", 2, false, collect) == 2);
+  REQUIRE(ids == std::vector<std::string>{"BR04", "BR02"});
+  REQUIRE(manager.searchBooksRanked("zjava", 0, false, collect) == 0);
+
+  // Fifteen loans add log2(16) = 4, lifting BR01 past BR02
+  std::vector<User> readers;
+  for (int i = 0; i < 15; i++)
+    readers.push_back(User("rankReader" + std::to_string(i), "password"));
+  for (int i = 0; i < 15; i++)
+    REQUIRE(manager.borrowBookDirect(&readers[i], "BR01", i * 100,
+                                     i * 100 + 50));
+  ids.clear();
+  manager.searchBooksRanked("zjava", 3, true, collect);
+  REQUIRE(ids == std::vector<std::string>{"BR04", "BR01", "BR02"});
+
+  // Cancelled loans stop counting
+  for (int i = 0; i < 15; i++)
+    REQUIRE(manager.cancelBookLoanDirect(&readers[i], "BR01", i * 100,
+                                         i * 100 + 50));
+  ids.clear();
+  manager.searchBooksRanked("zjava", 2, true, collect);
+  REQUIRE(ids == std::vector<std::string>{"BR04", "BR02"});
+
+  for (const char *id : {"BR01", "BR02", "BR03", "BR04"})
+    manager.removeBookDirect(id);
+}
+
+TEST_CASE("Ranked search reports each match's free copies") {
+  BooksManager manager;
+  manager.addBookDirect("BV01", "Zqnet Primer", "Ann Writer", 3);
+  manager.addBookDirect("BV02", "Zqnet Advanced", "Bob Writer");
+  User first("availReader1", "password");
+  User second("availReader2", "password");
+  REQUIRE(manager.borrowBookDirect(&first, "BV01", 100, 200));
+  REQUIRE(manager.borrowBookDirect(&second, "BV01", 150, 250));
+  REQUIRE(manager.borrowBookDirect(&first, "BV02", 100, 200));
+
+  std::vector<std::string> ids;
+  std::vector<int> free, copies;
+  auto collect = [&](Book &book, double, int freeCopies, int total) {
+    ids.push_back(book.getID());
+    free.push_back(freeCopies);
+    copies.push_back(total);
+  };
+
+  REQUIRE(manager.searchBooksAvailable("zqnet", 160, 190, 10, false,
+                                       collect) == 2);
+  REQUIRE(ids == std::vector<std::string>{"BV02", "BV01"});
+  REQUIRE(free == std::vector<int>{0, 1});
+  REQUIRE(copies == std::vector<int>{1, 3});
+
+  // The same counts as asking book by book
+  free.clear();
+  manager.searchBooksAvailable("zqnet", 210, 300, 10, false, collect);
+  REQUIRE(free == std::vector<int>{manager.availableCopies("BV02", 210, 300),
+                                   manager.availableCopies("BV01", 210, 300)});
+  REQUIRE(free == std::vector<int>{1, 2});
+
+  manager.removeBookDirect("BV01");
+  manager.removeBookDirect("BV02");
+}
+
+TEST_CASE("Catalog listing reports free copies and stops at the limit") {
+  BooksManager manager;
+  manager.addBookDirect("BW01", "Listing Primer", "Ann Writer", 2);
+  manager.addBookDirect("BW02", "Listing Advanced", "Bob Writer");
+  User reader("listReader", "password");
+  REQUIRE(manager.borrowBookDirect(&reader, "BW01", 100, 200));
+
+  int all = 0;
+  std::vector<int> free, copies;
+  REQUIRE(manager.listBooksAvailable(
+              150, 160, 0, [&](Book &book, int freeCopies, int total) {
+                all++;
+                if (book.getID() == "BW01" || book.getID() == "BW02") {
+                  free.push_back(freeCopies);
+                  copies.push_back(total);
+                }
+              }) == all);
+  REQUIRE(free == std::vector<int>{1, 1});
+  REQUIRE(copies == std::vector<int>{2, 1});
+
+  int seen = 0;
+  REQUIRE(manager.listBooksAvailable(150, 160, 1,
+                                     [&](Book &, int, int) { seen++; }) == 1);
+  REQUIRE(seen == 1);
+  REQUIRE(manager.forEachBookWithDetails(
+              [&](StringRef, StringRef, StringRef) { seen++; }, 1) == 1);
+  REQUIRE(seen == 2);
+
+  manager.removeBookDirect("BW01");
+  manager.removeBookDirect("BW02");
+}
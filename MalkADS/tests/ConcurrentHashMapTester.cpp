@@ -0,0 +1,55 @@
+#include "structures/concurrent_hash_map.h"
+#include <catch2/catch_all.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST_CASE("ConcurrentHashMap single-threaded operations") {
+  ConcurrentHashMap<std::string, int> map(8);
+
+  REQUIRE(map.putNew("R101", 1) == true);
+  REQUIRE(map.putNew("R101", 2) == false);
+
+  int v = 0;
+  REQUIRE(map.get("R101", v) == true);
+  REQUIRE(v == 1);
+  REQUIRE(map.get("R999", v) == false);
+
+  REQUIRE(map.visit("R101", [](int &val) { val += 10; }) == true);
+  REQUIRE(map.get("R101", v));
+  REQUIRE(v == 11);
+
+  REQUIRE(map.erase("R101") == true);
+  REQUIRE(map.contains("R101") == false);
+  REQUIRE(map.empty());
+}
+
+TEST_CASE("ConcurrentHashMap parallel writers and readers") {
+  ConcurrentHashMap<std::string, int> map(16);
+  const int threads = 8;
+  const int perThread = 2000;
+
+  std::vector<std::thread> workers;
+  for (int t = 0; t < threads; t++) {
+    workers.emplace_back([&map, t] {
+      for (int i = 0; i < perThread; i++) {
+        const std::string key = "L" + std::to_string(t * perThread + i);
+        map.putNew(key, i);
+        int v;
+        map.get(key, v);
+        if (i % 2)
+          map.erase(key);
+      }
+    });
+  }
+  for (std::thread &w : workers)
+    w.join();
+
+  REQUIRE(map.size() == threads * perThread / 2);
+
+  int seen = 0;
+  map.forEach([&](const std::string &, int &) { seen++; },
+              ForEachMode::Consistent);
+  REQUIRE(seen == map.size());
+}
@@ -0,0 +1,76 @@
+#include "structures/copy_pool.h"
+#include <catch2/catch_all.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <string>
+
+TEST_CASE("CopyPool prefers copies that are free from the start on") {
+  CopyPool pool(3);
+  REQUIRE(pool.copies() == 3);
+  REQUIRE(pool.findFree(0, 10) == 0);
+
+  pool.insert(0, 0, 100, "a");
+  pool.insert(1, 50, 60, "b");
+  REQUIRE(pool.findFree(10, 20) == 2);
+
+  // Copy 1 is free again from 60, copy 2 is untouched: leftmost wins
+  REQUIRE(pool.findFree(60, 70) == 1);
+  // Half-open loans: a loan ending at 100 does not block one from 100
+  REQUIRE(pool.findFree(100, 110) == 0);
+}
+
+TEST_CASE("CopyPool fills gaps when every copy is booked later") {
+  CopyPool pool(2);
+  pool.insert(0, 100, 200, "a");
+  pool.insert(1, 300, 400, "b");
+
+  // Both copies are busy after 0, but copy 0 is free before 100
+  REQUIRE(pool.findFree(0, 100) == 0);
+  REQUIRE(pool.findFree(150, 250) == 1);
+  REQUIRE(pool.findFree(150, 350) == -1);
+  REQUIRE(pool.freeCount(0, 50) == 2);
+  REQUIRE(pool.freeCount(150, 250) == 1);
+  REQUIRE(pool.isFree(0, 200, 300));
+  REQUIRE_FALSE(pool.isFree(2, 0, 10));
+}
+
+TEST_CASE("CopyPool finds, removes and reports loans") {
+  CopyPool pool(2);
+  pool.insert(1, 10, 20, "reader");
+  pool.insert(0, 10, 20, "other");
+  REQUIRE(pool.findLoan(10, 20, "reader") == 1);
+  REQUIRE(pool.findLoan(10, 20, "nobody") == -1);
+
+  REQUIRE(pool.remove(1, 10, 20));
+  REQUIRE_FALSE(pool.remove(1, 10, 20));
+  REQUIRE(pool.findFree(15, 30) == 1);
+
+  int loans = 0;
+  pool.forEachLoan([&](int copy, int low, int high, const std::string &user) {
+    REQUIRE(copy == 0);
+    REQUIRE(low == 10);
+    REQUIRE(high == 20);
+    REQUIRE(user == "other");
+    loans++;
+  });
+  REQUIRE(loans == 1);
+}
+
+TEST_CASE("CopyPool only drops copies without loans") {
+  CopyPool pool(1);
+  REQUIRE(pool.resize(5));
+  pool.insert(4, 0, 10, "x");
+  REQUIRE_FALSE(pool.resize(4));
+  REQUIRE_FALSE(pool.resize(0));
+  REQUIRE(pool.remove(4, 0, 10));
+  REQUIRE(pool.resize(2));
+  REQUIRE(pool.copies() == 2);
+  REQUIRE(pool.findFree(0, 10) == 0);
+
+  // Many copies: the descent still lands on the leftmost free one
+  REQUIRE(pool.resize(37));
+  for (int c = 0; c < 36; c++)
+    pool.insert(c, 0, 1000, "busy");
+  REQUIRE(pool.findFree(500, 600) == 36);
+  pool.remove(17, 0, 1000);
+  REQUIRE(pool.findFree(500, 600) == 17);
+}
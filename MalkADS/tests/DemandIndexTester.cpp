@@ -0,0 +1,85 @@
+#include "structures/demand_index.h"
+#include "structures/fenwick_tree.h"
+#include "structures/top_k.h"
+#include <catch2/catch_all.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+#include <utility>
+#include <vector>
+
+TEST_CASE("FenwickTree range sums survive growth") {
+  FenwickTree tree(4);
+  std::vector<int> model(1000, 0);
+  srand(3);
+  for (int step = 0; step < 3000; step++) {
+    int index = rand() % 1000;
+    int delta = rand() % 5 - 1;
+    tree.add(index, delta);
+    model[index] += delta;
+
+    int lo = rand() % 1000;
+    int hi = lo + rand() % 200;
+    int expected = 0;
+    for (int i = lo; i <= hi && i < 1000; i++)
+      expected += model[i];
+    REQUIRE(tree.rangeSum(lo, hi) == expected);
+  }
+  REQUIRE(tree.rangeSum(5000, 6000) == 0);
+  REQUIRE(tree.at(model.size() + 10) == 0);
+}
+
+TEST_CASE("TopK keeps the best k items, best first") {
+  TopK<int> smallest(3); // DefaultComparator: smaller ranks higher
+  const int values[] = {9, 4, 7, 1, 8, 2, 6};
+  for (int v : values)
+    smallest.offer(v);
+  REQUIRE(smallest.size() == 3);
+
+  std::vector<int> out;
+  smallest.drain([&](int &v) { out.push_back(v); });
+  REQUIRE(out == std::vector<int>{1, 2, 4});
+  REQUIRE(smallest.size() == 0);
+
+  TopK<int> none(0);
+  REQUIRE_FALSE(none.offer(1));
+}
+
+TEST_CASE("DemandIndex answers top-k over a window of days") {
+  DemandIndex demand;
+  const long long day = 24 * 3600;
+
+  // R1: 3 bookings on day 1, R2: 2 on day 1 and 4 on day 5, R3: 1 on day 2
+  for (int i = 0; i < 3; i++)
+    demand.record("R1", 1 * day + i * 3600);
+  for (int i = 0; i < 2; i++)
+    demand.record("R2", 1 * day + i * 3600);
+  for (int i = 0; i < 4; i++)
+    demand.record("R2", 5 * day + i * 3600);
+  demand.record("R3", 2 * day);
+
+  std::vector<std::pair<std::string, int>> top;
+  auto collect = [&](const std::string &id, int count) {
+    top.push_back(std::make_pair(id, count));
+  };
+
+  REQUIRE(demand.topK(2, 0, 10 * day, collect) == 2);
+  REQUIRE(top[0] == std::make_pair(std::string("R2"), 6));
+  REQUIRE(top[1] == std::make_pair(std::string("R1"), 3));
+
+  top.clear();
+  REQUIRE(demand.topK(5, 1 * day, 2 * day + 100, collect) == 3);
+  REQUIRE(top[0] == std::make_pair(std::string("R1"), 3));
+  REQUIRE(top[1] == std::make_pair(std::string("R2"), 2));
+  REQUIRE(top[2] == std::make_pair(std::string("R3"), 1));
+
+  // Cancelled bookings and removed resources stop counting
+  demand.record("R1", 1 * day, -1);
+  demand.removeResource("R2");
+  REQUIRE(demand.count("R1", 0, 10 * day) == 2);
+  REQUIRE(demand.total("R2") == 0);
+
+  top.clear();
+  REQUIRE(demand.topK(5, 6 * day, 9 * day, collect) == 0);
+}
@@ -0,0 +1,73 @@
+#include "structures/free_slot_index.h"
+#include <catch2/catch_all.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <vector>
+
+namespace {
+
+std::vector<int> membersOf(const BitSet &bits) {
+  std::vector<int> members;
+  for (int i = bits.next(0); i >= 0; i = bits.next(i + 1))
+    members.push_back(i);
+  return members;
+}
+
+} // namespace
+
+TEST_CASE("FreeSlotIndex separates sure and edge-dependent members") {
+  // Ten slots of 100 seconds from 1000
+  FreeSlotIndex index(100, 10);
+  for (int r = 0; r < 4; r++)
+    index.addMember(r);
+  index.reset(1000);
+  REQUIRE(index.covers(1000, 2000));
+  REQUIRE_FALSE(index.covers(900, 1100));
+  REQUIRE_FALSE(index.covers(1500, 2001));
+
+  index.markBusy(1, 1150, 1180); // inside slot 1
+  index.markBusy(2, 1300, 1400); // exactly slot 3
+  index.markBusy(3, 1000, 2000); // everything
+
+  BitSet sure, maybe;
+  // [1120, 1350) touches slots 1-3 and covers slot 2 completely
+  index.query(1120, 1350, sure, maybe);
+  REQUIRE(membersOf(sure) == std::vector<int>{0});
+  REQUIRE(membersOf(maybe) == std::vector<int>{1, 2});
+
+  // On slot boundaries nothing depends on the edges
+  index.query(1200, 1300, sure, maybe);
+  REQUIRE(membersOf(sure) == std::vector<int>{0, 1, 2});
+  REQUIRE_FALSE(maybe.any());
+
+  // A window inside one slot covers none completely
+  index.query(1310, 1320, sure, maybe);
+  REQUIRE(membersOf(sure) == std::vector<int>{0, 1});
+  REQUIRE(membersOf(maybe) == std::vector<int>{2, 3});
+}
+
+TEST_CASE("FreeSlotIndex frees slots no other booking overlaps") {
+  FreeSlotIndex index(100, 10);
+  index.addMember(0);
+  index.reset(0);
+  index.markBusy(0, 100, 300);
+  index.markBusy(0, 250, 260);
+
+  // The second booking keeps slot 2 busy after the first is cancelled
+  index.markFree(0, 100, 300, [](long long slotStart, long long slotEnd) {
+    return slotStart < 260 && 250 < slotEnd;
+  });
+  BitSet sure, maybe;
+  index.query(100, 200, sure, maybe);
+  REQUIRE(sure.test(0));
+  index.query(200, 300, sure, maybe);
+  REQUIRE_FALSE(sure.test(0));
+
+  // Removed members are never reported; new ones start free
+  index.removeMember(0);
+  index.query(0, 1000, sure, maybe);
+  REQUIRE_FALSE(sure.any());
+  REQUIRE_FALSE(maybe.any());
+  index.addMember(70);
+  index.query(0, 1000, sure, maybe);
+  REQUIRE(membersOf(sure) == std::vector<int>{70});
+}
@@ -0,0 +1,105 @@
+#include "structures/fuzzy_index.h"
+#include <catch2/catch_all.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+std::vector<std::pair<int, int>> similar(const FuzzyIndex &index,
+                                         const std::string &query,
+                                         int maxDistance, int k = 10) {
+  std::vector<std::pair<int, int>> hits;
+  index.search(query, maxDistance, k, [&](int id, int distance) {
+    hits.push_back(std::make_pair(id, distance));
+  });
+  return hits;
+}
+
+} // namespace
+
+TEST_CASE("FuzzyIndex computes bounded edit distances") {
+  REQUIRE(FuzzyIndex::boundedDistance("kitten", "sitting", 3) == 3);
+  REQUIRE(FuzzyIndex::boundedDistance("kitten", "sitting", 2) == 3);
+  REQUIRE(FuzzyIndex::boundedDistance("abc", "abc", 0) == 0);
+  REQUIRE(FuzzyIndex::boundedDistance("", "ab", 2) == 2);
+  REQUIRE(FuzzyIndex::boundedDistance("abcdef", "ab", 2) == 3);
+  REQUIRE(FuzzyIndex::boundedDistance("flaw", "lawn", 5) == 2);
+}
+
+TEST_CASE("FuzzyIndex finds titles despite typos") {
+  FuzzyIndex index;
+  index.add(0, "Introduction to Algorithms");
+  index.add(1, "The Great Gatsby");
+  index.add(2, "The Great Gatsbys Neighbour");
+  index.add(4, "Pride and Prejudice");
+  REQUIRE(index.size() == 4);
+
+  // Missing letter, swapped letters, wrong case and punctuation
+  REQUIRE(similar(index, "Introducton to Algorithms", 2) ==
+          std::vector<std::pair<int, int>>{{0, 1}});
+  REQUIRE(similar(index, "pride and prejduice!", 2) ==
+          std::vector<std::pair<int, int>>{{4, 2}});
+  REQUIRE(similar(index, "THE GREAT GATSBY", 0) ==
+          std::vector<std::pair<int, int>>{{1, 0}});
+  REQUIRE(similar(index, "The Grate Gatsby", 2) ==
+          std::vector<std::pair<int, int>>{{1, 2}});
+  REQUIRE(similar(index, "Moby Dick", 2).empty());
+}
+
+TEST_CASE("FuzzyIndex orders by distance and honours k") {
+  FuzzyIndex index;
+  index.add(3, "cart");
+  index.add(1, "cast");
+  index.add(2, "cat");
+  index.add(0, "dog");
+
+  // Short query: scanned by length instead of trigrams
+  REQUIRE(similar(index, "cat", 1) ==
+          std::vector<std::pair<int, int>>{{2, 0}, {1, 1}, {3, 1}});
+  REQUIRE(similar(index, "cat", 1, 2) ==
+          std::vector<std::pair<int, int>>{{2, 0}, {1, 1}});
+  REQUIRE(similar(index, "cat", 0, 5) ==
+          std::vector<std::pair<int, int>>{{2, 0}});
+
+  index.remove(2);
+  REQUIRE(similar(index, "cat", 1) ==
+          std::vector<std::pair<int, int>>{{1, 1}, {3, 1}});
+  index.clear();
+  REQUIRE(index.size() == 0);
+  REQUIRE(similar(index, "cast", 2).empty());
+}
+
+TEST_CASE("FuzzyIndex agrees with a full scan") {
+  FuzzyIndex index;
+  std::vector<std::string> texts;
+  const char *words[] = {"data", "date", "base", "case", "study",
+                         "story", "guide", "glide", "the", "then"};
+  for (int i = 0; i < 300; i++) {
+    std::string t = std::string(words[i % 10]) + " " + words[(i / 10) % 10] +
+                    " " + words[(i * 7) % 10];
+    texts.push_back(t);
+    index.add(i, t);
+  }
+
+  const char *queries[] = {"data base case", "dat bse guide", "story then",
+                           "glide glide the", "xyz"};
+  for (const char *q : queries) {
+    for (int d = 0; d <= 3; d++) {
+      std::vector<std::pair<int, int>> expected;
+      for (int i = 0; i < 300; i++) {
+        int dist = FuzzyIndex::boundedDistance(q, texts[i], d);
+        if (dist <= d)
+          expected.push_back(std::make_pair(i, dist));
+      }
+      std::stable_sort(expected.begin(), expected.end(),
+                       [](const std::pair<int, int> &a,
+                          const std::pair<int, int> &b) {
+                         return a.second < b.second;
+                       });
+      REQUIRE(similar(index, q, d, 1000) == expected);
+    }
+  }
+}
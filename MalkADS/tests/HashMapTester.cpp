@@ -0,0 +1,160 @@
+#include "structures/hash_map.h"
+#include "structures/string_hash.h"
+#include <catch2/catch_all.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <cctype>
+#include <string>
+
+// Case-insensitive functors to exercise the Hash / KeyEqual parameters
+struct CaseInsensitiveHash {
+  size_t operator()(const std::string &key) const {
+    std::string lower = key;
+    for (char &c : lower)
+      c = tolower(c);
+    return FastStringHash{}(lower);
+  }
+};
+
+struct CaseInsensitiveEqual {
+  bool operator()(const std::string &a, const std::string &b) const {
+    if (a.size() != b.size())
+      return false;
+    for (size_t i = 0; i < a.size(); i++)
+      if (tolower(a[i]) != tolower(b[i]))
+        return false;
+    return true;
+  }
+};
+
+TEST_CASE("FastStringHash is deterministic and spreads short IDs") {
+  FastStringHash h;
+  REQUIRE(h("R150B") == h(std::string("R150B")));
+  REQUIRE(h("L004") != h("L005"));
+  REQUIRE(h("") != h("a"));
+
+  // Lengths on both sides of the 3/4/8/16/48 byte code paths
+  std::string s;
+  for (int len = 0; len < 120; len++) {
+    std::string t = s + 'x';
+    REQUIRE(h(s) != h(t));
+    s = t;
+  }
+}
+
+TEST_CASE("HashMap with default hasher survives rehashing") {
+  HashMap<std::string, int> map;
+  for (int i = 0; i < 1000; i++)
+    REQUIRE(map.putNew("L" + std::to_string(i), i));
+  REQUIRE(map.size() == 1000);
+  for (int i = 0; i < 1000; i++) {
+    int *v = map.get("L" + std::to_string(i));
+    REQUIRE(v != nullptr);
+    REQUIRE(*v == i);
+  }
+  REQUIRE(map.get("L1000") == nullptr);
+}
+
+TEST_CASE("HashMap with custom Hash and KeyEqual") {
+  HashMap<std::string, int, CaseInsensitiveHash, CaseInsensitiveEqual> map;
+  REQUIRE(map.putNew("R150B", 1));
+  REQUIRE(map.putNew("r150b", 2) == false);
+  REQUIRE(map.get("r150B") != nullptr);
+  REQUIRE(*map.get("r150B") == 1);
+  REQUIRE(map.erase("R150b"));
+  REQUIRE(map.empty());
+}
+
+TEST_CASE("HashMap stats report occupancy and chains") {
+  HashMap<std::string, int> map;
+  HashMapStats empty = map.stats();
+  REQUIRE(empty.size == 0);
+  REQUIRE(empty.bucketCount == 16);
+  REQUIRE(empty.usedBuckets == 0);
+  REQUIRE(empty.maxChainLength == 0);
+  REQUIRE(empty.chainHistogram[0] == 16);
+
+  for (int i = 0; i < 100; i++)
+    map.putNew("B" + std::to_string(i), i);
+
+  HashMapStats st = map.stats();
+  REQUIRE(st.size == 100);
+  REQUIRE(st.loadFactor <= 0.75f);
+  REQUIRE(st.maxChainLength >= 1);
+  REQUIRE(st.avgChainLength >= 1.0f);
+
+  int buckets = 0, nodes = 0;
+  for (int i = 0; i < HashMapStats::HISTOGRAM_BINS; i++) {
+    buckets += st.chainHistogram[i];
+    if (i < HashMapStats::HISTOGRAM_BINS - 1)
+      nodes += i * st.chainHistogram[i];
+  }
+  REQUIRE(buckets == st.bucketCount);
+  REQUIRE(st.bucketCount - st.chainHistogram[0] == st.usedBuckets);
+  if (st.chainHistogram[HashMapStats::HISTOGRAM_BINS - 1] == 0)
+    REQUIRE(nodes == st.size);
+  REQUIRE(st.bytesUsed > static_cast<size_t>(st.bucketCount) * sizeof(void *));
+}
+
+TEST_CASE("HashMap shrinks after mass deletions") {
+  HashMap<std::string, int> map;
+  for (int i = 0; i < 4096; i++)
+    map.putNew("L" + std::to_string(i), i);
+  const int peak = map.stats().bucketCount;
+  REQUIRE(peak >= 4096 / 0.75f);
+
+  int *survivor = map.get("L7");
+  for (int i = 0; i < 4096; i++)
+    if (i != 7)
+      map.erase("L" + std::to_string(i));
+
+  HashMapStats st = map.stats();
+  REQUIRE(st.size == 1);
+  REQUIRE(st.bucketCount < peak);
+  // Nodes are relinked, never copied, so earlier pointers stay valid
+  REQUIRE(map.get("L7") == survivor);
+  REQUIRE(*survivor == 7);
+
+  map.clear();
+  REQUIRE(map.stats().bucketCount == 16);
+}
+
+TEST_CASE("HashMap shrinkToFit and hysteresis") {
+  HashMap<std::string, int> map;
+  for (int i = 0; i < 1000; i++)
+    map.putNew("R" + std::to_string(i), i);
+  for (int i = 0; i < 700; i++)
+    map.erase("R" + std::to_string(i));
+
+  // erase() only halves below the low-water mark; shrinkToFit goes further
+  const int before = map.stats().bucketCount;
+  map.shrinkToFit();
+  HashMapStats st = map.stats();
+  REQUIRE(st.bucketCount < before);
+  REQUIRE(st.loadFactor <= 0.75f);
+  for (int i = 700; i < 1000; i++)
+    REQUIRE(map.contains("R" + std::to_string(i)));
+
+  // Erase + re-insert around the boundary must not flip-flop the size
+  const int cap = st.bucketCount;
+  for (int round = 0; round < 50; round++) {
+    map.erase("R999");
+    map.putNew("R999", 999);
+  }
+  REQUIRE(map.stats().bucketCount == cap);
+}
+
+TEST_CASE("HashMap reserve sizes the table once") {
+  HashMap<std::string, int> map;
+  map.reserve(3000);
+  const int cap = map.stats().bucketCount;
+  REQUIRE(cap >= 3000 / 0.75f);
+
+  for (int i = 0; i < 3000; i++)
+    map.putNew("B" + std::to_string(i), i);
+  REQUIRE(map.stats().bucketCount == cap);
+
+  // Never shrinks
+  map.reserve(10);
+  REQUIRE(map.stats().bucketCount == cap);
+  REQUIRE(*map.get("B2999") == 2999);
+}
@@ -0,0 +1,75 @@
+#include "structures/linked_list.h"
+#include <catch2/catch_all.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <memory>
+#include <string>
+#include <vector>
+
+TEST_CASE("LinkedList keeps insertion order across blocks") {
+  LinkedList<std::string, 4> list;
+  for (int i = 0; i < 10; i++)
+    list.push_back("t" + std::to_string(i));
+  REQUIRE(list.size() == 10);
+  REQUIRE(list.contains("t9"));
+  REQUIRE_FALSE(list.contains("t10"));
+
+  std::vector<std::string> seen;
+  list.forEach([&](const std::string &s) { seen.push_back(s); });
+  REQUIRE(seen.size() == 10);
+  REQUIRE(seen.front() == "t0");
+  REQUIRE(seen.back() == "t9");
+}
+
+TEST_CASE("LinkedList erase leaves other elements in place") {
+  LinkedList<int, 4> list;
+  std::vector<int *> addresses;
+  for (int i = 0; i < 12; i++)
+    addresses.push_back(&list.emplace_back(i));
+
+  // Empty out the whole middle block plus a few neighbours
+  for (int v : {3, 4, 5, 6, 7, 8})
+    REQUIRE(list.remove(v));
+  REQUIRE_FALSE(list.remove(4));
+  REQUIRE(list.size() == 6);
+
+  // Survivors did not move
+  REQUIRE(*addresses[2] == 2);
+  REQUIRE(*addresses[9] == 9);
+
+  // erase() hands back the next element
+  LinkedList<int, 4>::iterator it = list.begin();
+  ++it;
+  ++it; // 2
+  it = list.erase(it);
+  REQUIRE(*it == 9);
+
+  std::vector<int> left;
+  for (LinkedList<int, 4>::iterator i = list.begin(); i != list.end(); ++i)
+    left.push_back(*i);
+  REQUIRE(left == std::vector<int>{0, 1, 9, 10, 11});
+
+  // Appending after removals still goes to the back
+  list.push_back(12);
+  left.clear();
+  list.forEach([&](int v) { left.push_back(v); });
+  REQUIRE(left.back() == 12);
+}
+
+TEST_CASE("LinkedList holds move-only elements and moves as a whole") {
+  LinkedList<std::unique_ptr<int>> list;
+  for (int i = 0; i < 40; i++)
+    list.push_back(std::unique_ptr<int>(new int(i)));
+
+  LinkedList<std::unique_ptr<int>> moved(std::move(list));
+  REQUIRE(list.empty());
+  REQUIRE(moved.size() == 40);
+
+  int sum = 0;
+  moved.forEach([&](const std::unique_ptr<int> &p) { sum += *p; });
+  REQUIRE(sum == 40 * 39 / 2);
+
+  list = std::move(moved);
+  REQUIRE(list.size() == 40);
+  list.clear();
+  REQUIRE(list.begin() == list.end());
+}
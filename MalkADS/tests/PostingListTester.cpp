@@ -0,0 +1,31 @@
+#include "structures/posting_list.h"
+#include <catch2/catch_all.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <vector>
+
+TEST_CASE("PostingList appends and removes by position") {
+  PostingList list(1);
+  std::vector<int> pos;
+  for (int id = 0; id < 10; id++)
+    pos.push_back(list.append(id * 10));
+  REQUIRE(list.size() == 10);
+  REQUIRE(pos[7] == 7);
+  REQUIRE(list.at(7) == 70);
+
+  // The last ID fills the hole and is reported so its owner can update
+  REQUIRE(list.removeAt(2) == 90);
+  REQUIRE(list.at(2) == 90);
+  REQUIRE(list.size() == 9);
+
+  // Removing the last element moves nothing
+  REQUIRE(list.removeAt(8) == -1);
+  REQUIRE(list.size() == 8);
+  REQUIRE(list.removeAt(8) == -1); // out of range
+
+  int sum = 0;
+  list.forEach([&](int id) { sum += id; });
+  REQUIRE(sum == 0 + 10 + 90 + 30 + 40 + 50 + 60 + 70);
+
+  list.clear();
+  REQUIRE(list.empty());
+}
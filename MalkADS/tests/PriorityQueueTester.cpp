@@ -0,0 +1,187 @@
+#include "structures/indexed_priority_queue.h"
+#include "structures/priority_queue.h"
+#include <catch2/catch_all.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+#include <vector>
+
+namespace {
+// Counts copies so the tests can check that the heap only moves elements
+struct Tracked {
+  static int copies;
+  int key;
+  std::string payload;
+  Tracked() : key(0) {}
+  Tracked(int k, const std::string &p) : key(k), payload(p) {}
+  Tracked(const Tracked &o) : key(o.key), payload(o.payload) { copies++; }
+  Tracked(Tracked &&o) : key(o.key), payload(std::move(o.payload)) {}
+  Tracked &operator=(const Tracked &o) {
+    key = o.key;
+    payload = o.payload;
+    copies++;
+    return *this;
+  }
+  Tracked &operator=(Tracked &&o) {
+    key = o.key;
+    payload = std::move(o.payload);
+    return *this;
+  }
+  bool operator<(const Tracked &o) const { return key < o.key; }
+};
+int Tracked::copies = 0;
+
+// No default constructor: the heap must not construct unused capacity
+struct NoDefault {
+  explicit NoDefault(int v) : value(v) {}
+  int value;
+  bool operator<(const NoDefault &o) const { return value < o.value; }
+};
+} // namespace
+
+TEST_CASE("PriorityQueue pops in priority order for any arity") {
+  PriorityQueue<int, DefaultComparator<int>, 2> binary(1);
+  PriorityQueue<int> quaternary(1);
+  PriorityQueue<int, DefaultComparator<int>, 8> octal(1);
+  srand(7);
+  std::vector<int> values;
+  for (int i = 0; i < 2000; i++) {
+    int v = rand() % 500;
+    values.push_back(v);
+    binary.push(v);
+    quaternary.push(v);
+    octal.push(v);
+  }
+  std::sort(values.begin(), values.end());
+  for (int v : values) {
+    REQUIRE(binary.top() == v);
+    REQUIRE(quaternary.top() == v);
+    REQUIRE(octal.top() == v);
+    REQUIRE(binary.pop() == v);
+    REQUIRE(quaternary.pop() == v);
+    REQUIRE(octal.pop() == v);
+  }
+  REQUIRE(quaternary.isEmpty());
+}
+
+TEST_CASE("PriorityQueue heapifies a range") {
+  std::vector<int> values;
+  for (int i = 0; i < 1000; i++)
+    values.push_back((i * 7919) % 1000);
+  PriorityQueue<int> pq(values.begin(), values.end());
+  REQUIRE(pq.size() == 1000);
+  for (int i = 0; i < 1000; i++)
+    REQUIRE(pq.pop() == i);
+
+  const int more[] = {4, 2, 9};
+  pq.assign(more, more + 3);
+  REQUIRE(pq.size() == 3);
+  REQUIRE(pq.top() == 2);
+}
+
+TEST_CASE("PriorityQueue moves instead of copying") {
+  PriorityQueue<Tracked> pq;
+  pq.reserve(64);
+  Tracked::copies = 0;
+  for (int i = 100; i > 0; i--)
+    pq.emplace(i, "request-" + std::to_string(i));
+  pq.push(Tracked(0, "first"));
+  REQUIRE(Tracked::copies == 0);
+
+  Tracked t = pq.pop();
+  REQUIRE(t.key == 0);
+  REQUIRE(t.payload == "first");
+  for (int i = 1; i <= 100; i++)
+    REQUIRE(pq.pop().payload == "request-" + std::to_string(i));
+  REQUIRE(Tracked::copies == 0);
+}
+
+TEST_CASE("PriorityQueue works without a default constructor") {
+  PriorityQueue<NoDefault> pq(100);
+  pq.emplace(3);
+  pq.emplace(1);
+  pq.push(NoDefault(2));
+  REQUIRE(pq.top().value == 1);
+  REQUIRE(pq.pop().value == 1);
+  pq.clear();
+  REQUIRE(pq.isEmpty());
+}
+
+TEST_CASE("IndexedPriorityQueue pops in priority order") {
+  IndexedPriorityQueue<int> pq(2);
+  const int values[] = {5, 3, 8, 1, 9, 2};
+  for (int v : values)
+    pq.push(v);
+
+  REQUIRE(pq.size() == 6);
+  const int expected[] = {1, 2, 3, 5, 8, 9};
+  for (int v : expected) {
+    REQUIRE(pq.top() == v);
+    pq.pop();
+  }
+  REQUIRE(pq.isEmpty());
+}
+
+TEST_CASE("IndexedPriorityQueue update and erase by handle") {
+  IndexedPriorityQueue<int> pq;
+  int h10 = pq.push(10);
+  int h20 = pq.push(20);
+  int h30 = pq.push(30);
+
+  // decrease-key moves an element to the top
+  REQUIRE(pq.update(h30, 5));
+  REQUIRE(pq.topHandle() == h30);
+  REQUIRE(pq.top() == 5);
+
+  // increase-key moves it back down
+  REQUIRE(pq.update(h30, 25));
+  REQUIRE(pq.top() == 10);
+
+  REQUIRE(pq.erase(h10));
+  REQUIRE_FALSE(pq.contains(h10));
+  REQUIRE_FALSE(pq.erase(h10));
+  REQUIRE(pq.top() == 20);
+  REQUIRE(pq.get(h20) == 20);
+  REQUIRE(pq.size() == 2);
+}
+
+TEST_CASE("IndexedPriorityQueue matches a brute-force model") {
+  IndexedPriorityQueue<int> pq;
+  std::vector<int> handles;
+  std::vector<int> model; // value per handle, -1 if removed
+  srand(42);
+
+  for (int step = 0; step < 5000; step++) {
+    int op = rand() % 4;
+    if (op == 0 || handles.empty()) {
+      int v = rand() % 1000;
+      int h = pq.push(v);
+      if (h >= static_cast<int>(model.size()))
+        model.resize(h + 1, -1);
+      model[h] = v;
+      handles.push_back(h);
+    } else {
+      int idx = rand() % handles.size();
+      int h = handles[idx];
+      if (op == 1) {
+        int v = rand() % 1000;
+        REQUIRE(pq.update(h, v));
+        model[h] = v;
+      } else {
+        REQUIRE(pq.erase(h));
+        model[h] = -1;
+        handles.erase(handles.begin() + idx);
+      }
+    }
+
+    if (!pq.isEmpty()) {
+      int best = 1 << 30;
+      for (int h : handles)
+        if (model[h] < best)
+          best = model[h];
+      REQUIRE(pq.top() == best);
+    }
+    REQUIRE(pq.size() == static_cast<int>(handles.size()));
+  }
+}
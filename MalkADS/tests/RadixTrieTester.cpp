@@ -0,0 +1,129 @@
+#include "structures/radix_trie.h"
+#include <catch2/catch_all.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <map>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+namespace {
+
+std::vector<std::string> complete(const RadixTrie &trie,
+                                  const std::string &prefix, int n = 10) {
+  std::vector<std::string> out;
+  trie.complete(prefix, n, [&](const std::string &text, int) {
+    out.push_back(text);
+  });
+  return out;
+}
+
+} // namespace
+
+TEST_CASE("RadixTrie completes prefixes alphabetically") {
+  RadixTrie trie;
+  trie.insert("romeo", "Romeo");
+  trie.insert("romanus", "Romanus");
+  trie.insert("rubens", "Rubens");
+  trie.insert("rom", "Rom");
+  REQUIRE(trie.size() == 4);
+
+  REQUIRE(complete(trie, "r") ==
+          std::vector<std::string>{"Rom", "Romanus", "Romeo", "Rubens"});
+  // Prefix ending inside a compressed edge
+  REQUIRE(complete(trie, "roma") == std::vector<std::string>{"Romanus"});
+  REQUIRE(complete(trie, "rome") == std::vector<std::string>{"Romeo"});
+  REQUIRE(complete(trie, "rub") == std::vector<std::string>{"Rubens"});
+  REQUIRE(complete(trie, "rx").empty());
+  REQUIRE(complete(trie, "romeos").empty());
+  REQUIRE(complete(trie, "r", 2) == std::vector<std::string>{"Rom", "Romanus"});
+  REQUIRE(complete(trie, "").size() == 4);
+}
+
+TEST_CASE("RadixTrie ranks heavier keys first") {
+  RadixTrie trie;
+  trie.insert("beta", "Beta");
+  trie.insert("bravo", "Bravo");
+  trie.insert("bravo", "Bravo");
+  REQUIRE(trie.weight("bravo") == 2);
+  REQUIRE(trie.size() == 2);
+  REQUIRE(complete(trie, "b") == std::vector<std::string>{"Bravo", "Beta"});
+
+  REQUIRE(trie.remove("bravo"));
+  REQUIRE(trie.weight("bravo") == 1);
+  REQUIRE(complete(trie, "b") == std::vector<std::string>{"Beta", "Bravo"});
+}
+
+TEST_CASE("RadixTrie removal keeps lists and structure consistent") {
+  RadixTrie trie;
+  trie.insert("test", "test");
+  trie.insert("team", "team");
+  trie.insert("toast", "toast");
+
+  REQUIRE_FALSE(trie.remove("te"));
+  REQUIRE_FALSE(trie.remove("tests"));
+  REQUIRE(trie.remove("team"));
+  REQUIRE_FALSE(trie.remove("team"));
+  REQUIRE(complete(trie, "te") == std::vector<std::string>{"test"});
+  REQUIRE(complete(trie, "t") == std::vector<std::string>{"test", "toast"});
+
+  // Re-inserting after the edges were merged back
+  trie.insert("tea", "tea");
+  REQUIRE(complete(trie, "te") == std::vector<std::string>{"tea", "test"});
+
+  REQUIRE(trie.remove("test"));
+  REQUIRE(trie.remove("toast"));
+  REQUIRE(trie.remove("tea"));
+  REQUIRE(trie.size() == 0);
+  REQUIRE(complete(trie, "t").empty());
+}
+
+TEST_CASE("RadixTrie keeps only the best topN per node") {
+  RadixTrie trie(3);
+  const char *words[] = {"kilo", "kappa", "karma", "kayak", "kebab", "kiwi"};
+  for (const char *w : words)
+    trie.insert(w, w);
+  REQUIRE(trie.capacity() == 3);
+  REQUIRE(complete(trie, "k", 10) ==
+          std::vector<std::string>{"kappa", "karma", "kayak"});
+
+  // Removing a listed key pulls the next best up from below
+  trie.remove("karma");
+  REQUIRE(complete(trie, "k") ==
+          std::vector<std::string>{"kappa", "kayak", "kebab"});
+  REQUIRE(complete(trie, "ki") == std::vector<std::string>{"kilo", "kiwi"});
+}
+
+TEST_CASE("RadixTrie matches a brute-force ranking under random updates") {
+  RadixTrie trie(4);
+  std::map<std::string, int> weights;
+  std::mt19937 rng(7);
+  const char *letters = "abc";
+  for (int step = 0; step < 3000; step++) {
+    std::string key;
+    int len = 1 + rng() % 4;
+    for (int i = 0; i < len; i++)
+      key += letters[rng() % 3];
+    if (rng() % 3 == 0) {
+      REQUIRE(trie.remove(key) == (weights[key] > 0));
+      if (weights[key] > 0)
+        weights[key]--;
+    } else {
+      trie.insert(key, key);
+      weights[key]++;
+    }
+
+    const std::string prefix = key.substr(0, 1 + rng() % key.size());
+    std::vector<std::pair<int, std::string>> ranked;
+    for (const auto &entry : weights)
+      if (entry.second > 0 &&
+          entry.first.compare(0, prefix.size(), prefix) == 0)
+        ranked.push_back(std::make_pair(-entry.second, entry.first));
+    std::sort(ranked.begin(), ranked.end());
+    std::vector<std::string> expected;
+    for (size_t i = 0; i < ranked.size() && i < 4; i++)
+      expected.push_back(ranked[i].second);
+    REQUIRE(complete(trie, prefix) == expected);
+  }
+}
@@ -0,0 +1,144 @@
+#include "structures/ring_buffer.h"
+#include <catch2/catch_all.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+TEST_CASE("SpscRingBuffer is a bounded FIFO") {
+  SpscRingBuffer<std::string> ring(3); // rounded up to 4
+  REQUIRE(ring.capacity() == 4);
+  REQUIRE(ring.isEmpty());
+
+  REQUIRE(ring.tryPush("a"));
+  REQUIRE(ring.tryEmplace(2, 'b'));
+  const std::string batch[] = {"c", "d", "e"};
+  REQUIRE(ring.tryPushBatch(batch, 3) == 2); // only two slots left
+  REQUIRE_FALSE(ring.tryPush("f"));
+  REQUIRE(ring.sizeApprox() == 4);
+
+  std::string out;
+  REQUIRE(ring.tryPop(out));
+  REQUIRE(out == "a");
+  std::string many[8];
+  REQUIRE(ring.tryPopBatch(many, 8) == 3);
+  REQUIRE(many[0] == "bb");
+  REQUIRE(many[2] == "d");
+  REQUIRE_FALSE(ring.tryPop(out));
+
+  // Wraps around without reallocating
+  for (int i = 0; i < 10; i++) {
+    REQUIRE(ring.tryPush(std::to_string(i)));
+    REQUIRE(ring.tryPop(out));
+    REQUIRE(out == std::to_string(i));
+  }
+}
+
+TEST_CASE("MpscRingBuffer batches never exceed the free room") {
+  MpscRingBuffer<int> ring(4);
+  const int items[] = {1, 2, 3, 4, 5, 6};
+  REQUIRE(ring.tryPush(0));
+  REQUIRE(ring.tryPushBatch(items, 6) == 3);
+  REQUIRE(ring.tryPushBatch(items, 6) == 0);
+  REQUIRE_FALSE(ring.tryPush(9));
+
+  int out[8];
+  REQUIRE(ring.tryPopBatch(out, 8) == 4);
+  REQUIRE(out[0] == 0);
+  REQUIRE(out[3] == 3);
+  REQUIRE(ring.isEmpty());
+}
+
+TEST_CASE("Ring buffers destroy elements left in them") {
+  std::shared_ptr<int> tracker = std::make_shared<int>(0);
+  {
+    SpscRingBuffer<std::shared_ptr<int>> spsc(4);
+    MpscRingBuffer<std::shared_ptr<int>> mpsc(4);
+    spsc.tryPush(tracker);
+    mpsc.tryPush(tracker);
+    mpsc.tryPush(tracker);
+    REQUIRE(tracker.use_count() == 4);
+  }
+  REQUIRE(tracker.use_count() == 1);
+}
+
+TEST_CASE("SpscRingBuffer hands items across threads in order") {
+  SpscRingBuffer<int> ring(64);
+  const int total = 200000;
+
+  std::thread producer([&] {
+    int batch[16];
+    int next = 0;
+    while (next < total) {
+      int n = 0;
+      while (n < 16 && next + n < total) {
+        batch[n] = next + n;
+        n++;
+      }
+      next += ring.tryPushBatch(batch, n);
+    }
+  });
+
+  int expected = 0;
+  int buffer[32];
+  bool inOrder = true;
+  while (expected < total) {
+    int n = ring.tryPopBatch(buffer, 32);
+    for (int i = 0; i < n; i++)
+      if (buffer[i] != expected++)
+        inOrder = false;
+  }
+  producer.join();
+  REQUIRE(inOrder);
+  REQUIRE(ring.isEmpty());
+}
+
+TEST_CASE("MpscRingBuffer keeps each producer's items in order") {
+  MpscRingBuffer<long long> ring(128);
+  const int producers = 4;
+  const int perProducer = 50000;
+
+  std::vector<std::thread> threads;
+  for (int p = 0; p < producers; p++) {
+    threads.push_back(std::thread([&ring, p, perProducer] {
+      long long batch[8];
+      int next = 0;
+      while (next < perProducer) {
+        if (next % 3 == 0) {
+          // Single pushes mixed with batches
+          if (ring.tryPush(static_cast<long long>(p) * perProducer + next))
+            next++;
+          continue;
+        }
+        int n = 0;
+        while (n < 8 && next + n < perProducer) {
+          batch[n] = static_cast<long long>(p) * perProducer + next + n;
+          n++;
+        }
+        next += ring.tryPushBatch(batch, n);
+      }
+    }));
+  }
+
+  std::vector<int> nextExpected(producers, 0);
+  bool inOrder = true;
+  int received = 0;
+  long long buffer[64];
+  while (received < producers * perProducer) {
+    int n = ring.tryPopBatch(buffer, 64);
+    for (int i = 0; i < n; i++) {
+      int p = static_cast<int>(buffer[i] / perProducer);
+      int seq = static_cast<int>(buffer[i] % perProducer);
+      if (seq != nextExpected[p]++)
+        inOrder = false;
+    }
+    received += n;
+  }
+  for (std::thread &t : threads)
+    t.join();
+
+  REQUIRE(inOrder);
+  long long leftover;
+  REQUIRE_FALSE(ring.tryPop(leftover));
+}
@@ -57,9 +57,13 @@
 #include "managers/UsersManager.h"
 #include "models/user.h"
 #include "structures/IntervalTreeComplete.h"
+#include "ScopedDataDir.h"
 #include <catch2/catch_all.hpp>
 #include <catch2/catch_test_macros.hpp>
 #include <ctime>
+#include <set>
+#include <string>
+#include <vector>
 
 // Helper to get valid future timestamps
 void getFutureInterval(int &start, int &end, int duration = 3600) {
@@ -149,3 +153,345 @@ TEST_CASE("Booking conflict for mock user") {
   int end2 = start2 + 1800;
   REQUIRE(roomsManager.bookRoomDirect(&mockUser, "R003", start2, end2) == true);
 }
+
+TEST_CASE("RoomsManager reports the most booked rooms") {
+  // The reload below must see this test's bookings and nothing else
+  ScopedDataDir dataDir;
+  REQUIRE(dataDir.ok());
+  int start, end;
+  getFutureInterval(start, end, 1800);
+
+  {
+    RoomsManager roomsManager;
+    User a("demand_a", "password");
+    User b("demand_b", "password");
+    User c("demand_c", "password");
+
+    REQUIRE(roomsManager.addRoomDirect("R010") == true);
+    REQUIRE(roomsManager.addRoomDirect("R011") == true);
+    REQUIRE(roomsManager.bookRoomDirect(&a, "R010", start, end) == true);
+    REQUIRE(roomsManager.bookRoomDirect(&b, "R010", end, end + 1800) == true);
+    REQUIRE(roomsManager.bookRoomDirect(&c, "R010", end + 1800, end + 3600) ==
+            true);
+    REQUIRE(roomsManager.bookRoomDirect(&c, "R011", start, end) == true);
+
+    std::string topId;
+    int topCount = 0;
+    REQUIRE(roomsManager.topDemanded(1, start, end + 3600,
+                                     [&](const std::string &id, int count) {
+                                       topId = id;
+                                       topCount = count;
+                                     }) == 1);
+    REQUIRE(topId == "R010");
+    REQUIRE(topCount == 3);
+  }
+
+  // Counters are rebuilt from the saved bookings
+  RoomsManager reloaded;
+  int r010 = 0;
+  reloaded.topDemanded(100, start, end + 3600,
+                       [&](const std::string &id, int count) {
+                         if (id == "R010")
+                           r010 = count;
+                       });
+  REQUIRE(r010 == 3);
+}
+
+TEST_CASE("Free gaps cover every booking of a busy room") {
+  int start, end;
+  getFutureInterval(start, end, 300);
+  RoomsManager roomsManager;
+  User user("gap_user", "password");
+  REQUIRE(roomsManager.addRoomDirect("R020") == true);
+
+  // 100 five-minute bookings a minute apart: more than any fixed buffer
+  const int BOOKINGS = 100;
+  for (int i = 0; i < BOOKINGS; i++)
+    REQUIRE(roomsManager.bookRoomDirect(&user, "R020", start + i * 360,
+                                        start + i * 360 + 300) == true);
+  const int lastEnd = start + (BOOKINGS - 1) * 360 + 300;
+
+  std::vector<std::pair<int, int>> gaps;
+  auto collect = [&](int gapStart, int gapEnd) {
+    gaps.push_back(std::make_pair(gapStart, gapEnd));
+  };
+
+  REQUIRE(roomsManager.forEachFreeGap("R020", start - 600, lastEnd + 600,
+                                      collect));
+  REQUIRE(gaps.size() == BOOKINGS + 1);
+  REQUIRE(gaps.front() == std::make_pair(start - 600, start));
+  for (int i = 1; i < BOOKINGS; i++)
+    REQUIRE(gaps[i] == std::make_pair(start + i * 360 - 60, start + i * 360));
+  REQUIRE(gaps.back() == std::make_pair(lastEnd, lastEnd + 600));
+
+  // A window inside the bookings is clipped to it
+  gaps.clear();
+  roomsManager.forEachFreeGap("R020", start + 100, start + 700, collect);
+  REQUIRE(gaps == std::vector<std::pair<int, int>>{
+                      std::make_pair(start + 300, start + 360),
+                      std::make_pair(start + 660, start + 700)});
+
+  // Back-to-back bookings leave no gap between them
+  User other("gap_other", "password");
+  REQUIRE(roomsManager.bookRoomDirect(&other, "R020", start + 300,
+                                      start + 360) == true);
+  gaps.clear();
+  roomsManager.forEachFreeGap("R020", start, start + 720, collect);
+  REQUIRE(gaps == std::vector<std::pair<int, int>>{
+                      std::make_pair(start + 660, start + 720)});
+
+  REQUIRE(roomsManager.forEachFreeGap("R999", start, end, collect) == false);
+  REQUIRE(roomsManager.removeRoomDirect("R020") == true);
+}
+
+TEST_CASE("Free-room queries and booking any free room") {
+  // bookAnyRoom picks from every room, so only this test's may exist
+  ScopedDataDir dataDir;
+  REQUIRE(dataDir.ok());
+  int start, end;
+  getFutureInterval(start, end, 1800);
+  RoomsManager roomsManager;
+  User a("any_room_a", "password");
+  User b("any_room_b", "password");
+  User c("any_room_c", "password");
+  for (const char *id : {"R030", "R031", "R032"})
+    REQUIRE(roomsManager.addRoomDirect(id) == true);
+
+  auto freeRooms = [&](int from, int to) {
+    std::vector<std::string> rooms;
+    roomsManager.findFreeRooms(from, to, 0, [&](const std::string &id) {
+      rooms.push_back(id);
+    });
+    return rooms;
+  };
+
+  REQUIRE(freeRooms(start, end) ==
+          std::vector<std::string>{"R030", "R031", "R032"});
+
+  // A booking that only touches the edge of a quarter hour still leaves
+  // the room free for the rest of it
+  REQUIRE(roomsManager.bookRoomDirect(&a, "R031", start + 60, start + 120));
+  REQUIRE(freeRooms(start, end) == std::vector<std::string>{"R030", "R032"});
+  REQUIRE(freeRooms(start + 120, start + 180) ==
+          std::vector<std::string>{"R030", "R031", "R032"});
+
+  // bookAnyRoom takes the first free room, skipping busy ones
+  std::string booked;
+  REQUIRE(roomsManager.bookRoomDirect(&b, "R030", start, end));
+  int found = 0;
+  roomsManager.findFreeRooms(start, end, 1, [&](const std::string &id) {
+    found++;
+    REQUIRE(id != "R030");
+    REQUIRE(id != "R031");
+  });
+  REQUIRE(found == 1);
+  REQUIRE(roomsManager.bookAnyRoom(&c, start, end, &booked));
+  REQUIRE(freeRooms(start, end).empty());
+  REQUIRE(booked == "R032");
+
+  // The user already has a room then
+  REQUIRE_FALSE(roomsManager.bookAnyRoom(&c, start, end, &booked));
+
+  // Cancelling frees the room again; only the booking's owner can cancel
+  REQUIRE_FALSE(
+      roomsManager.cancelRoomBookingDirect(&a, "R030", start, end));
+  REQUIRE(roomsManager.cancelRoomBookingDirect(&b, "R030", start, end));
+  REQUIRE_FALSE(
+      roomsManager.cancelRoomBookingDirect(&b, "R030", start, end));
+  REQUIRE(freeRooms(start, end) == std::vector<std::string>{"R030"});
+  REQUIRE(roomsManager.bookRoomDirect(&b, "R030", start, end));
+
+  // Removed rooms are never offered, and their numbers are reused
+  REQUIRE(roomsManager.removeRoomDirect("R030"));
+  REQUIRE(roomsManager.addRoomDirect("R033"));
+  REQUIRE(freeRooms(start, end) == std::vector<std::string>{"R033"});
+
+  for (const char *id : {"R031", "R032", "R033"})
+    REQUIRE(roomsManager.removeRoomDirect(id));
+}
+
+TEST_CASE("Free-room index agrees with the interval trees") {
+  ScopedDataDir dataDir;
+  REQUIRE(dataDir.ok());
+  int start, end;
+  getFutureInterval(start, end, 0);
+  RoomsManager roomsManager;
+  const int ROOMS = 70; // more than one word of rooms
+  std::vector<std::string> ids;
+  for (int r = 0; r < ROOMS; r++) {
+    ids.push_back("RX" + std::to_string(r));
+    REQUIRE(roomsManager.addRoomDirect(ids.back()));
+  }
+
+  // Random bookings over the next ten hours, some of them cancelled
+  srand(2049);
+  std::vector<User> users;
+  for (int i = 0; i < 300; i++)
+    users.push_back(User("index_user" + std::to_string(i), "password"));
+  struct Booking {
+    int user, room, start, end;
+  };
+  std::vector<Booking> made;
+  for (int i = 0; i < 300; i++) {
+    int s = start + rand() % (10 * 3600);
+    int e = s + 60 + rand() % 7200;
+    int r = rand() % ROOMS;
+    if (roomsManager.bookRoomDirect(&users[i], ids[r], s, e))
+      made.push_back(Booking{i, r, s, e});
+  }
+  for (size_t i = 0; i < made.size(); i += 3)
+    REQUIRE(roomsManager.cancelRoomBookingDirect(
+        &users[made[i].user], ids[made[i].room], made[i].start, made[i].end));
+
+  for (int q = 0; q < 200; q++) {
+    int s = start + rand() % (11 * 3600);
+    int e = s + 1 + rand() % 10800;
+    std::set<std::string> expected;
+    for (int r = 0; r < ROOMS; r++) {
+      bool busy = false;
+      roomsManager.getRoomBookings(ids[r],
+                                   [&](int low, int high, const std::string &) {
+                                     if (low < e && s < high)
+                                       busy = true;
+                                   });
+      if (!busy)
+        expected.insert(ids[r]);
+    }
+    std::set<std::string> got;
+    roomsManager.findFreeRooms(s, e, 0, [&](const std::string &id) {
+      got.insert(id);
+    });
+    REQUIRE(got == expected);
+  }
+
+  // Past tomorrow the trees are asked directly
+  int later = start + 4 * 24 * 3600;
+  int freeLater = 0;
+  roomsManager.findFreeRooms(later, later + 3600, 0,
+                             [&](const std::string &) { freeLater++; });
+  REQUIRE(freeLater == ROOMS);
+
+  for (const std::string &id : ids)
+    REQUIRE(roomsManager.removeRoomDirect(id));
+}
+
+TEST_CASE("Room attributes parse and format like rooms.txt") {
+  RoomAttributes room;
+  REQUIRE(RoomAttributes::parse("8,2,Projector|whiteboard", room));
+  REQUIRE(room.capacity == 8);
+  REQUIRE(room.floor == 2);
+  REQUIRE(room.equipment ==
+          (RoomAttributes::PROJECTOR | RoomAttributes::WHITEBOARD));
+  REQUIRE(room.format() == "8,2,projector|whiteboard");
+
+  // Trailing fields may be left out; bare IDs know nothing
+  REQUIRE(RoomAttributes::parse("4", room));
+  REQUIRE(room.capacity == 4);
+  REQUIRE(room.floor == RoomAttributes::UNKNOWN_FLOOR);
+  REQUIRE(room.format() == "4,");
+  REQUIRE(RoomAttributes::parse(",0,screen", room));
+  REQUIRE(room.format() == ",0,screen");
+  REQUIRE(RoomAttributes::parse("", room));
+  REQUIRE_FALSE(room.isKnown());
+
+  REQUIRE_FALSE(RoomAttributes::parse("eight", room));
+  REQUIRE_FALSE(RoomAttributes::parse("8,2,jacuzzi", room));
+  REQUIRE_FALSE(RoomAttributes::parse("8,2,screen,extra", room));
+
+  // Basements are floors below 0; values that do not fit an int, or that
+  // would read back as unknown, are malformed rather than truncated
+  REQUIRE(RoomAttributes::parse("6,-1", room));
+  REQUIRE(room.floor == -1);
+  REQUIRE(room.format() == "6,-1");
+  REQUIRE_FALSE(RoomAttributes::parse("6,4294967298", room));
+  REQUIRE_FALSE(RoomAttributes::parse("99999999999", room));
+  REQUIRE_FALSE(RoomAttributes::parse("6,-2147483648", room));
+  REQUIRE(room.floor == -1);
+}
+
+TEST_CASE("Free rooms filtered by capacity, floor and equipment") {
+  // Only this test's rooms, saved and reloaded in a directory of its own
+  ScopedDataDir dataDir;
+  REQUIRE(dataDir.ok());
+  int start, end;
+  getFutureInterval(start, end, 1800);
+  const unsigned PROJECTOR = RoomAttributes::PROJECTOR;
+  const unsigned WHITEBOARD = RoomAttributes::WHITEBOARD;
+  const int ANY_FLOOR = RoomAttributes::UNKNOWN_FLOOR;
+
+  {
+    RoomsManager roomsManager;
+    REQUIRE(roomsManager.addRoomDirect(
+        "RA1", RoomAttributes(4, 1, WHITEBOARD)));
+    REQUIRE(roomsManager.addRoomDirect(
+        "RA2", RoomAttributes(8, 1, PROJECTOR | WHITEBOARD)));
+    REQUIRE(roomsManager.addRoomDirect("RA3", RoomAttributes(12, 2,
+                                                             PROJECTOR)));
+    REQUIRE(roomsManager.addRoomDirect("RA4"));
+
+    auto freeRooms = [&](const RoomAttributes &need) {
+      std::vector<std::string> rooms;
+      roomsManager.findFreeRooms(
+          start, end, need, 0,
+          [&](const std::string &id) { rooms.push_back(id); });
+      return rooms;
+    };
+
+    REQUIRE(freeRooms(RoomAttributes()) ==
+            std::vector<std::string>{"RA1", "RA2", "RA3", "RA4"});
+    REQUIRE(freeRooms(RoomAttributes(8, ANY_FLOOR, PROJECTOR)) ==
+            std::vector<std::string>{"RA2", "RA3"});
+    REQUIRE(freeRooms(RoomAttributes(9, ANY_FLOOR, 0)) ==
+            std::vector<std::string>{"RA3"});
+    REQUIRE(freeRooms(RoomAttributes(0, 1, WHITEBOARD)) ==
+            std::vector<std::string>{"RA1", "RA2"});
+    REQUIRE(freeRooms(RoomAttributes(0, 5, 0)).empty());
+
+    // Booked rooms drop out; bookAnyRoom honours the filter
+    User a("attr_a", "password");
+    User b("attr_b", "password");
+    REQUIRE(roomsManager.bookRoomDirect(&a, "RA2", start, end));
+    REQUIRE(freeRooms(RoomAttributes(8, ANY_FLOOR, PROJECTOR)) ==
+            std::vector<std::string>{"RA3"});
+    std::string booked;
+    REQUIRE(roomsManager.bookAnyRoom(&b, start, end, &booked,
+                                     RoomAttributes(0, ANY_FLOOR, PROJECTOR)));
+    REQUIRE(booked == "RA3");
+    REQUIRE(freeRooms(RoomAttributes(0, ANY_FLOOR, PROJECTOR)).empty());
+
+    // Attributes can change after the room is added
+    REQUIRE(roomsManager.setRoomAttributes("RA4",
+                                           RoomAttributes(20, 3, PROJECTOR)));
+    REQUIRE(freeRooms(RoomAttributes(0, ANY_FLOOR, PROJECTOR)) ==
+            std::vector<std::string>{"RA4"});
+    REQUIRE_FALSE(
+        roomsManager.setRoomAttributes("RA9", RoomAttributes(1, 1, 0)));
+
+    // Any floor is fine: basements and ones far beyond the rest
+    REQUIRE(roomsManager.setRoomAttributes("RA1",
+                                           RoomAttributes(4, -2, WHITEBOARD)));
+    REQUIRE(roomsManager.setRoomAttributes(
+        "RA4", RoomAttributes(20, 1000000000, PROJECTOR)));
+    REQUIRE(freeRooms(RoomAttributes(0, -2, 0)) ==
+            std::vector<std::string>{"RA1"});
+    REQUIRE(freeRooms(RoomAttributes(0, 1000000000, 0)) ==
+            std::vector<std::string>{"RA4"});
+    REQUIRE(freeRooms(RoomAttributes(0, 1, 0)).empty());
+  }
+
+  // Attributes are saved with the IDs and loaded back
+  RoomsManager reloaded;
+  RoomAttributes room;
+  REQUIRE(reloaded.getRoomAttributes("RA2", room));
+  REQUIRE(room.capacity == 8);
+  REQUIRE(room.floor == 1);
+  REQUIRE(room.equipment == (PROJECTOR | WHITEBOARD));
+  REQUIRE(reloaded.getRoomAttributes("RA4", room));
+  REQUIRE(room.capacity == 20);
+  REQUIRE(room.floor == 1000000000);
+  REQUIRE(reloaded.getRoomAttributes("RA1", room));
+  REQUIRE(room.floor == -2);
+  REQUIRE_FALSE(reloaded.getRoomAttributes("RA9", room));
+  for (const char *id : {"RA1", "RA2", "RA3", "RA4"})
+    REQUIRE(reloaded.removeRoomDirect(id));
+}
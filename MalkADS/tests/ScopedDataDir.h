@@ -0,0 +1,134 @@
+#ifndef SCOPED_DATA_DIR_H
+#define SCOPED_DATA_DIR_H
+
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <string>
+
+#ifdef _WIN32
+#include <direct.h>
+#include <io.h>
+#include <process.h>
+#else
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+// The managers load and save data/*.txt relative to the working directory.
+// For the life of a ScopedDataDir the test runs in a fresh temporary
+// directory with an empty data/ in it, so it neither sees the shipped data
+// nor leaves anything behind; the old working directory is then restored
+// and the temporary one removed.
+class ScopedDataDir {
+private:
+  std::string previous;
+  std::string dir;
+
+#ifdef _WIN32
+  static bool makeDir(const std::string &path) {
+    return _mkdir(path.c_str()) == 0;
+  }
+  static bool changeDir(const std::string &path) {
+    return _chdir(path.c_str()) == 0;
+  }
+  static void removeDir(const std::string &path) { _rmdir(path.c_str()); }
+  static std::string currentDir() {
+    char cwd[4096];
+    return _getcwd(cwd, sizeof(cwd)) ? cwd : "";
+  }
+  static int processId() { return _getpid(); }
+
+  static void removeFilesIn(const std::string &path) {
+    _finddata_t entry;
+    intptr_t handle = _findfirst((path + "\\*").c_str(), &entry);
+    if (handle == -1)
+      return;
+    do {
+      if (!(entry.attrib & _A_SUBDIR))
+        remove((path + "\\" + entry.name).c_str());
+    } while (_findnext(handle, &entry) == 0);
+    _findclose(handle);
+  }
+#else
+  static bool makeDir(const std::string &path) {
+    return mkdir(path.c_str(), 0755) == 0;
+  }
+  static bool changeDir(const std::string &path) {
+    return chdir(path.c_str()) == 0;
+  }
+  static void removeDir(const std::string &path) { rmdir(path.c_str()); }
+  static std::string currentDir() {
+    char cwd[4096];
+    return getcwd(cwd, sizeof(cwd)) ? cwd : "";
+  }
+  static int processId() { return static_cast<int>(getpid()); }
+
+  static void removeFilesIn(const std::string &path) {
+    DIR *d = opendir(path.c_str());
+    if (!d)
+      return;
+    while (dirent *entry = readdir(d)) {
+      std::string name = entry->d_name;
+      if (name != "." && name != "..")
+        remove((path + "/" + name).c_str());
+    }
+    closedir(d);
+  }
+#endif
+
+  static std::string tempRoot() {
+    const char *names[] = {"TMPDIR", "TEMP", "TMP"};
+    for (const char *name : names) {
+      const char *value = getenv(name);
+      if (value && *value)
+        return value;
+    }
+#ifdef _WIN32
+    return ".";
+#else
+    return "/tmp";
+#endif
+  }
+
+public:
+  ScopedDataDir() {
+    previous = currentDir();
+    // makeDir fails if the name is taken, so a new name is tried until one
+    // is free
+    static int created = 0;
+    const std::string root = tempRoot();
+    for (int attempt = 0; attempt < 100 && dir.empty(); attempt++) {
+      std::string candidate =
+          root + "/malkads_test_" + std::to_string(processId()) + "_" +
+          std::to_string(static_cast<long long>(time(nullptr))) + "_" +
+          std::to_string(created++);
+      if (makeDir(candidate))
+        dir = candidate;
+    }
+    if (dir.empty() || !changeDir(dir) || !makeDir("data")) {
+      if (!dir.empty()) {
+        changeDir(previous);
+        removeDir(dir);
+      }
+      dir.clear();
+    }
+  }
+
+  ~ScopedDataDir() {
+    if (dir.empty() || !changeDir(previous))
+      return;
+    removeFilesIn(dir + "/data");
+    removeDir(dir + "/data");
+    removeFilesIn(dir);
+    removeDir(dir);
+  }
+
+  ScopedDataDir(const ScopedDataDir &) = delete;
+  ScopedDataDir &operator=(const ScopedDataDir &) = delete;
+
+  bool ok() const { return !dir.empty(); }
+};
+
+#endif // SCOPED_DATA_DIR_H
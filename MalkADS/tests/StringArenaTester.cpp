@@ -0,0 +1,66 @@
+#include "structures/hash_map.h"
+#include "structures/string_arena.h"
+#include <catch2/catch_all.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <string>
+#include <vector>
+
+TEST_CASE("StringRef compares like the string it views") {
+  const std::string owner = "Dune";
+  StringRef ref(owner);
+  REQUIRE(ref.size() == 4);
+  REQUIRE(ref == "Dune");
+  REQUIRE(ref != "dune");
+  REQUIRE(ref.equalsIgnoreCase("dUNE"));
+  REQUIRE_FALSE(ref.equalsIgnoreCase("Dunes"));
+  REQUIRE(StringRef("abc") < StringRef("abd"));
+  REQUIRE(StringRef("ab") < StringRef("abc"));
+  REQUIRE(StringRef().empty());
+  REQUIRE(ref.str() == owner);
+
+  CaseInsensitiveHash hash;
+  REQUIRE(hash("The Hobbit") == hash("tHE hOBBIT"));
+  const std::string longTitle(200, 'x');
+  REQUIRE(hash(longTitle) == hash(std::string(200, 'X')));
+}
+
+TEST_CASE("StringArena keeps stored strings in place") {
+  StringArena arena;
+  std::vector<StringRef> refs;
+  for (int i = 0; i < 20000; i++)
+    refs.push_back(arena.store("title-" + std::to_string(i)));
+  // A string too big for a normal block gets its own
+  const std::string big(100000, 'b');
+  StringRef bigRef = arena.store(big);
+
+  for (int i = 0; i < 20000; i++)
+    REQUIRE(refs[i] == "title-" + std::to_string(i));
+  REQUIRE(bigRef == big);
+  REQUIRE(arena.bytesStored() >= big.size());
+  REQUIRE(arena.bytesReserved() >= arena.bytesStored());
+}
+
+TEST_CASE("StringInterner stores each distinct string once") {
+  StringArena arena;
+  StringInterner interner(arena);
+  std::string author = "Ursula K. Le Guin";
+  StringRef first = interner.intern(author);
+  author[0] = 'X'; // the stored copy does not depend on the argument
+  StringRef again = interner.intern("Ursula K. Le Guin");
+  REQUIRE(first == "Ursula K. Le Guin");
+  REQUIRE(again.data() == first.data());
+  REQUIRE(interner.intern("ursula k. le guin").data() != first.data());
+  REQUIRE(interner.size() == 2);
+  REQUIRE(arena.bytesStored() == 2 * static_cast<size_t>(first.size()));
+}
+
+TEST_CASE("HashMap keyed by StringRef can be probed with strings") {
+  StringArena arena;
+  HashMap<StringRef, int, CaseInsensitiveHash, CaseInsensitiveEqual> titles;
+  titles.putNew(arena.store("War And Peace"), 1);
+  REQUIRE(titles.contains(std::string("war and peace")));
+  REQUIRE(*titles.get(std::string("WAR AND PEACE")) == 1);
+  REQUIRE_FALSE(titles.putNew(arena.store("war and peace"), 2));
+  REQUIRE(titles.erase(std::string("War and Peace")));
+  REQUIRE(titles.size() == 0);
+}
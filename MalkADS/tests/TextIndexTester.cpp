@@ -0,0 +1,96 @@
+#include "structures/text_index.h"
+#include <catch2/catch_all.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+namespace {
+
+std::vector<int> find(const TextIndex &index, const std::string &query,
+                      int limit = 0) {
+  std::vector<int> hits;
+  index.search(query, limit, [&](int id) { hits.push_back(id); });
+  return hits;
+}
+
+} // namespace
+
+TEST_CASE("TextIndex normalizes text") {
+  REQUIRE(TextIndex::normalize("  The C++ Programming--Language! ") ==
+          "the c programming language");
+  REQUIRE(TextIndex::normalize("...") == "");
+}
+
+TEST_CASE("TextIndex answers substring and word-prefix queries") {
+  TextIndex index;
+  index.add(0, "Introduction to Algorithms Cormen");
+  index.add(1, "Data Structures and Algorithms Goodrich");
+  index.add(2, "The Algorithm Design Manual Skiena");
+  index.add(5, "Database System Concepts Silberschatz");
+  REQUIRE(index.size() == 4);
+
+  REQUIRE(find(index, "algorithm") == std::vector<int>{0, 1, 2});
+  REQUIRE(find(index, "GORITHMS") == std::vector<int>{0, 1});
+  REQUIRE(find(index, "silber") == std::vector<int>{5});
+  // Every term has to match
+  REQUIRE(find(index, "algo struct") == std::vector<int>{1});
+  // Short terms match word starts only
+  REQUIRE(find(index, "da") == std::vector<int>{1, 5});
+  REQUIRE(find(index, "ta").empty());
+  // All trigrams present but not adjacent
+  REQUIRE(find(index, "ongo").empty());
+  REQUIRE(find(index, "zzz").empty());
+  REQUIRE(find(index, "").empty());
+
+  REQUIRE(find(index, "algorithm", 2) == std::vector<int>{0, 1});
+}
+
+TEST_CASE("TextIndex forgets removed and replaced documents") {
+  TextIndex index;
+  index.add(3, "Operating System Concepts");
+  index.add(7, "Database System Concepts");
+  REQUIRE(find(index, "system") == std::vector<int>{3, 7});
+
+  index.remove(3);
+  REQUIRE(find(index, "system") == std::vector<int>{7});
+  REQUIRE(find(index, "operating").empty());
+
+  index.add(7, "Compilers");
+  REQUIRE(find(index, "system").empty());
+  REQUIRE(find(index, "comp") == std::vector<int>{7});
+  REQUIRE(index.size() == 1);
+
+  index.remove(7);
+  REQUIRE(index.size() == 0);
+  REQUIRE(index.keyCount() == 0);
+}
+
+TEST_CASE("TextIndex counts term occurrences by the search rules") {
+  int starts = -1;
+  REQUIRE(TextIndex::countOccurrences("java in javascript and java", "java",
+                                      &starts) == 3);
+  REQUIRE(starts == 3);
+  REQUIRE(TextIndex::countOccurrences("learning java", "ava", &starts) == 1);
+  REQUIRE(starts == 0);
+  // Short terms only match at the start of a word
+  REQUIRE(TextIndex::countOccurrences("c and cpp", "c", &starts) == 2);
+  REQUIRE(TextIndex::countOccurrences("abc", "c") == 0);
+  REQUIRE(TextIndex::countOccurrences("abc", "") == 0);
+}
+
+TEST_CASE("TextIndex search lets a throwing callback unwind") {
+  TextIndex index;
+  index.add(1, "Clean Code");
+  index.add(2, "Clean Architecture");
+
+  int seen = 0;
+  REQUIRE_THROWS_AS(index.search("clean", 0,
+                                 [&](int) {
+                                   if (++seen == 2)
+                                     throw std::runtime_error("full");
+                                 }),
+                    std::runtime_error);
+  REQUIRE(seen == 2);
+  REQUIRE(find(index, "clean") == std::vector<int>{1, 2});
+}
@@ -0,0 +1,140 @@
+#include "structures/timing_wheel.h"
+#include <catch2/catch_all.hpp>
+#include <catch2/catch_test_macros.hpp>
+#include <algorithm>
+#include <cstdlib>
+#include <string>
+#include <utility>
+#include <vector>
+
+TEST_CASE("TimingWheel fires timers when the clock reaches them") {
+  TimingWheel<int> wheel;
+  wheel.schedule(5, 1);
+  wheel.schedule(70, 2);      // level 1
+  wheel.schedule(5000, 3);    // level 2
+  wheel.schedule(300000, 4);  // level 3
+  REQUIRE(wheel.size() == 4);
+
+  std::vector<std::pair<long long, int>> fired;
+  auto record = [&](long long expiry, int &v) {
+    fired.push_back(std::make_pair(expiry, v));
+  };
+
+  REQUIRE(wheel.advance(4, record) == 0);
+  REQUIRE(wheel.advance(5, record) == 1);
+  REQUIRE(fired.back() == std::make_pair(5LL, 1));
+  REQUIRE(wheel.advance(4999, record) == 1);
+  REQUIRE(fired.back() == std::make_pair(70LL, 2));
+  REQUIRE(wheel.advance(1000000, record) == 2);
+  REQUIRE(fired[2] == std::make_pair(5000LL, 3));
+  REQUIRE(fired[3] == std::make_pair(300000LL, 4));
+  REQUIRE(wheel.isEmpty());
+  REQUIRE(wheel.now() == 1000000);
+}
+
+TEST_CASE("TimingWheel cancels timers and rejects stale ids") {
+  TimingWheel<std::string> wheel(100);
+  TimingWheel<std::string>::TimerId a = wheel.schedule(150, "a");
+  TimingWheel<std::string>::TimerId b = wheel.schedule(150, "b");
+  TimingWheel<std::string>::TimerId far = wheel.schedule(100 + (1LL << 30), "far");
+
+  REQUIRE(wheel.cancel(a));
+  REQUIRE_FALSE(wheel.cancel(a));
+  REQUIRE_FALSE(wheel.isPending(a));
+  REQUIRE(wheel.cancel(far));
+  REQUIRE_FALSE(wheel.cancel(TimingWheel<std::string>::INVALID_TIMER));
+
+  // A recycled node does not answer to the old id
+  TimingWheel<std::string>::TimerId c = wheel.schedule(160, "c");
+  REQUIRE(c != a);
+  REQUIRE_FALSE(wheel.isPending(a));
+
+  std::vector<std::string> fired;
+  wheel.advance(1LL << 31, [&](long long, std::string &v) { fired.push_back(v); });
+  REQUIRE(fired == std::vector<std::string>{"b", "c"});
+  REQUIRE_FALSE(wheel.isPending(b));
+}
+
+TEST_CASE("TimingWheel fires past expiries on the next tick") {
+  TimingWheel<int> wheel(1000);
+  wheel.schedule(10, 7);
+  int fired = 0;
+  REQUIRE(wheel.advance(1000, [&](long long, int &) { fired++; }) == 0);
+  REQUIRE(wheel.advance(1001, [&](long long expiry, int &v) {
+    REQUIRE(expiry == 10);
+    REQUIRE(v == 7);
+    fired++;
+  }) == 1);
+  REQUIRE(fired == 1);
+}
+
+TEST_CASE("TimingWheel callbacks can schedule and cancel timers") {
+  TimingWheel<int> wheel;
+  wheel.schedule(10, 0);
+  TimingWheel<int>::TimerId victim = wheel.schedule(10, -1);
+  std::vector<long long> fired;
+  wheel.advance(100, [&](long long expiry, int &v) {
+    fired.push_back(expiry);
+    if (v >= 0) {
+      wheel.cancel(victim); // may still be waiting in the same slot
+      if (v < 3)
+        wheel.schedule(expiry + 20, v + 1);
+    }
+  });
+  REQUIRE(fired == std::vector<long long>{10, 30, 50, 70});
+}
+
+TEST_CASE("TimingWheel matches a brute-force model") {
+  TimingWheel<int> wheel;
+  struct Timer {
+    long long due;
+    TimingWheel<int>::TimerId id;
+    bool live;
+  };
+  std::vector<Timer> timers;
+  srand(99);
+  long long now = 0;
+
+  for (int round = 0; round < 400; round++) {
+    int adds = rand() % 40;
+    for (int i = 0; i < adds; i++) {
+      // Mix near, mid and far-future (overflow) timers
+      long long reach = (rand() % 3 == 0) ? (1LL << 26) : 5000;
+      long long due = now + 1 + (static_cast<long long>(rand()) * 7919) % reach;
+      Timer t;
+      t.due = due;
+      t.id = wheel.schedule(due, static_cast<int>(timers.size()));
+      t.live = true;
+      timers.push_back(t);
+    }
+    for (int i = 0; i < 5 && !timers.empty(); i++) {
+      Timer &t = timers[rand() % timers.size()];
+      REQUIRE(wheel.cancel(t.id) == t.live);
+      t.live = false;
+    }
+
+    long long next = now + (round % 50 == 49 ? (1LL << 25) : rand() % 3000);
+    std::vector<int> expected;
+    for (size_t i = 0; i < timers.size(); i++)
+      if (timers[i].live && timers[i].due <= next)
+        expected.push_back(static_cast<int>(i));
+
+    std::vector<int> got;
+    wheel.advance(next, [&](long long expiry, int &v) {
+      REQUIRE(expiry == timers[v].due);
+      REQUIRE(expiry <= next);
+      REQUIRE(expiry > now);
+      got.push_back(v);
+      timers[v].live = false;
+    });
+    std::sort(got.begin(), got.end());
+    REQUIRE(got == expected);
+    now = next;
+  }
+
+  int live = 0;
+  for (size_t i = 0; i < timers.size(); i++)
+    if (timers[i].live)
+      live++;
+  REQUIRE(wheel.size() == live);
+}